@@ -5564,6 +5564,10 @@ static void e1000_tx_queue(struct e1000_ring *tx_ring, int tx_flags, int count)
 
 	tx_ring->next_to_use = i;
 
+	/* the tail is written in ec_flush() after the last frame */
+	if (adapter->ecdev && ecdev_xmit_more(adapter->ecdev))
+		return;
+
 	if (adapter->flags2 & FLAG2_PCIM2PCI_ARBITER_WA)
 		e1000e_update_tdt_wa(tx_ring, i);
 	else
@@ -6840,6 +6844,25 @@ void ec_poll(struct net_device *netdev)
 #endif
 }
 
+/**
+ * ec_flush - Ethercat transmit flush Routine
+ * @netdev: net device structure
+ *
+ * Posts all frames queued during a transmit burst to the hardware.
+ **/
+void ec_flush(struct net_device *netdev)
+{
+	struct e1000_adapter *adapter = netdev_priv(netdev);
+	struct e1000_ring *tx_ring = adapter->tx_ring;
+
+	if (adapter->flags2 & FLAG2_PCIM2PCI_ARBITER_WA)
+		e1000e_update_tdt_wa(tx_ring, tx_ring->next_to_use);
+	else
+		writel(tx_ring->next_to_use, tx_ring->tail);
+
+	mmiowb();
+}
+
 /**
  * e1000_probe - Device Initialization Routine
  * @pdev: PCI device information struct
@@ -7137,6 +7160,7 @@ static int e1000_probe(struct pci_dev *pdev, const struct pci_device_id *ent)
 
 	adapter->ecdev = ecdev_offer(netdev, ec_poll, THIS_MODULE);
 	if (adapter->ecdev) {
+		ecdev_set_flush(adapter->ecdev, ec_flush);
 		err = ecdev_open(adapter->ecdev);
 		if (err) {
 			ecdev_withdraw(adapter->ecdev);
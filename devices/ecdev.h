@@ -56,6 +56,10 @@ typedef struct ec_device ec_device_t; /**< \see ec_device */
  */
 typedef void (*ec_pollfunc_t)(struct net_device *);
 
+/** Device transmit flush function type.
+ */
+typedef void (*ec_flushfunc_t)(struct net_device *);
+
 /******************************************************************************
  * Offering/withdrawal functions
  *****************************************************************************/
@@ -73,6 +77,8 @@ void ecdev_close(ec_device_t *device);
 void ecdev_receive(ec_device_t *device, const void *data, size_t size);
 void ecdev_set_link(ec_device_t *device, uint8_t state);
 uint8_t ecdev_get_link(const ec_device_t *device);
+void ecdev_set_flush(ec_device_t *device, ec_flushfunc_t flush);
+int ecdev_xmit_more(const ec_device_t *device);
 
 /*****************************************************************************/
 
@@ -38,7 +38,9 @@
 #include <linux/err.h>
 #include <linux/version.h>
 #include <linux/if_arp.h> /* ARPHRD_ETHER */
+#include <linux/if_packet.h>
 #include <linux/etherdevice.h>
+#include <linux/skbuff.h>
 
 #include "../globals.h"
 #include "ecdev.h"
@@ -73,7 +75,7 @@ typedef struct {
     struct net_device *used_netdev;
     struct socket *socket;
     ec_device_t *ecdev;
-    uint8_t *rx_buf;
+    uint8_t *rx_buf; /**< Buffer for non-linear frames. */
 } ec_gen_device_t;
 
 typedef struct {
@@ -230,6 +232,21 @@ int ec_gen_device_create_socket(
         return ret;
     }
 
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(3, 14, 0)
+    {
+        /* Hand the frames directly to the driver instead of passing the
+         * queueing discipline. */
+        int one = 1;
+
+        ret = kernel_setsockopt(dev->socket, SOL_PACKET,
+                PACKET_QDISC_BYPASS, (char *) &one, sizeof(one));
+        if (ret) {
+            printk(KERN_WARNING PFX "Failed to bypass the queueing"
+                    " discipline (ret = %i).\n", ret);
+        }
+    }
+#endif
+
     return 0;
 }
 
@@ -312,31 +329,34 @@ int ec_gen_device_start_xmit(
 /*****************************************************************************/
 
 /** Polls the device.
+ *
+ * Drains the socket's receive queue and passes the frames to the master.
+ * Linear frames are passed directly from the socket buffers without copying
+ * them.
  */
 void ec_gen_device_poll(
         ec_gen_device_t *dev
         )
 {
-    struct msghdr msg;
-    struct kvec iov;
-    int ret, budget = 10; // FIXME
+    struct sock *sk = dev->socket->sk;
+    struct sk_buff *skb;
+    size_t len;
+    int err;
 
     ecdev_set_link(dev->ecdev, netif_carrier_ok(dev->used_netdev));
 
-    do {
-        iov.iov_base = dev->rx_buf;
-        iov.iov_len = EC_GEN_RX_BUF_SIZE;
-        memset(&msg, 0, sizeof(msg));
-
-        ret = kernel_recvmsg(dev->socket, &msg, &iov, 1, iov.iov_len,
-                MSG_DONTWAIT);
-        if (ret > 0) {
-            ecdev_receive(dev->ecdev, dev->rx_buf, ret);
-        } else if (ret < 0) {
-            break;
+    while ((skb = skb_recv_datagram(sk, 0, 1, &err))) {
+        // the frame data start with the Ethernet header (SOCK_RAW)
+        if (likely(!skb_is_nonlinear(skb))) {
+            ecdev_receive(dev->ecdev, skb->data, skb->len);
+        } else {
+            len = min_t(size_t, skb->len, EC_GEN_RX_BUF_SIZE);
+            if (!skb_copy_bits(skb, 0, dev->rx_buf, len)) {
+                ecdev_receive(dev->ecdev, dev->rx_buf, len);
+            }
         }
-        budget--;
-    } while (budget);
+        skb_free_datagram(sk, skb);
+    }
 }
 
 /*****************************************************************************/
@@ -6081,7 +6081,9 @@ static netdev_tx_t rtl8169_start_xmit(struct sk_buff *skb,
 
 	wmb();
 
-	RTL_W8(TxPoll, NPQ);
+	/* the poll request is issued in ec_flush() after the last frame */
+	if (!tp->ecdev || !ecdev_xmit_more(tp->ecdev))
+		RTL_W8(TxPoll, NPQ);
 
 	mmiowb();
 
@@ -6488,6 +6490,15 @@ static void ec_poll(struct net_device *dev)
 	}
 }
 
+static void ec_flush(struct net_device *dev)
+{
+	struct rtl8169_private *tp = netdev_priv(dev);
+	void __iomem *ioaddr = tp->mmio_addr;
+
+	RTL_W8(TxPoll, NPQ);
+	mmiowb();
+}
+
 static int rtl8169_poll(struct napi_struct *napi, int budget)
 {
 	struct rtl8169_private *tp = container_of(napi, struct rtl8169_private, napi);
@@ -7297,6 +7308,8 @@ rtl_init_one(struct pci_dev *pdev, const struct pci_device_id *ent)
 	// offer device to EtherCAT master module
 	tp->ecdev = ecdev_offer(dev, ec_poll, THIS_MODULE);
 	tp->ec_watchdog_jiffies = jiffies;
+	if (tp->ecdev)
+		ecdev_set_flush(tp->ecdev, ec_flush);
 
 	if (!tp->ecdev) {
 		rc = register_netdev(dev);
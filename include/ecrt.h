@@ -39,6 +39,35 @@
  * request a master, to map process data, to communicate with slaves via CoE
  * and to configure and activate the bus.
  *
+ * Changes since version 1.5.2:
+ *
+ * - Added ecrt_master_freeze_layout() to send the domain datagrams in
+ *   prebuilt frames and the feature flag EC_HAVE_FREEZE_LAYOUT.
+ * - Added ecrt_domain_memory_mode() and ec_domain_memory_t to reference the
+ *   process data from the prebuilt frames via scatter-gather I/O, and the
+ *   feature flag EC_HAVE_DOMAIN_MEMORY_MODE.
+ * - Added ecrt_master_cycle() and ec_cycle_t to execute several steps of a
+ *   realtime cycle at once, and the feature flag EC_HAVE_CYCLE.
+ * - In userspace, ecrt_master_state(), ecrt_master_link_state(),
+ *   ecrt_domain_state() and ecrt_slave_config_state() read the states from a
+ *   status area behind the mapped process data after activation, without a
+ *   system call.
+ * - Added ecrt_domain_layout() and ec_domain_layout_t to place the process
+ *   data of a domain naturally aligned and without gaps, and the feature
+ *   flag EC_HAVE_DOMAIN_LAYOUT.
+ * - Added ecrt_master_pack_frames() to fill the frames of a cycle first-fit,
+ *   and the feature flag EC_HAVE_PACK_FRAMES.
+ * - Added ecrt_domain_set_cycle_divisor(), ecrt_master_queue_domains() and
+ *   ecrt_master_process_domains() to exchange domains at different rates,
+ *   the cycle steps EC_CYCLE_QUEUE_DOMAINS and EC_CYCLE_PROCESS_DOMAINS and
+ *   the feature flag EC_HAVE_CYCLE_DIVISOR.
+ * - Added ecrt_domain_track_changes() and ecrt_domain_changes() to get a
+ *   bitmap of the changed input bytes, and the feature flag
+ *   EC_HAVE_DOMAIN_CHANGES.
+ * - Added ecrt_master_sdo_upload_complete() and
+ *   ecrt_sdo_request_read_complete() to upload a whole object via CoE
+ *   complete access, and the feature flag EC_HAVE_COMPLETE_UPLOAD.
+ *
  * Changes in version 1.5.2:
  *
  * - Added redundancy_active flag to ec_domain_state_t.
@@ -187,6 +216,40 @@
  */
 #define EC_HAVE_REG_BY_POS
 
+/** Defined if the method ecrt_master_freeze_layout() is available.
+ */
+#define EC_HAVE_FREEZE_LAYOUT
+
+/** Defined if the method ecrt_domain_memory_mode() is available.
+ */
+#define EC_HAVE_DOMAIN_MEMORY_MODE
+
+/** Defined if the method ecrt_master_cycle() is available.
+ */
+#define EC_HAVE_CYCLE
+
+/** Defined if the method ecrt_domain_layout() is available.
+ */
+#define EC_HAVE_DOMAIN_LAYOUT
+
+/** Defined if the method ecrt_master_pack_frames() is available.
+ */
+#define EC_HAVE_PACK_FRAMES
+
+/** Defined if the method ecrt_domain_set_cycle_divisor() is available.
+ */
+#define EC_HAVE_CYCLE_DIVISOR
+
+/** Defined if the methods ecrt_domain_track_changes() and
+ * ecrt_domain_changes() are available.
+ */
+#define EC_HAVE_DOMAIN_CHANGES
+
+/** Defined if the methods ecrt_master_sdo_upload_complete() and
+ * ecrt_sdo_request_read_complete() are available.
+ */
+#define EC_HAVE_COMPLETE_UPLOAD
+
 /*****************************************************************************/
 
 /** End of list marker.
@@ -412,6 +475,80 @@ typedef struct {
 
 /*****************************************************************************/
 
+/** Domain memory mode.
+ *
+ * Determines, how the process data get into the prebuilt frames of a frozen
+ * frame layout. This is used in ecrt_domain_memory_mode().
+ */
+typedef enum {
+    EC_DOMAIN_MEMORY_COPY = 0, /**< The process data are copied into the
+                                 frames on every send (default). */
+    EC_DOMAIN_MEMORY_SCATTER_GATHER /**< The frames reference the process
+                                      data memory. */
+} ec_domain_memory_t;
+
+/*****************************************************************************/
+
+/** Domain process data layout.
+ *
+ * Determines, where the process data of the slave configurations are placed
+ * in the domain. This is used in ecrt_domain_layout().
+ */
+typedef enum {
+    EC_DOMAIN_LAYOUT_DEFAULT = 0, /**< The process data are appended in the
+                                    order of registration (default). */
+    EC_DOMAIN_LAYOUT_OPTIMIZED /**< The process data are naturally aligned
+                                 and alignment gaps are filled. */
+} ec_domain_layout_t;
+
+/*****************************************************************************/
+
+/** Maximum number of domains handled by one call of ecrt_master_cycle() in
+ * userspace.
+ */
+#define EC_CYCLE_MAX_DOMAINS 32
+
+/** Steps of a cyclic exchange.
+ *
+ * This is used as a bit mask in ec_cycle_t. The selected steps are executed
+ * in the order of their definition.
+ */
+typedef enum {
+    EC_CYCLE_RECEIVE = 1 << 0, /**< ecrt_master_receive(). */
+    EC_CYCLE_DOMAIN_PROCESS = 1 << 1, /**< ecrt_domain_process() for each
+                                        domain. */
+    EC_CYCLE_PROCESS_DOMAINS = 1 << 8, /**<
+                                         ecrt_master_process_domains(). */
+    EC_CYCLE_DOMAIN_STATE = 1 << 2, /**< ecrt_domain_state() for each
+                                      domain. */
+    EC_CYCLE_APP_TIME = 1 << 3, /**< ecrt_master_application_time(). */
+    EC_CYCLE_SYNC_REF_CLOCK = 1 << 4, /**<
+                                        ecrt_master_sync_reference_clock(). */
+    EC_CYCLE_SYNC_SLAVE_CLOCKS = 1 << 5, /**<
+                                           ecrt_master_sync_slave_clocks(). */
+    EC_CYCLE_DOMAIN_QUEUE = 1 << 6, /**< ecrt_domain_queue() for each
+                                      domain. */
+    EC_CYCLE_QUEUE_DOMAINS = 1 << 9, /**< ecrt_master_queue_domains(). */
+    EC_CYCLE_SEND = 1 << 7 /**< ecrt_master_send(). */
+} ec_cycle_step_t;
+
+/** Cyclic exchange descriptor.
+ *
+ * This is used for ecrt_master_cycle().
+ */
+typedef struct {
+    unsigned int steps; /**< Bit mask of steps to execute (see
+                          ec_cycle_step_t). */
+    uint64_t app_time; /**< Application time for EC_CYCLE_APP_TIME. */
+    ec_domain_t **domains; /**< Domains to process, query and queue. */
+    unsigned int domain_count; /**< Number of \a domains. */
+    ec_domain_state_t *domain_states; /**< Memory for the domain states
+                                        (one per domain), or NULL. Filled for
+                                        EC_CYCLE_DOMAIN_STATE. */
+} ec_cycle_t;
+
+/*****************************************************************************/
+
 /** Direction type for PDO assignment functions.
  */
 typedef enum {
@@ -859,6 +996,30 @@ int ecrt_master_sdo_upload(
         uint32_t *abort_code /**< Abort code of the SDO upload. */
         );
 
+/** Executes an SDO upload request to read a whole object from a slave via
+ * complete access.
+ *
+ * The upload starts at subindex 0, so the target buffer receives the
+ * subindex 0 entry (padded to 16 bit), followed by all other entries of the
+ * object.
+ *
+ * This request is processed by the master state machine. This method blocks,
+ * until the request has been processed and may not be called in realtime
+ * context.
+ *
+ * \retval  0 Success.
+ * \retval <0 Error code.
+ */
+int ecrt_master_sdo_upload_complete(
+        ec_master_t *master, /**< EtherCAT master. */
+        uint16_t slave_position, /**< Slave position. */
+        uint16_t index, /**< Index of the SDO. */
+        uint8_t *target, /**< Target buffer for the upload. */
+        size_t target_size, /**< Size of the target buffer. */
+        size_t *result_size, /**< Uploaded data size. */
+        uint32_t *abort_code /**< Abort code of the SDO upload. */
+        );
+
 /** Executes an SoE write request.
  *
  * Starts writing an IDN and blocks until the request was processed, or an
@@ -949,6 +1110,61 @@ int ecrt_master_set_send_interval(
         size_t send_interval /**< Send interval in us */
         );
 
+/** Freezes the frame layout of the cyclic process data.
+ *
+ * If enabled, the master prebuilds the EtherCAT frames for the datagrams of
+ * all domains on ecrt_master_activate(). Each frame gets a dedicated socket
+ * buffer with the Ethernet header, the datagram headers and the working
+ * counters already serialized, so that ecrt_master_send() only has to patch
+ * the datagram indices and copy the process data. Datagrams of the master's
+ * state machines are appended to the last prebuilt frame, if there is space
+ * left.
+ *
+ * A prebuilt frame is only used, if all of its datagrams have been queued
+ * (see ecrt_domain_queue()). Otherwise its datagrams are sent in dynamically
+ * assembled frames, like without a frozen layout. Domains with different
+ * cycle divisors or phases (see ecrt_domain_set_cycle_divisor()) get
+ * separate frames, so that the frames of the domains queued by
+ * ecrt_master_queue_domains() are always complete.
+ *
+ * This method has to be called before ecrt_master_activate(). The setting is
+ * reset, when the master is released.
+ *
+ * \retval 0 Success.
+ * \retval <0 Error code.
+ */
+int ecrt_master_freeze_layout(
+        ec_master_t *master, /**< EtherCAT master. */
+        uint8_t freeze /**< Non-zero to freeze the layout. */
+        );
+
+/** Selects frame packing.
+ *
+ * By default, ecrt_master_send() fills the frames in the order of the
+ * datagram queue and starts a new frame as soon as the next datagram does
+ * not fit. If frame packing is enabled, the remaining queue is searched for
+ * datagrams, that still fit into the current frame (first-fit), so that
+ * large domain datagrams alternating with small ones need less frames.
+ *
+ * The datagrams of the application (domains and distributed clocks) are
+ * queued before the ones of the master's state machines, so their placement
+ * only depends on the application's queue order and stays the same in every
+ * cycle. Acyclic datagrams only fill the remaining gaps.
+ *
+ * The number of frames sent in the last cycle is shown by the 'master'
+ * command of the command-line tool.
+ *
+ * This method has to be called before ecrt_master_activate(). The setting is
+ * reset, when the master is released.
+ *
+ * \retval 0 Success.
+ * \retval <0 Error code.
+ */
+int ecrt_master_pack_frames(
+        ec_master_t *master, /**< EtherCAT master. */
+        uint8_t pack /**< Non-zero to enable frame packing. */
+        );
+
 /** Sends all datagrams in the queue.
  *
  * This method takes all datagrams, that have been queued for transmission,
@@ -986,12 +1202,66 @@ void ecrt_master_send_ext(
         ec_master_t *master /**< EtherCAT master. */
         );
 
+/** Queues the domains, that are due in the current cycle.
+ *
+ * Calls ecrt_domain_queue() for every domain, whose phase (see
+ * ecrt_domain_set_cycle_divisor()) matches the number of calls since
+ * ecrt_master_activate() modulo the domain's divisor. The cycles are counted
+ * per domain modulo its divisor, so that the phase is kept indefinitely.
+ * Domains without a divisor are queued in every cycle.
+ *
+ * This replaces the calls of ecrt_domain_queue() in a cycle. It has to be
+ * called once per cycle, before ecrt_master_send().
+ */
+void ecrt_master_queue_domains(
+        ec_master_t *master /**< EtherCAT master. */
+        );
+
+/** Processes the domains queued by ecrt_master_queue_domains().
+ *
+ * Calls ecrt_domain_process() for every domain, that was queued by the last
+ * call of ecrt_master_queue_domains() and not processed since. This
+ * replaces the calls of ecrt_domain_process() in a cycle and has to be
+ * called after ecrt_master_receive().
+ */
+void ecrt_master_process_domains(
+        ec_master_t *master /**< EtherCAT master. */
+        );
+
+/** Executes several steps of a realtime cycle at once.
+ *
+ * The steps selected in the \a steps mask of the descriptor are executed in
+ * the order of ec_cycle_step_t. The domain-related steps are executed for all
+ * domains given in the descriptor, in the given order.
+ *
+ * In userspace, this replaces the separate calls of ecrt_master_receive(),
+ * ecrt_domain_process(), ecrt_domain_state(), ecrt_master_application_time(),
+ * ecrt_master_sync_reference_clock(), ecrt_master_sync_slave_clocks(),
+ * ecrt_domain_queue() and ecrt_master_send() with a single system call. At
+ * most EC_CYCLE_MAX_DOMAINS domains can be given there.
+ *
+ * A typical cycle either uses two calls (receive and process the inputs at
+ * the beginning, queue and send the outputs at the end), or a single call
+ * with all steps, if the outputs of the last cycle are sent.
+ *
+ * \retval 0 Success.
+ * \retval <0 Error code.
+ */
+int ecrt_master_cycle(
+        ec_master_t *master, /**< EtherCAT master. */
+        const ec_cycle_t *cycle /**< Cycle descriptor. */
+        );
+
 /** Reads the current master state.
  *
  * Stores the master state information in the given \a state structure.
  *
  * This method returns a global state. For the link-specific states in a
  * redundant bus topology, use the ecrt_master_link_state() method.
+ *
+ * In userspace, the state of an activated master is read from the memory
+ * mapped on ecrt_master_activate() without a system call. It is updated on
+ * every ecrt_master_receive().
  */
 void ecrt_master_state(
         const ec_master_t *master, /**< EtherCAT master. */
@@ -1595,6 +1865,9 @@ ec_reg_request_t *ecrt_slave_config_create_reg_request(
  *
  * \attention If the state of process data exchange shall be monitored in
  * realtime, ecrt_domain_state() should be used.
+ *
+ * In userspace, the state is read without a system call after activation,
+ * like with ecrt_master_state().
  */
 void ecrt_slave_config_state(
         const ec_slave_config_t *sc, /**< Slave configuration */
@@ -1684,6 +1957,122 @@ void ecrt_domain_external_memory(
 
 #endif /* __KERNEL__ */
 
+/** Selects the memory mode of the domain.
+ *
+ * With a frozen frame layout (see ecrt_master_freeze_layout()), the copying
+ * of the process data into the frames can be avoided:
+ * EC_DOMAIN_MEMORY_SCATTER_GATHER makes the frames reference the process
+ * data memory with page fragments. This requires a network device that
+ * supports scatter-gather I/O.
+ *
+ * If the mode can not be applied, the process data are copied like in the
+ * default mode and a warning is issued on activation. In any case, the
+ * received process data are copied once from the receive buffer.
+ *
+ * Referenced process data are read by the network device after
+ * ecrt_master_send(), so the application shall not modify them before the
+ * frames were received.
+ *
+ * This method has to be called in non-realtime context before
+ * ecrt_master_activate().
+ *
+ * \retval 0 Success.
+ * \retval <0 Error code.
+ */
+int ecrt_domain_memory_mode(
+        ec_domain_t *domain, /**< Domain. */
+        ec_domain_memory_t mode /**< Memory mode. */
+        );
+
+/** Selects the process data layout of the domain.
+ *
+ * By default, the process data of a sync manager are appended to the domain
+ * when the first PDO entry of it is registered. With
+ * EC_DOMAIN_LAYOUT_OPTIMIZED, the process data of a sync manager are placed
+ * at an offset that is a multiple of the size of its largest naturally
+ * aligned multi-byte PDO entry (up to 8 byte), so that these entries can be
+ * accessed aligned. Smaller process data are placed into the gaps that the
+ * alignment leaves behind, before the domain grows, so that the bytes on the
+ * wire and the number of datagrams stay minimal. Slave configurations with
+ * overlapping PDOs (see ecrt_slave_config_overlapping_pdos()) are placed
+ * like in the default layout.
+ *
+ * The alignment refers to the start of the domain's process data. The
+ * offsets returned by the PDO entry registration stay valid. On activation,
+ * the resulting datagrams with their expected working counters and the
+ * bytes on the wire are logged.
+ *
+ * This method has to be called in non-realtime context before the first PDO
+ * entry is registered in the domain.
+ *
+ * \retval 0 Success.
+ * \retval <0 Error code.
+ */
+int ecrt_domain_layout(
+        ec_domain_t *domain, /**< Domain. */
+        ec_domain_layout_t layout /**< Process data layout. */
+        );
+
+/** Sets the rate divisor and the phase of the domain.
+ *
+ * The domain is exchanged by ecrt_master_queue_domains() and
+ * ecrt_master_process_domains() only in every \a divisor-th cycle, starting
+ * with cycle \a phase. For example, a domain with divisor 16 is exchanged at
+ * 250 Hz in a 4 kHz cycle. Giving slow domains with the same divisor
+ * different phases spreads their traffic evenly across the cycles, so that
+ * the bus time of every cycle stays bounded.
+ *
+ * The default divisor is 1 (the domain is exchanged in every cycle). The
+ * divisor does not affect ecrt_domain_queue() and ecrt_domain_process().
+ *
+ * This method has to be called in non-realtime context before
+ * ecrt_master_activate().
+ *
+ * \retval 0 Success.
+ * \retval <0 Error code.
+ */
+int ecrt_domain_set_cycle_divisor(
+        ec_domain_t *domain, /**< Domain. */
+        unsigned int divisor, /**< Rate divisor (1 = every cycle). */
+        unsigned int phase /**< Phase (less than \a divisor). */
+        );
+
+/** Enables the detection of changed inputs.
+ *
+ * If enabled, ecrt_domain_process() compares the inputs of the domain with
+ * the ones of the previous call and marks the changed bytes in a bitmap,
+ * that can be accessed via ecrt_domain_changes(). The comparison is done
+ * machine word by machine word, so that event-driven applications can skip
+ * unchanged inputs without scanning the process data themselves.
+ *
+ * This method has to be called in non-realtime context before
+ * ecrt_master_activate().
+ *
+ * \retval 0 Success.
+ * \retval <0 Error code.
+ */
+int ecrt_domain_track_changes(
+        ec_domain_t *domain, /**< Domain. */
+        uint8_t enable /**< Non-zero to enable change detection. */
+        );
+
+/** Returns the bitmap of changed inputs.
+ *
+ * The bitmap has one bit per process data byte; bit (offset % 8) of byte
+ * (offset / 8) is set, if the input byte at \a offset changed in the last
+ * ecrt_domain_process(). Bits of output bytes are always zero. The bitmap
+ * has (ecrt_domain_size() + 7) / 8 bytes.
+ *
+ * In userspace, the bitmap is located in the memory mapped on
+ * ecrt_master_activate(), so it can be read without a system call.
+ *
+ * \return Pointer to the bitmap, or NULL, if change detection is not
+ *         enabled or the master is not activated.
+ */
+const uint8_t *ecrt_domain_changes(
+        const ec_domain_t *domain /**< Domain. */
+        );
+
 /** Returns the domain's process data.
  *
  * - In kernel context: If external memory was provided with
@@ -1726,6 +2115,10 @@ void ecrt_domain_queue(
  * Stores the domain state in the given \a state structure.
  *
  * Using this method, the process data exchange can be monitored in realtime.
+ *
+ * In userspace, the state is read from the memory mapped on
+ * ecrt_master_activate() without a system call. It is updated on every
+ * ecrt_domain_process().
  */
 void ecrt_domain_state(
         const ec_domain_t *domain, /**< Domain. */
@@ -1838,6 +2231,27 @@ void ecrt_sdo_request_read(
         ec_sdo_request_t *req /**< SDO request. */
         );
 
+/** Schedule an SDO read operation via complete access.
+ *
+ * The whole object is read in one transfer, starting at subindex 0. The
+ * subindex set via ecrt_sdo_request_index() is ignored. Subsequent calls of
+ * ecrt_sdo_request_write() also use complete access, until
+ * ecrt_sdo_request_read() is called.
+ *
+ * In userspace, the request has to be created with a data size, that is
+ * large enough to hold the whole object.
+ *
+ * \attention This method may not be called while ecrt_sdo_request_state()
+ * returns EC_REQUEST_BUSY.
+ *
+ * \attention After calling this function, the return value of
+ * ecrt_sdo_request_data() must be considered as invalid while
+ * ecrt_sdo_request_state() returns EC_REQUEST_BUSY.
+ */
+void ecrt_sdo_request_read_complete(
+        ec_sdo_request_t *req /**< SDO request. */
+        );
+
 /*****************************************************************************
  * VoE handler methods.
  ****************************************************************************/
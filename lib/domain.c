@@ -91,6 +91,107 @@ size_t ecrt_domain_size(const ec_domain_t *domain)
 
 /*****************************************************************************/
 
+int ecrt_domain_memory_mode(ec_domain_t *domain, ec_domain_memory_t mode)
+{
+    ec_ioctl_domain_memory_t data;
+    int ret;
+
+    data.domain_index = domain->index;
+    data.mode = mode;
+
+    ret = ioctl(domain->master->fd, EC_IOCTL_DOMAIN_MEMORY, &data);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        fprintf(stderr, "Failed to set domain memory mode: %s\n",
+                strerror(EC_IOCTL_ERRNO(ret)));
+        return -EC_IOCTL_ERRNO(ret);
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+
+int ecrt_domain_layout(ec_domain_t *domain, ec_domain_layout_t layout)
+{
+    ec_ioctl_domain_layout_t data;
+    int ret;
+
+    data.domain_index = domain->index;
+    data.layout = layout;
+
+    ret = ioctl(domain->master->fd, EC_IOCTL_DOMAIN_LAYOUT, &data);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        fprintf(stderr, "Failed to set domain layout: %s\n",
+                strerror(EC_IOCTL_ERRNO(ret)));
+        return -EC_IOCTL_ERRNO(ret);
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+
+int ecrt_domain_set_cycle_divisor(ec_domain_t *domain, unsigned int divisor,
+        unsigned int phase)
+{
+    ec_ioctl_domain_cycle_t data;
+    int ret;
+
+    data.domain_index = domain->index;
+    data.divisor = divisor;
+    data.phase = phase;
+
+    ret = ioctl(domain->master->fd, EC_IOCTL_DOMAIN_CYCLE, &data);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        fprintf(stderr, "Failed to set domain cycle divisor: %s\n",
+                strerror(EC_IOCTL_ERRNO(ret)));
+        return -EC_IOCTL_ERRNO(ret);
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+
+int ecrt_domain_track_changes(ec_domain_t *domain, uint8_t enable)
+{
+    ec_ioctl_domain_changes_t data;
+    int ret;
+
+    data.domain_index = domain->index;
+    data.enable = enable;
+
+    ret = ioctl(domain->master->fd, EC_IOCTL_DOMAIN_CHANGES, &data);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        fprintf(stderr, "Failed to enable change tracking: %s\n",
+                strerror(EC_IOCTL_ERRNO(ret)));
+        return -EC_IOCTL_ERRNO(ret);
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+
+const uint8_t *ecrt_domain_changes(const ec_domain_t *domain)
+{
+    const ec_ioctl_status_t *status = domain->master->status;
+    const ec_ioctl_domain_status_t *entry;
+
+    if (!status || domain->index >= status->domain_count) {
+        return NULL;
+    }
+
+    entry = EC_IOCTL_STATUS_DOMAINS(status) + domain->index;
+    if (!entry->changes_offset) {
+        return NULL;
+    }
+
+    return domain->master->process_data + entry->changes_offset;
+}
+
+/*****************************************************************************/
+
 uint8_t *ecrt_domain_data(ec_domain_t *domain)
 {
     if (!domain->process_data) {
@@ -140,9 +241,19 @@ void ecrt_domain_queue(ec_domain_t *domain)
 
 void ecrt_domain_state(const ec_domain_t *domain, ec_domain_state_t *state)
 {
+    const ec_ioctl_status_t *status = domain->master->status;
     ec_ioctl_domain_state_t data;
     int ret;
 
+    if (status && domain->index < status->domain_count) {
+        const ec_ioctl_domain_status_t *entry =
+            EC_IOCTL_STATUS_DOMAINS(status) + domain->index;
+        if (ec_master_read_status(&entry->sequence, state, &entry->state,
+                    sizeof(ec_domain_state_t))) {
+            return;
+        }
+    }
+
     data.domain_index = domain->index;
     data.state = state;
 
@@ -63,6 +63,7 @@ void ec_master_clear_config(ec_master_t *master)
     if (master->process_data)  {
         munmap(master->process_data, master->process_data_size);
         master->process_data = NULL;
+        master->status = NULL;
     }
 
     d = master->first_domain;
@@ -457,6 +458,37 @@ int ecrt_master_sdo_upload(ec_master_t *master, uint16_t slave_position,
     upload.slave_position = slave_position;
     upload.sdo_index = index;
     upload.sdo_entry_subindex = subindex;
+    upload.complete_access = 0;
+    upload.target_size = target_size;
+    upload.target = target;
+
+    ret = ioctl(master->fd, EC_IOCTL_SLAVE_SDO_UPLOAD, &upload);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        if (EC_IOCTL_ERRNO(ret) == EIO && abort_code) {
+            *abort_code = upload.abort_code;
+        }
+        fprintf(stderr, "Failed to execute SDO upload: %s\n",
+                strerror(EC_IOCTL_ERRNO(ret)));
+        return -EC_IOCTL_ERRNO(ret);
+    }
+
+    *result_size = upload.data_size;
+    return 0;
+}
+
+/****************************************************************************/
+
+int ecrt_master_sdo_upload_complete(ec_master_t *master,
+        uint16_t slave_position, uint16_t index, uint8_t *target,
+        size_t target_size, size_t *result_size, uint32_t *abort_code)
+{
+    ec_ioctl_slave_sdo_upload_t upload;
+    int ret;
+
+    upload.slave_position = slave_position;
+    upload.sdo_index = index;
+    upload.sdo_entry_subindex = 0;
+    upload.complete_access = 1;
     upload.target_size = target_size;
     upload.target = target;
 
@@ -567,6 +599,9 @@ int ecrt_master_activate(ec_master_t *master)
 
         // Access the mapped region to cause the initial page fault
         master->process_data[0] = 0x00;
+
+        master->status = (const ec_ioctl_status_t *)
+            (master->process_data + io.status_offset);
     }
 
     return 0;
@@ -607,6 +642,98 @@ int ecrt_master_set_send_interval(ec_master_t *master,
 
 /****************************************************************************/
 
+int ecrt_master_cycle(ec_master_t *master, const ec_cycle_t *cycle)
+{
+    ec_ioctl_cycle_t data;
+    unsigned int i;
+    int ret;
+
+    if (cycle->domain_count > EC_CYCLE_MAX_DOMAINS) {
+        fprintf(stderr, "Too many domains for a cycle: %u > %u\n",
+                cycle->domain_count, EC_CYCLE_MAX_DOMAINS);
+        return -EINVAL;
+    }
+
+    data.steps = cycle->steps;
+    data.app_time = cycle->app_time;
+    data.domain_count = cycle->domain_count;
+    for (i = 0; i < cycle->domain_count; i++) {
+        data.domain_indices[i] = cycle->domains[i]->index;
+    }
+    data.domain_states = cycle->domain_states;
+
+    ret = ioctl(master->fd, EC_IOCTL_CYCLE, &data);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        fprintf(stderr, "Failed to execute cycle: %s\n",
+                strerror(EC_IOCTL_ERRNO(ret)));
+        return -EC_IOCTL_ERRNO(ret);
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
+void ecrt_master_queue_domains(ec_master_t *master)
+{
+    int ret;
+
+    ret = ioctl(master->fd, EC_IOCTL_QUEUE_DOMAINS, NULL);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        fprintf(stderr, "Failed to queue domains: %s\n",
+                strerror(EC_IOCTL_ERRNO(ret)));
+    }
+}
+
+/****************************************************************************/
+
+void ecrt_master_process_domains(ec_master_t *master)
+{
+    int ret;
+
+    ret = ioctl(master->fd, EC_IOCTL_PROCESS_DOMAINS, NULL);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        fprintf(stderr, "Failed to process domains: %s\n",
+                strerror(EC_IOCTL_ERRNO(ret)));
+    }
+}
+
+/****************************************************************************/
+
+int ecrt_master_freeze_layout(ec_master_t *master, uint8_t freeze)
+{
+    uint32_t data = freeze;
+    int ret;
+
+    ret = ioctl(master->fd, EC_IOCTL_FREEZE_LAYOUT, &data);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        fprintf(stderr, "Failed to freeze frame layout: %s\n",
+                strerror(EC_IOCTL_ERRNO(ret)));
+        return -EC_IOCTL_ERRNO(ret);
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
+int ecrt_master_pack_frames(ec_master_t *master, uint8_t pack)
+{
+    uint32_t data = pack;
+    int ret;
+
+    ret = ioctl(master->fd, EC_IOCTL_PACK_FRAMES, &data);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        fprintf(stderr, "Failed to select frame packing: %s\n",
+                strerror(EC_IOCTL_ERRNO(ret)));
+        return -EC_IOCTL_ERRNO(ret);
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
 size_t ecrt_master_send(ec_master_t *master)
 {
     int ret;
@@ -636,10 +763,62 @@ void ecrt_master_receive(ec_master_t *master)
 
 /****************************************************************************/
 
+/** Maximum number of attempts to read consistent data from the status area.
+ */
+#define EC_MASTER_STATUS_READ_ATTEMPTS 16
+
+/** Reads data from the status area, that are protected by a sequence
+ * counter.
+ *
+ * Retries, until the kernel did not update the data while reading. The
+ * number of attempts is limited: A realtime thread, that preempted the
+ * kernel in the middle of an update, would otherwise spin forever. In that
+ * case, the caller falls back to the ioctl.
+ *
+ * \return Non-zero, if the data were already published and could be read.
+ */
+int ec_master_read_status(const uint32_t *sequence, void *dst,
+        const void *src, size_t size)
+{
+    const volatile uint32_t *seq = sequence;
+    uint32_t start;
+    unsigned int attempt;
+
+    for (attempt = 0; attempt < EC_MASTER_STATUS_READ_ATTEMPTS; attempt++) {
+        start = *seq;
+
+        if (start & 1) {
+            continue; // update in progress
+        }
+
+        if (!start) {
+            return 0; // nothing published yet
+        }
+
+        __sync_synchronize();
+        memcpy(dst, src, size);
+        __sync_synchronize();
+
+        if (*seq == start) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
 void ecrt_master_state(const ec_master_t *master, ec_master_state_t *state)
 {
     int ret;
 
+    if (master->status && ec_master_read_status(&master->status->sequence,
+                state, &master->status->master_state,
+                sizeof(ec_master_state_t))) {
+        return;
+    }
+
     ret = ioctl(master->fd, EC_IOCTL_MASTER_STATE, state);
     if (EC_IOCTL_IS_ERROR(ret)) {
         fprintf(stderr, "Failed to get master state: %s\n",
@@ -655,6 +834,13 @@ int ecrt_master_link_state(const ec_master_t *master, unsigned int dev_idx,
     ec_ioctl_link_state_t io;
     int ret;
 
+    if (master->status && dev_idx < master->status->num_devices
+            && ec_master_read_status(&master->status->sequence, state,
+                &master->status->link_states[dev_idx],
+                sizeof(ec_master_link_state_t))) {
+        return 0;
+    }
+
     io.dev_idx = dev_idx;
     io.state = state;
 
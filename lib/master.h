@@ -29,6 +29,7 @@
  *****************************************************************************/
 
 #include "include/ecrt.h"
+#include "ioctl.h"
 
 /*****************************************************************************/
 
@@ -36,6 +37,7 @@ struct ec_master {
     int fd;
     uint8_t *process_data;
     size_t process_data_size;
+    const ec_ioctl_status_t *status;
 
     ec_domain_t *first_domain;
     ec_slave_config_t *first_config;
@@ -44,5 +46,6 @@ struct ec_master {
 /*****************************************************************************/
 
 void ec_master_clear(ec_master_t *);
+int ec_master_read_status(const uint32_t *, void *, const void *, size_t);
 
 /*****************************************************************************/
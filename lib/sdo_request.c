@@ -153,6 +153,7 @@ void ecrt_sdo_request_read(ec_sdo_request_t *req)
 
     data.config_index = req->config->index;
     data.request_index = req->index;
+    data.complete_access = 0;
 
     ret = ioctl(req->config->master->fd, EC_IOCTL_SDO_REQUEST_READ, &data);
     if (EC_IOCTL_IS_ERROR(ret)) {
@@ -163,6 +164,24 @@ void ecrt_sdo_request_read(ec_sdo_request_t *req)
 
 /*****************************************************************************/
 
+void ecrt_sdo_request_read_complete(ec_sdo_request_t *req)
+{
+    ec_ioctl_sdo_request_t data;
+    int ret;
+
+    data.config_index = req->config->index;
+    data.request_index = req->index;
+    data.complete_access = 1;
+
+    ret = ioctl(req->config->master->fd, EC_IOCTL_SDO_REQUEST_READ, &data);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        fprintf(stderr, "Failed to command an SDO complete access read : %s\n",
+                strerror(EC_IOCTL_ERRNO(ret)));
+    }
+}
+
+/*****************************************************************************/
+
 void ecrt_sdo_request_write(ec_sdo_request_t *req)
 {
     ec_ioctl_sdo_request_t data;
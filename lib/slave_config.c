@@ -753,9 +753,17 @@ ec_voe_handler_t *ecrt_slave_config_create_voe_handler(ec_slave_config_t *sc,
 void ecrt_slave_config_state(const ec_slave_config_t *sc,
         ec_slave_config_state_t *state)
 {
+    const ec_ioctl_status_t *status = sc->master->status;
     ec_ioctl_sc_state_t data;
     int ret;
 
+    if (status && sc->index < status->config_count
+            && ec_master_read_status(&status->sequence, state,
+                EC_IOCTL_STATUS_CONFIGS(status, status->domain_count)
+                + sc->index, sizeof(ec_slave_config_state_t))) {
+        return;
+    }
+
     data.config_index = sc->index;
     data.state = state;
 
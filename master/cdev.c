@@ -159,6 +159,7 @@ int eccdev_open(struct inode *inode, struct file *filp)
     priv->ctx.requested = 0;
     priv->ctx.process_data = NULL;
     priv->ctx.process_data_size = 0;
+    priv->ctx.foe_read = NULL;
 
     filp->private_data = priv;
 
@@ -177,6 +178,8 @@ int eccdev_release(struct inode *inode, struct file *filp)
     ec_cdev_priv_t *priv = (ec_cdev_priv_t *) filp->private_data;
     ec_master_t *master = priv->cdev->master;
 
+    ec_ioctl_clear_foe_read(master, &priv->ctx);
+
     if (priv->ctx.requested) {
         ecrt_release_master(master);
     }
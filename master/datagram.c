@@ -49,7 +49,8 @@
         return ret; \
     datagram->index = 0; \
     datagram->working_counter = 0; \
-    datagram->state = EC_DATAGRAM_INIT;
+    datagram->state = EC_DATAGRAM_INIT; \
+    datagram->mbox_status_index = -1;
 
 #define EC_FUNC_FOOTER \
     datagram->data_size = data_size; \
@@ -88,6 +89,7 @@ static const char *type_strings[] = {
 void ec_datagram_init(ec_datagram_t *datagram /**< EtherCAT datagram. */)
 {
     INIT_LIST_HEAD(&datagram->queue); // mark as unqueued
+    INIT_LIST_HEAD(&datagram->sent);
     datagram->device_index = EC_DEVICE_MAIN;
     datagram->type = EC_DATAGRAM_NONE;
     memset(datagram->address, 0x00, EC_ADDR_LEN);
@@ -106,7 +108,9 @@ void ec_datagram_init(ec_datagram_t *datagram /**< EtherCAT datagram. */)
     datagram->cycles_received = 0;
 #endif
     datagram->jiffies_received = 0;
+    datagram->latency = NULL;
     datagram->skip_count = 0;
+    datagram->mbox_status_index = -1;
     datagram->stats_output_jiffies = 0;
     memset(datagram->name, 0x00, EC_DATAGRAM_NAME_SIZE);
 }
@@ -134,6 +138,10 @@ void ec_datagram_unqueue(ec_datagram_t *datagram /**< EtherCAT datagram. */)
     if (!list_empty(&datagram->queue)) {
         list_del_init(&datagram->queue);
     }
+
+    if (!list_empty(&datagram->sent)) {
+        list_del_init(&datagram->sent);
+    }
 }
 
 /*****************************************************************************/
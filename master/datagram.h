@@ -85,8 +85,10 @@ typedef enum {
 /** EtherCAT datagram.
  */
 typedef struct {
-    struct list_head queue; /**< Master datagram queue item. */
-    struct list_head sent; /**< Master list item for sent datagrams. */
+    struct list_head queue; /**< Master datagram queue item. Empty, if the
+                              datagram is not queued. */
+    struct list_head sent; /**< Master list item for sent datagrams (in
+                             sending order, while the datagram is sent). */
     ec_device_index_t device_index; /**< Device via which the datagram shall
                                       be / was sent. */
     ec_datagram_type_t type; /**< Datagram type (APRD, BWR, etc.). */
@@ -107,7 +109,12 @@ typedef struct {
 #endif
     unsigned long jiffies_received; /**< Jiffies, when the datagram was
                                       received. */
+    ec_latency_t *latency; /**< Additional round-trip time statistics to
+                             update on reception, or NULL. */
     unsigned int skip_count; /**< Number of requeues when not yet received. */
+    int mbox_status_index; /**< Offset of the slave's mailbox state in the
+                             mailbox status area, if this mailbox check
+                             datagram shall be answered from there, or -1. */
     unsigned long stats_output_jiffies; /**< Last statistics output. */
     char name[EC_DATAGRAM_NAME_SIZE]; /**< Description of the datagram. */
 } ec_datagram_t;
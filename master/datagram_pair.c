@@ -35,6 +35,7 @@
 /*****************************************************************************/
 
 #include <linux/slab.h>
+#include <asm/unaligned.h>
 
 #include "master.h"
 #include "datagram_pair.h"
@@ -59,6 +60,10 @@ int ec_datagram_pair_init(
 
     INIT_LIST_HEAD(&pair->list);
     pair->domain = domain;
+#if EC_MAX_NUM_DEVICES > 1
+    pair->input_regions = NULL;
+    pair->input_region_count = 0;
+#endif
 
     for (dev_idx = EC_DEVICE_MAIN;
             dev_idx < ec_master_num_devices(domain->master); dev_idx++) {
@@ -67,6 +72,7 @@ int ec_datagram_pair_init(
                 EC_DATAGRAM_NAME_SIZE, "domain%u-%u-%s", domain->index,
                 logical_offset, ec_device_names[dev_idx != 0]);
         pair->datagrams[dev_idx].device_index = dev_idx;
+        pair->datagrams[dev_idx].latency = &domain->latency;
     }
 
     pair->expected_working_counter = 0U;
@@ -157,6 +163,8 @@ void ec_datagram_pair_clear(
     for (dev_idx = EC_DEVICE_MAIN;
             dev_idx < ec_master_num_devices(pair->domain->master);
             dev_idx++) {
+        ec_master_release_datagram(pair->domain->master,
+                &pair->datagrams[dev_idx]);
         ec_datagram_clear(&pair->datagrams[dev_idx]);
     }
 
@@ -164,6 +172,9 @@ void ec_datagram_pair_clear(
     if (pair->send_buffer) {
         kfree(pair->send_buffer);
     }
+    if (pair->input_regions) {
+        kfree(pair->input_regions);
+    }
 #endif
 }
 
@@ -199,3 +210,103 @@ uint16_t ec_datagram_pair_process(
 }
 
 /*****************************************************************************/
+
+#if EC_MAX_NUM_DEVICES > 1
+
+/** Input region comparison results.
+ */
+enum {
+    EC_REGION_MAIN_CHANGED = 0x01, /**< Data changed on the main link. */
+    EC_REGION_BACKUP_CHANGED = 0x02 /**< Data changed on the backup link. */
+};
+
+/** Compares the received main and backup data of an input region with the
+ * sent data.
+ *
+ * Both links are compared in a single pass with machine word accesses. As
+ * changed main data take precedence, the comparison stops as soon as a
+ * difference on the main link is detected.
+ *
+ * \return Combination of EC_REGION_MAIN_CHANGED and
+ *         EC_REGION_BACKUP_CHANGED.
+ */
+static unsigned int ec_input_region_compare(
+        const uint8_t *sent, /**< Sent data. */
+        const uint8_t *main, /**< Data received on the main link. */
+        const uint8_t *backup, /**< Data received on the backup link. */
+        size_t size /**< Region size. */
+        )
+{
+    unsigned long word, backup_diff = 0;
+
+    while (size >= sizeof(unsigned long)) {
+        word = get_unaligned((const unsigned long *) sent);
+        if (get_unaligned((const unsigned long *) main) != word) {
+            return EC_REGION_MAIN_CHANGED;
+        }
+        backup_diff |= get_unaligned((const unsigned long *) backup) ^ word;
+        sent += sizeof(unsigned long);
+        main += sizeof(unsigned long);
+        backup += sizeof(unsigned long);
+        size -= sizeof(unsigned long);
+    }
+
+    while (size--) {
+        if (*main++ != *sent) {
+            return EC_REGION_MAIN_CHANGED;
+        }
+        backup_diff |= *backup++ ^ *sent++;
+    }
+
+    return backup_diff ? EC_REGION_BACKUP_CHANGED : 0;
+}
+
+/*****************************************************************************/
+
+/** Merges the input data received on the main and backup links.
+ *
+ * For every input region, the data that changed on the main link are kept.
+ * Otherwise, data that changed on the backup link are copied to the main
+ * datagram. If neither changed and the working counter is incomplete, the
+ * working counter is reported as zero to avoid data-dependent flickering.
+ *
+ * \return Working counter of the datagram pair.
+ */
+uint16_t ec_datagram_pair_merge_inputs(
+        ec_datagram_pair_t *pair, /**< Datagram pair. */
+        uint16_t pair_wc /**< Working counter sum of the datagram pair. */
+        )
+{
+    uint8_t *main_data = pair->datagrams[EC_DEVICE_MAIN].data;
+    const uint8_t *backup_data = pair->datagrams[EC_DEVICE_BACKUP].data;
+    const ec_input_region_t *region = pair->input_regions,
+          *end = pair->input_regions + pair->input_region_count;
+
+    for (; region < end; region++) {
+        switch (ec_input_region_compare(pair->send_buffer + region->offset,
+                    main_data + region->offset,
+                    backup_data + region->offset, region->size)) {
+            case EC_REGION_MAIN_CHANGED:
+                /* data changed on main link: no copying necessary. */
+                break;
+            case EC_REGION_BACKUP_CHANGED:
+                /* data changed on backup link: copy to main memory. */
+                memcpy(main_data + region->offset,
+                        backup_data + region->offset, region->size);
+                break;
+            default:
+                if (pair_wc != pair->expected_working_counter) {
+                    /* no change and WC incomplete: mark WC as zero to
+                     * avoid data-dependent WC flickering. */
+                    pair_wc = 0;
+                }
+                break;
+        }
+    }
+
+    return pair_wc;
+}
+
+#endif
+
+/*****************************************************************************/
@@ -44,6 +44,16 @@
 
 /*****************************************************************************/
 
+/** Input region.
+ *
+ * Byte range of input process data, for which the data received on the
+ * main and backup links have to be merged, or changes have to be detected.
+ */
+typedef struct {
+    size_t offset; /**< Offset in the datagram or domain data. */
+    size_t size; /**< Size of the region in byte. */
+} ec_input_region_t;
+
 /** Domain datagram pair.
  */
 typedef struct {
@@ -52,6 +62,9 @@ typedef struct {
     ec_datagram_t datagrams[EC_MAX_NUM_DEVICES]; /**< Datagrams.  */
 #if EC_MAX_NUM_DEVICES > 1
     uint8_t *send_buffer;
+    ec_input_region_t *input_regions; /**< Input regions, ordered by
+                                        offset. */
+    unsigned int input_region_count; /**< Number of input regions. */
 #endif
     unsigned int expected_working_counter; /**< Expectord working conter. */
 } ec_datagram_pair_t;
@@ -63,6 +76,9 @@ int ec_datagram_pair_init(ec_datagram_pair_t *, ec_domain_t *, uint32_t,
 void ec_datagram_pair_clear(ec_datagram_pair_t *);
 
 uint16_t ec_datagram_pair_process(ec_datagram_pair_t *, uint16_t[]);
+#if EC_MAX_NUM_DEVICES > 1
+uint16_t ec_datagram_pair_merge_inputs(ec_datagram_pair_t *, uint16_t);
+#endif
 
 /*****************************************************************************/
 
@@ -38,8 +38,10 @@
 #include <linux/skbuff.h>
 #include <linux/if_ether.h>
 #include <linux/netdevice.h>
+#include <linux/slab.h>
 
 #include "device.h"
+#include "latency.h"
 #include "master.h"
 
 #ifdef EC_DEBUG_RING
@@ -76,6 +78,9 @@ int ec_device_init(
     device->master = master;
     device->dev = NULL;
     device->poll = NULL;
+    device->flush = NULL;
+    device->xmit_more = 0;
+    device->burst_frames = 0;
     device->module = NULL;
     device->open = 0;
     device->link_state = 0;
@@ -83,6 +88,7 @@ int ec_device_init(
         device->tx_skb[i] = NULL;
     }
     device->tx_ring_index = 0;
+    INIT_LIST_HEAD(&device->frame_templates);
 #ifdef EC_HAVE_CYCLES
     device->cycles_poll = 0;
 #endif
@@ -168,6 +174,7 @@ void ec_device_clear(
     if (device->open) {
         ec_device_close(device);
     }
+    ec_device_clear_frame_templates(device);
     for (i = 0; i < EC_TX_RING_SIZE; i++)
         dev_kfree_skb(device->tx_skb[i]);
 #ifdef EC_DEBUG_IF
@@ -188,6 +195,7 @@ void ec_device_attach(
 {
     unsigned int i;
     struct ethhdr *eth;
+    ec_frame_template_t *template;
 
     ec_device_detach(device); // resets fields
 
@@ -201,6 +209,10 @@ void ec_device_attach(
         memcpy(eth->h_source, net_dev->dev_addr, ETH_ALEN);
     }
 
+    list_for_each_entry(template, &device->frame_templates, list) {
+        ec_frame_template_attach(template, net_dev);
+    }
+
 #ifdef EC_DEBUG_IF
     ec_debug_register(&device->dbg, net_dev);
 #endif
@@ -215,6 +227,7 @@ void ec_device_detach(
         )
 {
     unsigned int i;
+    ec_frame_template_t *template;
 
 #ifdef EC_DEBUG_IF
     ec_debug_unregister(&device->dbg);
@@ -222,6 +235,8 @@ void ec_device_detach(
 
     device->dev = NULL;
     device->poll = NULL;
+    device->flush = NULL;
+    device->xmit_more = 0;
     device->module = NULL;
     device->open = 0;
     device->link_state = 0; // down
@@ -231,6 +246,10 @@ void ec_device_detach(
     for (i = 0; i < EC_TX_RING_SIZE; i++) {
         device->tx_skb[i]->dev = NULL;
     }
+
+    list_for_each_entry(template, &device->frame_templates, list) {
+        ec_frame_template_attach(template, NULL);
+    }
 }
 
 /*****************************************************************************/
@@ -333,14 +352,30 @@ void ec_device_send(
         size_t size /**< number of bytes to send */
         )
 {
-    struct sk_buff *skb = device->tx_skb[device->tx_ring_index];
+    ec_device_send_frame(device, device->tx_skb[device->tx_ring_index], size);
+}
 
+/*****************************************************************************/
+
+/** Sends a frame from a given socket buffer.
+ *
+ * The socket buffer has to contain a valid Ethernet header (i. e. it has to
+ * be either part of the transmit ring or of a frame template). For
+ * scatter-gather frames, only the linear part is passed to the debug
+ * facilities.
+ */
+void ec_device_send_frame(
+        ec_device_t *device, /**< EtherCAT device */
+        struct sk_buff *skb, /**< socket buffer to send */
+        size_t size /**< number of bytes to send */
+        )
+{
     // set the right length for the data
     skb->len = ETH_HLEN + size;
 
     if (unlikely(device->master->debug_level > 1)) {
         EC_MASTER_DBG(device->master, 2, "Sending frame:\n");
-        ec_print_data(skb->data, ETH_HLEN + size);
+        ec_print_data(skb->data, skb_headlen(skb));
     }
 
     // start sending
@@ -352,15 +387,16 @@ void ec_device_send(
 #endif
     {
         device->tx_count++;
+        device->burst_frames++;
         device->master->device_stats.tx_count++;
         device->tx_bytes += ETH_HLEN + size;
         device->master->device_stats.tx_bytes += ETH_HLEN + size;
 #ifdef EC_DEBUG_IF
-        ec_debug_send(&device->dbg, skb->data, ETH_HLEN + size);
+        ec_debug_send(&device->dbg, skb->data, skb_headlen(skb));
 #endif
 #ifdef EC_DEBUG_RING
-        ec_device_debug_ring_append(
-                device, TX, skb->data + ETH_HLEN, size);
+        ec_device_debug_ring_append(device, TX, skb->data + ETH_HLEN,
+                skb_headlen(skb) - ETH_HLEN);
 #endif
     } else {
         device->tx_errors++;
@@ -369,6 +405,68 @@ void ec_device_send(
 
 /*****************************************************************************/
 
+/** Starts a transmit burst.
+ *
+ * If the driver provides a transmit flush function, it may defer notifying
+ * the hardware about the frames sent until ec_device_end_burst().
+ */
+void ec_device_begin_burst(
+        ec_device_t *device /**< EtherCAT device */
+        )
+{
+    device->xmit_more = device->flush ? 1 : 0;
+    device->burst_frames = 0;
+}
+
+/*****************************************************************************/
+
+/** Ends a transmit burst.
+ *
+ * Calls the driver's transmit flush function, so that all frames of the
+ * burst are posted to the hardware at once, and updates the burst
+ * statistics.
+ */
+void ec_device_end_burst(
+        ec_device_t *device /**< EtherCAT device */
+        )
+{
+    device->xmit_more = 0;
+
+    if (!device->burst_frames) {
+        return;
+    }
+
+    if (device->flush) {
+        device->flush(device->dev);
+    }
+
+    device->tx_bursts++;
+    device->last_tx_burst = device->burst_frames;
+    if (device->burst_frames > device->max_tx_burst) {
+        device->max_tx_burst = device->burst_frames;
+    }
+    device->burst_frames = 0;
+}
+
+/*****************************************************************************/
+
+/** Frees all frame templates of the device.
+ */
+void ec_device_clear_frame_templates(
+        ec_device_t *device /**< EtherCAT device */
+        )
+{
+    ec_frame_template_t *template, *next;
+
+    list_for_each_entry_safe(template, next, &device->frame_templates, list) {
+        list_del(&template->list);
+        ec_frame_template_clear(template);
+        kfree(template);
+    }
+}
+
+/*****************************************************************************/
+
 /** Clears the frame statistics.
  */
 void ec_device_clear_stats(
@@ -387,6 +485,10 @@ void ec_device_clear_stats(
     device->rx_bytes = 0;
     device->last_rx_bytes = 0;
     device->tx_errors = 0;
+    device->tx_bursts = 0;
+    device->last_tx_burst = 0;
+    device->max_tx_burst = 0;
+    ec_latency_reset(&device->latency);
 
     for (i = 0; i < EC_RATE_COUNT; i++) {
         device->tx_frame_rates[i] = 0;
@@ -715,6 +817,50 @@ uint8_t ecdev_get_link(
 
 /*****************************************************************************/
 
+/** Sets the transmit flush function of the device.
+ *
+ * If a flush function is set, the master sends the frames of a cycle in a
+ * burst: While ecdev_xmit_more() returns non-zero, the driver's transmit
+ * function may only queue the frame without notifying the hardware (i. e.
+ * without writing the transmit tail or poll register). After the last frame
+ * of the burst, the master calls the flush function, which has to notify
+ * the hardware about all frames queued.
+ *
+ * \ingroup DeviceInterface
+ */
+void ecdev_set_flush(
+        ec_device_t *device, /**< EtherCAT device */
+        ec_flushfunc_t flush /**< transmit flush function, or NULL */
+        )
+{
+    if (unlikely(!device)) {
+        EC_WARN("ecdev_set_flush() called with null device!\n");
+        return;
+    }
+
+    device->flush = flush;
+}
+
+/*****************************************************************************/
+
+/** Checks, if more frames of the current transmit burst follow.
+ *
+ * This can be called from the driver's transmit function (see
+ * ecdev_set_flush()).
+ *
+ * \ingroup DeviceInterface
+ *
+ * \return Non-zero, if notifying the hardware can be deferred.
+ */
+int ecdev_xmit_more(
+        const ec_device_t *device /**< EtherCAT device */
+        )
+{
+    return device->xmit_more;
+}
+
+/*****************************************************************************/
+
 /** \cond */
 
 EXPORT_SYMBOL(ecdev_withdraw);
@@ -723,6 +869,8 @@ EXPORT_SYMBOL(ecdev_close);
 EXPORT_SYMBOL(ecdev_receive);
 EXPORT_SYMBOL(ecdev_get_link);
 EXPORT_SYMBOL(ecdev_set_link);
+EXPORT_SYMBOL(ecdev_set_flush);
+EXPORT_SYMBOL(ecdev_xmit_more);
 
 /** \endcond */
 
@@ -41,6 +41,7 @@
 
 #include "../devices/ecdev.h"
 #include "globals.h"
+#include "frame_template.h"
 
 /**
  * Size of the transmit ring.
@@ -83,11 +84,19 @@ struct ec_device
     ec_master_t *master; /**< EtherCAT master */
     struct net_device *dev; /**< pointer to the assigned net_device */
     ec_pollfunc_t poll; /**< pointer to the device's poll function */
+    ec_flushfunc_t flush; /**< pointer to the device's transmit flush
+                            function, or NULL (see ecdev_set_flush()) */
+    uint8_t xmit_more; /**< More frames of the current burst follow, so the
+                         driver may defer notifying the hardware. */
+    unsigned int burst_frames; /**< Frames sent in the current burst. */
     struct module *module; /**< pointer to the device's owning module */
     uint8_t open; /**< true, if the net_device has been opened */
     uint8_t link_state; /**< device link state */
     struct sk_buff *tx_skb[EC_TX_RING_SIZE]; /**< transmit skb ring */
     unsigned int tx_ring_index; /**< last ring entry used to transmit */
+    struct list_head frame_templates; /**< Prebuilt frames for the cyclic
+                                        datagrams (see
+                                        ecrt_master_freeze_layout()). */
 #ifdef EC_HAVE_CYCLES
     cycles_t cycles_poll; /**< cycles of last poll */
 #endif
@@ -108,6 +117,12 @@ struct ec_device
     u64 last_rx_bytes; /**< Number of bytes received of last statistics cycle.
                         */
     u64 tx_errors; /**< Number of transmit errors. */
+    u64 tx_bursts; /**< Number of transmit bursts. */
+    unsigned int last_tx_burst; /**< Number of frames of the last transmit
+                                  burst. */
+    unsigned int max_tx_burst; /**< Maximum number of frames of a transmit
+                                 burst. */
+    ec_latency_t latency; /**< Round-trip times of the datagrams received. */
     s32 tx_frame_rates[EC_RATE_COUNT]; /**< Transmit rates in frames/s for
                                          different statistics cycle periods.
                                         */
@@ -144,6 +159,10 @@ int ec_device_close(ec_device_t *);
 void ec_device_poll(ec_device_t *);
 uint8_t *ec_device_tx_data(ec_device_t *);
 void ec_device_send(ec_device_t *, size_t);
+void ec_device_send_frame(ec_device_t *, struct sk_buff *, size_t);
+void ec_device_begin_burst(ec_device_t *);
+void ec_device_end_burst(ec_device_t *);
+void ec_device_clear_frame_templates(ec_device_t *);
 void ec_device_clear_stats(ec_device_t *);
 void ec_device_update_stats(ec_device_t *);
 
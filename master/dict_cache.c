@@ -0,0 +1,540 @@
+/******************************************************************************
+ *
+ *  $Id$
+ *
+ *  Copyright (C) 2006-2012  Florian Pose, Ingenieurgemeinschaft IgH
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  The license mentioned above concerns the source code only. Using the
+ *  EtherCAT technology and brand is only permitted in compliance with the
+ *  industrial property and similar rights of Beckhoff Automation GmbH.
+ *
+ *****************************************************************************/
+
+
+/**
+   \file
+   EtherCAT SDO dictionary cache methods.
+
+   A dictionary is serialized as a sequence of SDOs:
+
+   - SDO index (16 bit), object code (8 bit), maximum subindex (8 bit),
+     number of entries (16 bit) and the name,
+   - for each entry: subindex (8 bit), data type (16 bit), bit length
+     (16 bit), access rights (8 bit, read access in bits 0 to 2, write access
+     in bits 3 to 5) and the description.
+
+   Strings are stored with a 16 bit length prefix and without terminating
+   zero. All values are little-endian.
+*/
+
+/*****************************************************************************/
+
+#include <linux/slab.h>
+#include <linux/string.h>
+
+#include "slave.h"
+#include "sdo.h"
+#include "dict_cache.h"
+
+/*****************************************************************************/
+
+/** Frees a list of SDOs.
+ */
+static void ec_dict_clear_sdos(
+        struct list_head *sdos /**< SDO list. */
+        )
+{
+    ec_sdo_t *sdo, *next;
+
+    list_for_each_entry_safe(sdo, next, sdos, list) {
+        list_del(&sdo->list);
+        ec_sdo_clear(sdo);
+        kfree(sdo);
+    }
+}
+
+/*****************************************************************************/
+
+/** Copies a list of SDOs.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static int ec_dict_copy_sdos(
+        struct list_head *sdos, /**< Empty target list. */
+        const struct list_head *others, /**< SDO list to copy from. */
+        ec_slave_t *slave /**< Parent slave of the copies, or NULL. */
+        )
+{
+    const ec_sdo_t *other;
+    ec_sdo_t *sdo;
+    int ret;
+
+    list_for_each_entry(other, others, list) {
+        if (!(sdo = kmalloc(sizeof(ec_sdo_t), GFP_KERNEL))) {
+            ec_dict_clear_sdos(sdos);
+            return -ENOMEM;
+        }
+
+        ret = ec_sdo_init_copy(sdo, slave, other);
+        if (ret) {
+            kfree(sdo);
+            ec_dict_clear_sdos(sdos);
+            return ret;
+        }
+
+        list_add_tail(&sdo->list, sdos);
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** SDO dictionary cache constructor.
+ */
+void ec_dict_cache_init(
+        ec_dict_cache_t *cache /**< SDO dictionary cache. */
+        )
+{
+    INIT_LIST_HEAD(&cache->dicts);
+    cache->count = 0;
+}
+
+/*****************************************************************************/
+
+/** Removes a dictionary from the cache and frees it.
+ */
+static void ec_dict_cache_remove(
+        ec_dict_cache_t *cache, /**< SDO dictionary cache. */
+        ec_dict_t *dict /**< Cached dictionary. */
+        )
+{
+    list_del(&dict->list);
+    ec_dict_clear_sdos(&dict->sdos);
+    kfree(dict);
+    cache->count--;
+}
+
+/*****************************************************************************/
+
+/** SDO dictionary cache destructor.
+ *
+ * Frees all cached dictionaries.
+ */
+void ec_dict_cache_clear(
+        ec_dict_cache_t *cache /**< SDO dictionary cache. */
+        )
+{
+    ec_dict_t *dict, *next;
+
+    list_for_each_entry_safe(dict, next, &cache->dicts, list) {
+        ec_dict_cache_remove(cache, dict);
+    }
+}
+
+/*****************************************************************************/
+
+/** Searches a dictionary by identity.
+ *
+ * \return Cached dictionary, or NULL.
+ */
+static ec_dict_t *ec_dict_cache_lookup(
+        const ec_dict_cache_t *cache, /**< SDO dictionary cache. */
+        uint32_t vendor_id, /**< Vendor ID. */
+        uint32_t product_code, /**< Product code. */
+        uint32_t revision_number /**< Revision number. */
+        )
+{
+    ec_dict_t *dict;
+
+    list_for_each_entry(dict, &cache->dicts, list) {
+        if (dict->vendor_id == vendor_id
+                && dict->product_code == product_code
+                && dict->revision_number == revision_number) {
+            return dict;
+        }
+    }
+
+    return NULL;
+}
+
+/*****************************************************************************/
+
+/** Searches the dictionary of a slave.
+ *
+ * \return Cached dictionary, or NULL.
+ */
+const ec_dict_t *ec_dict_cache_find(
+        const ec_dict_cache_t *cache, /**< SDO dictionary cache. */
+        const ec_slave_t *slave /**< EtherCAT slave. */
+        )
+{
+    return ec_dict_cache_lookup(cache, slave->sii.vendor_id,
+            slave->sii.product_code, slave->sii.revision_number);
+}
+
+/*****************************************************************************/
+
+/** Gets a dictionary by its position in the cache.
+ *
+ * \return Cached dictionary, or NULL.
+ */
+const ec_dict_t *ec_dict_cache_get(
+        const ec_dict_cache_t *cache, /**< SDO dictionary cache. */
+        unsigned int index /**< Dictionary index. */
+        )
+{
+    const ec_dict_t *dict;
+
+    list_for_each_entry(dict, &cache->dicts, list) {
+        if (!index--) {
+            return dict;
+        }
+    }
+
+    return NULL;
+}
+
+/*****************************************************************************/
+
+/** Allocates an empty dictionary.
+ *
+ * \return Dictionary, or NULL, if the memory could not be allocated.
+ */
+static ec_dict_t *ec_dict_create(
+        uint32_t vendor_id, /**< Vendor ID. */
+        uint32_t product_code, /**< Product code. */
+        uint32_t revision_number /**< Revision number. */
+        )
+{
+    ec_dict_t *dict;
+
+    if (!(dict = kmalloc(sizeof(ec_dict_t), GFP_KERNEL))) {
+        return NULL;
+    }
+
+    dict->vendor_id = vendor_id;
+    dict->product_code = product_code;
+    dict->revision_number = revision_number;
+    INIT_LIST_HEAD(&dict->sdos);
+    dict->sdo_count = 0;
+    return dict;
+}
+
+/*****************************************************************************/
+
+/** Inserts a dictionary into the cache.
+ *
+ * A dictionary with the same identity is replaced. If the cache is full, the
+ * oldest dictionary is dropped.
+ */
+static void ec_dict_cache_insert(
+        ec_dict_cache_t *cache, /**< SDO dictionary cache. */
+        ec_dict_t *dict /**< Dictionary. */
+        )
+{
+    ec_dict_t *old;
+
+    if ((old = ec_dict_cache_lookup(cache, dict->vendor_id,
+                    dict->product_code, dict->revision_number))) {
+        ec_dict_cache_remove(cache, old);
+    } else if (cache->count >= EC_DICT_CACHE_MAX_DICTS) {
+        ec_dict_cache_remove(cache, list_entry(cache->dicts.next,
+                    ec_dict_t, list));
+    }
+
+    list_add_tail(&dict->list, &cache->dicts);
+    cache->count++;
+}
+
+/*****************************************************************************/
+
+/** Adds a copy of the dictionary of a slave to the cache.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_dict_cache_store(
+        ec_dict_cache_t *cache, /**< SDO dictionary cache. */
+        const ec_slave_t *slave /**< EtherCAT slave. */
+        )
+{
+    ec_dict_t *dict;
+    const ec_sdo_t *sdo;
+    int ret;
+
+    if (!(dict = ec_dict_create(slave->sii.vendor_id,
+                    slave->sii.product_code, slave->sii.revision_number))) {
+        return -ENOMEM;
+    }
+
+    ret = ec_dict_copy_sdos(&dict->sdos, &slave->sdo_dictionary, NULL);
+    if (ret) {
+        kfree(dict);
+        return ret;
+    }
+
+    list_for_each_entry(sdo, &dict->sdos, list) {
+        dict->sdo_count++;
+    }
+
+    ec_dict_cache_insert(cache, dict);
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** Copies a cached dictionary to a slave.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_dict_restore(
+        const ec_dict_t *dict, /**< Cached dictionary. */
+        ec_slave_t *slave /**< EtherCAT slave without dictionary. */
+        )
+{
+    return ec_dict_copy_sdos(&slave->sdo_dictionary, &dict->sdos, slave);
+}
+
+/*****************************************************************************/
+
+/** Serializes a string.
+ *
+ * \return Number of bytes.
+ */
+static size_t ec_dict_write_string(
+        uint8_t *data, /**< Target memory, or NULL. */
+        const char *string /**< String, or NULL. */
+        )
+{
+    size_t len = string ? min_t(size_t, strlen(string), 0xffff) : 0;
+
+    if (data) {
+        EC_WRITE_U16(data, len);
+        memcpy(data + 2, string, len);
+    }
+
+    return 2 + len;
+}
+
+/*****************************************************************************/
+
+/** Serializes a dictionary.
+ *
+ * If \a data is NULL, only the size is determined.
+ *
+ * \return Size of the serialized dictionary in bytes.
+ */
+size_t ec_dict_serialize(
+        const ec_dict_t *dict, /**< Cached dictionary. */
+        uint8_t *data /**< Target memory, or NULL. */
+        )
+{
+    const ec_sdo_t *sdo;
+    const ec_sdo_entry_t *entry;
+    size_t size = 0;
+    unsigned int entry_count, i;
+    uint8_t access;
+
+    list_for_each_entry(sdo, &dict->sdos, list) {
+        entry_count = 0;
+        list_for_each_entry(entry, &sdo->entries, list) {
+            entry_count++;
+        }
+
+        if (data) {
+            EC_WRITE_U16(data + size, sdo->index);
+            EC_WRITE_U8(data + size + 2, sdo->object_code);
+            EC_WRITE_U8(data + size + 3, sdo->max_subindex);
+            EC_WRITE_U16(data + size + 4, entry_count);
+        }
+        size += 6;
+        size += ec_dict_write_string(data ? data + size : NULL, sdo->name);
+
+        list_for_each_entry(entry, &sdo->entries, list) {
+            if (data) {
+                access = 0;
+                for (i = 0; i < EC_SDO_ENTRY_ACCESS_COUNT; i++) {
+                    access |= (entry->read_access[i] ? 1 : 0) << i;
+                    access |= (entry->write_access[i] ? 1 : 0) << (i + 3);
+                }
+                EC_WRITE_U8(data + size, entry->subindex);
+                EC_WRITE_U16(data + size + 1, entry->data_type);
+                EC_WRITE_U16(data + size + 3, entry->bit_length);
+                EC_WRITE_U8(data + size + 5, access);
+            }
+            size += 6;
+            size += ec_dict_write_string(data ? data + size : NULL,
+                    entry->description);
+        }
+    }
+
+    return size;
+}
+
+/*****************************************************************************/
+
+/** Deserializes a string.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static int ec_dict_read_string(
+        char **string, /**< String to allocate, or NULL for an empty one. */
+        const uint8_t **data, /**< Current position. */
+        const uint8_t *end /**< End of the serialized dictionary. */
+        )
+{
+    size_t len;
+
+    if (end - *data < 2) {
+        return -EINVAL;
+    }
+    len = EC_READ_U16(*data);
+    *data += 2;
+
+    if (end - *data < len) {
+        return -EINVAL;
+    }
+
+    if (len) {
+        if (!(*string = kmalloc(len + 1, GFP_KERNEL))) {
+            return -ENOMEM;
+        }
+        memcpy(*string, *data, len);
+        (*string)[len] = 0;
+        *data += len;
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** Deserializes an SDO and its entries.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static int ec_dict_read_sdo(
+        ec_sdo_t *sdo, /**< Initialized SDO. */
+        const uint8_t **data, /**< Current position. */
+        const uint8_t *end /**< End of the serialized dictionary. */
+        )
+{
+    ec_sdo_entry_t *entry;
+    unsigned int entry_count, i;
+    uint8_t access;
+    int ret;
+
+    if (end - *data < 6) {
+        return -EINVAL;
+    }
+    sdo->object_code = EC_READ_U8(*data + 2);
+    sdo->max_subindex = EC_READ_U8(*data + 3);
+    entry_count = EC_READ_U16(*data + 4);
+    *data += 6;
+
+    ret = ec_dict_read_string(&sdo->name, data, end);
+    if (ret) {
+        return ret;
+    }
+
+    while (entry_count--) {
+        if (end - *data < 6) {
+            return -EINVAL;
+        }
+
+        if (!(entry = kmalloc(sizeof(ec_sdo_entry_t), GFP_KERNEL))) {
+            return -ENOMEM;
+        }
+
+        ec_sdo_entry_init(entry, sdo, EC_READ_U8(*data));
+        entry->data_type = EC_READ_U16(*data + 1);
+        entry->bit_length = EC_READ_U16(*data + 3);
+        access = EC_READ_U8(*data + 5);
+        for (i = 0; i < EC_SDO_ENTRY_ACCESS_COUNT; i++) {
+            entry->read_access[i] = (access >> i) & 1;
+            entry->write_access[i] = (access >> (i + 3)) & 1;
+        }
+        list_add_tail(&entry->list, &sdo->entries);
+        *data += 6;
+
+        ret = ec_dict_read_string(&entry->description, data, end);
+        if (ret) {
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** Adds a serialized dictionary to the cache.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_dict_cache_load(
+        ec_dict_cache_t *cache, /**< SDO dictionary cache. */
+        uint32_t vendor_id, /**< Vendor ID. */
+        uint32_t product_code, /**< Product code. */
+        uint32_t revision_number, /**< Revision number. */
+        const uint8_t *data, /**< Serialized dictionary. */
+        size_t size /**< Size of \a data in bytes. */
+        )
+{
+    const uint8_t *end = data + size;
+    ec_dict_t *dict;
+    ec_sdo_t *sdo;
+    int ret;
+
+    if (!(dict = ec_dict_create(vendor_id, product_code, revision_number))) {
+        return -ENOMEM;
+    }
+
+    while (data < end) {
+        if (end - data < 2) {
+            ret = -EINVAL;
+            goto out_free;
+        }
+
+        if (!(sdo = kmalloc(sizeof(ec_sdo_t), GFP_KERNEL))) {
+            ret = -ENOMEM;
+            goto out_free;
+        }
+
+        ec_sdo_init(sdo, NULL, EC_READ_U16(data));
+        list_add_tail(&sdo->list, &dict->sdos);
+        dict->sdo_count++;
+
+        ret = ec_dict_read_sdo(sdo, &data, end);
+        if (ret) {
+            goto out_free;
+        }
+    }
+
+    ec_dict_cache_insert(cache, dict);
+    return 0;
+
+out_free:
+    ec_dict_clear_sdos(&dict->sdos);
+    kfree(dict);
+    return ret;
+}
+
+/*****************************************************************************/
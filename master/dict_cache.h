@@ -0,0 +1,92 @@
+/******************************************************************************
+ *
+ *  $Id$
+ *
+ *  Copyright (C) 2006-2012  Florian Pose, Ingenieurgemeinschaft IgH
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  The license mentioned above concerns the source code only. Using the
+ *  EtherCAT technology and brand is only permitted in compliance with the
+ *  industrial property and similar rights of Beckhoff Automation GmbH.
+ *
+ *****************************************************************************/
+
+
+/**
+   \file
+   EtherCAT SDO dictionary cache.
+*/
+
+/*****************************************************************************/
+
+#ifndef __EC_DICT_CACHE_H__
+#define __EC_DICT_CACHE_H__
+
+#include <linux/list.h>
+
+#include "globals.h"
+
+/*****************************************************************************/
+
+/** Maximum number of cached SDO dictionaries.
+ */
+#define EC_DICT_CACHE_MAX_DICTS 64
+
+/*****************************************************************************/
+
+/** Cached SDO dictionary.
+ */
+typedef struct {
+    struct list_head list; /**< List item. */
+    uint32_t vendor_id; /**< Vendor ID. */
+    uint32_t product_code; /**< Product code. */
+    uint32_t revision_number; /**< Revision number. */
+    struct list_head sdos; /**< SDOs. The parent slave is NULL. */
+    unsigned int sdo_count; /**< Number of SDOs. */
+} ec_dict_t;
+
+/** SDO dictionary cache.
+ *
+ * Slaves with the same vendor ID, product code and revision number share the
+ * SDO dictionary, that had to be uploaded only from the first of them. The
+ * cache is kept over bus scans and can be saved and loaded from user space.
+ */
+typedef struct {
+    struct list_head dicts; /**< Cached dictionaries, the oldest first. */
+    unsigned int count; /**< Number of cached dictionaries. */
+} ec_dict_cache_t;
+
+/*****************************************************************************/
+
+void ec_dict_cache_init(ec_dict_cache_t *);
+void ec_dict_cache_clear(ec_dict_cache_t *);
+
+const ec_dict_t *ec_dict_cache_find(const ec_dict_cache_t *,
+        const ec_slave_t *);
+const ec_dict_t *ec_dict_cache_get(const ec_dict_cache_t *, unsigned int);
+int ec_dict_cache_store(ec_dict_cache_t *, const ec_slave_t *);
+int ec_dict_cache_load(ec_dict_cache_t *, uint32_t, uint32_t, uint32_t,
+        const uint8_t *, size_t);
+
+int ec_dict_restore(const ec_dict_t *, ec_slave_t *);
+size_t ec_dict_serialize(const ec_dict_t *, uint8_t *);
+
+/*****************************************************************************/
+
+#endif
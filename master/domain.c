@@ -35,6 +35,7 @@
 /*****************************************************************************/
 
 #include <linux/module.h>
+#include <asm/unaligned.h>
 
 #include "globals.h"
 #include "master.h"
@@ -42,6 +43,7 @@
 
 #include "domain.h"
 #include "datagram_pair.h"
+#include "latency.h"
 
 /** Extra debug output for redundancy functions.
  */
@@ -74,6 +76,18 @@ void ec_domain_init(
     domain->data_size = 0;
     domain->data = NULL;
     domain->data_origin = EC_ORIG_INTERNAL;
+    domain->memory_mode = EC_DOMAIN_MEMORY_COPY;
+    domain->layout = EC_DOMAIN_LAYOUT_DEFAULT;
+    domain->cycle_divisor = 1;
+    domain->cycle_phase = 0;
+    domain->cycle_counter = 0;
+    domain->due = 0;
+    domain->track_changes = 0;
+    domain->changes = NULL;
+    domain->changes_origin = EC_ORIG_INTERNAL;
+    domain->shadow = NULL;
+    domain->input_regions = NULL;
+    domain->input_region_count = 0;
     domain->logical_base_address = 0x00000000;
     INIT_LIST_HEAD(&domain->datagram_pairs);
     for (dev_idx = EC_DEVICE_MAIN; dev_idx < ec_master_num_devices(master);
@@ -84,6 +98,7 @@ void ec_domain_init(
     domain->working_counter_changes = 0;
     domain->redundancy_active = 0;
     domain->notify_jiffies = 0;
+    ec_latency_reset(&domain->latency);
 
     /* Used by ec_domain_add_fmmu_config */
     memset(domain->offset_used, 0, sizeof(domain->offset_used));
@@ -122,6 +137,73 @@ void ec_domain_clear_data(
 
     domain->data = NULL;
     domain->data_origin = EC_ORIG_INTERNAL;
+
+    if (domain->changes_origin == EC_ORIG_INTERNAL && domain->changes) {
+        kfree(domain->changes);
+    }
+
+    domain->changes = NULL;
+    domain->changes_origin = EC_ORIG_INTERNAL;
+
+    if (domain->shadow) {
+        kfree(domain->shadow);
+        domain->shadow = NULL;
+    }
+
+    if (domain->input_regions) {
+        kfree(domain->input_regions);
+        domain->input_regions = NULL;
+    }
+    domain->input_region_count = 0;
+}
+
+/*****************************************************************************/
+
+/** Provides external memory for the change bitmap.
+ *
+ * The memory has to be EC_DOMAIN_CHANGES_SIZE() bytes large.
+ */
+void ec_domain_changes_memory(
+        ec_domain_t *domain, /**< EtherCAT domain. */
+        uint8_t *mem /**< Bitmap memory. */
+        )
+{
+    domain->changes = mem;
+    domain->changes_origin = EC_ORIG_EXTERNAL;
+}
+
+/*****************************************************************************/
+
+/** Finds a place for an FMMU configuration in the optimized layout.
+ *
+ * Searches the gaps between the already placed FMMU configurations for the
+ * first naturally aligned offset, where the data fit in. If there is no such
+ * gap, the data are appended at the next aligned offset.
+ *
+ * \return FMMU configuration, before which the new one has to be inserted,
+ *         or NULL, if it has to be appended.
+ */
+static ec_fmmu_config_t *ec_domain_place_fmmu(
+        ec_domain_t *domain, /**< EtherCAT domain. */
+        unsigned int alignment, /**< Alignment in byte. */
+        unsigned int size, /**< FMMU data size. */
+        uint32_t *offset /**< Logical domain offset. */
+        )
+{
+    ec_fmmu_config_t *cur;
+    uint32_t gap_start = 0;
+
+    list_for_each_entry(cur, &domain->fmmu_configs, list) {
+        *offset = ALIGN(gap_start, alignment);
+        if (*offset + size <= cur->logical_domain_offset) {
+            return cur;
+        }
+        gap_start = max(gap_start, cur->logical_domain_offset
+                + cur->data_size);
+    }
+
+    *offset = ALIGN(gap_start, alignment);
+    return NULL;
 }
 
 /*****************************************************************************/
@@ -134,6 +216,7 @@ void ec_domain_add_fmmu_config(
         )
 {
     const ec_slave_config_t *sc;
+    ec_fmmu_config_t *next = NULL;
     uint32_t logical_domain_offset;
     unsigned fmmu_data_size;
 
@@ -143,7 +226,19 @@ void ec_domain_add_fmmu_config(
     fmmu_data_size = ec_pdo_list_total_size(
         &sc->sync_configs[fmmu->sync_index].pdos);
 
-    if (sc->allow_overlapping_pdos && (sc == domain->sc_in_work)) {
+    if (domain->layout == EC_DOMAIN_LAYOUT_OPTIMIZED
+            && !sc->allow_overlapping_pdos) {
+        next = ec_domain_place_fmmu(domain, ec_pdo_list_alignment(
+                    &sc->sync_configs[fmmu->sync_index].pdos),
+                fmmu_data_size, &logical_domain_offset);
+        if (!next) {
+            // appended: the free offsets follow the new FMMU
+            domain->offset_used[EC_DIR_INPUT] =
+                logical_domain_offset + fmmu_data_size;
+            domain->offset_used[EC_DIR_OUTPUT] =
+                logical_domain_offset + fmmu_data_size;
+        }
+    } else if (sc->allow_overlapping_pdos && (sc == domain->sc_in_work)) {
         // If we permit overlapped PDOs, and we already have an allocated FMMU
         // for this slave, allocate the subsequent FMMU offsets by direction
         logical_domain_offset = domain->offset_used[fmmu->dir];
@@ -158,12 +253,16 @@ void ec_domain_add_fmmu_config(
     }
     domain->sc_in_work = sc;
 
-    // consume the offset space for this FMMU's direction
-    domain->offset_used[fmmu->dir] += fmmu_data_size;
+    if (domain->layout != EC_DOMAIN_LAYOUT_OPTIMIZED
+            || sc->allow_overlapping_pdos) {
+        // consume the offset space for this FMMU's direction
+        domain->offset_used[fmmu->dir] += fmmu_data_size;
+    }
 
     ec_fmmu_set_domain_offset_size(fmmu, logical_domain_offset, fmmu_data_size);
 
-    list_add_tail(&fmmu->list, &domain->fmmu_configs);
+    // keep the list ordered by offset
+    list_add_tail(&fmmu->list, next ? &next->list : &domain->fmmu_configs);
 
     // Determine domain size from furthest extent of FMMU data
     domain->data_size = max(domain->offset_used[EC_DIR_INPUT],
@@ -297,6 +396,256 @@ static int emplace_datagram(ec_domain_t *domain,
 
 /*****************************************************************************/
 
+#if EC_MAX_NUM_DEVICES > 1
+
+/** Domain finish helper function.
+ *
+ * Builds the input region map of every datagram pair, so that the
+ * redundancy merge in ecrt_domain_process() does not have to search the
+ * FMMU configurations in every cycle.
+ *
+ * \retval  0 Success.
+ * \retval <0 Error code.
+ */
+static int ec_domain_map_input_regions(
+        ec_domain_t *domain /**< EtherCAT domain. */
+        )
+{
+    ec_datagram_pair_t *pair;
+    const ec_fmmu_config_t *fmmu;
+    ec_input_region_t *region;
+    uint32_t begin, end;
+    unsigned int count;
+
+    list_for_each_entry(pair, &domain->datagram_pairs, list) {
+        const ec_datagram_t *main_datagram =
+            &pair->datagrams[EC_DEVICE_MAIN];
+
+        begin = EC_READ_U32(main_datagram->address)
+            - domain->logical_base_address;
+        end = begin + main_datagram->data_size;
+
+        count = 0;
+        list_for_each_entry(fmmu, &domain->fmmu_configs, list) {
+            if (fmmu->dir == EC_DIR_INPUT && fmmu->data_size
+                    && fmmu->logical_domain_offset >= begin
+                    && fmmu->logical_domain_offset < end) {
+                count++;
+            }
+        }
+
+        if (!count) {
+            continue;
+        }
+
+        if (!(pair->input_regions = kmalloc(
+                        count * sizeof(ec_input_region_t), GFP_KERNEL))) {
+            EC_MASTER_ERR(domain->master,
+                    "Failed to allocate input region map!\n");
+            return -ENOMEM;
+        }
+
+        region = pair->input_regions;
+        list_for_each_entry(fmmu, &domain->fmmu_configs, list) {
+            if (fmmu->dir == EC_DIR_INPUT && fmmu->data_size
+                    && fmmu->logical_domain_offset >= begin
+                    && fmmu->logical_domain_offset < end) {
+                region->offset = fmmu->logical_domain_offset - begin;
+                region->size = min_t(size_t, fmmu->data_size,
+                        end - fmmu->logical_domain_offset);
+                region++;
+            }
+        }
+        pair->input_region_count = count;
+    }
+
+    return 0;
+}
+
+#endif
+
+/*****************************************************************************/
+
+/** Domain finish helper function.
+ *
+ * Prepares the input change detection: Merges the input FMMUs to a list of
+ * contiguous input regions and allocates the memory for the previous inputs
+ * and for the change bitmap, if none was provided.
+ *
+ * \retval  0 Success.
+ * \retval <0 Error code.
+ */
+static int ec_domain_prepare_changes(
+        ec_domain_t *domain /**< EtherCAT domain. */
+        )
+{
+    const ec_fmmu_config_t *fmmu;
+    ec_input_region_t *region = NULL;
+    uint32_t fmmu_end;
+    unsigned int count = 0;
+
+    if (!domain->data_size) {
+        return 0;
+    }
+
+    list_for_each_entry(fmmu, &domain->fmmu_configs, list) {
+        if (fmmu->dir == EC_DIR_INPUT && fmmu->data_size) {
+            count++;
+        }
+    }
+
+    if (count && !(domain->input_regions = kmalloc(
+                    count * sizeof(ec_input_region_t), GFP_KERNEL))) {
+        EC_MASTER_ERR(domain->master,
+                "Failed to allocate input region list!\n");
+        return -ENOMEM;
+    }
+
+    // the FMMU list is ordered by offset, so adjacent regions are merged
+    list_for_each_entry(fmmu, &domain->fmmu_configs, list) {
+        if (fmmu->dir != EC_DIR_INPUT || !fmmu->data_size) {
+            continue;
+        }
+
+        fmmu_end = fmmu->logical_domain_offset + fmmu->data_size;
+        if (region && fmmu->logical_domain_offset
+                <= region->offset + region->size) {
+            if (fmmu_end > region->offset + region->size) {
+                region->size = fmmu_end - region->offset;
+            }
+        } else {
+            region = region ? region + 1 : domain->input_regions;
+            region->offset = fmmu->logical_domain_offset;
+            region->size = fmmu->data_size;
+            domain->input_region_count++;
+        }
+    }
+
+    if (!(domain->shadow = kzalloc(domain->data_size, GFP_KERNEL))) {
+        EC_MASTER_ERR(domain->master,
+                "Failed to allocate %zu bytes for previous inputs!\n",
+                domain->data_size);
+        return -ENOMEM;
+    }
+
+    if (!domain->changes) {
+        if (!(domain->changes = kmalloc(
+                        EC_DOMAIN_CHANGES_SIZE(domain->data_size),
+                        GFP_KERNEL))) {
+            EC_MASTER_ERR(domain->master,
+                    "Failed to allocate change bitmap!\n");
+            return -ENOMEM;
+        }
+        domain->changes_origin = EC_ORIG_INTERNAL;
+    }
+
+    memset(domain->changes, 0x00, EC_DOMAIN_CHANGES_SIZE(domain->data_size));
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** Detects the changed input bytes.
+ *
+ * Compares the input regions with the previous inputs machine word by
+ * machine word. Only the bytes of differing words are examined one by one.
+ * The previous inputs are updated on the fly.
+ */
+static void ec_domain_detect_changes(
+        ec_domain_t *domain /**< EtherCAT domain. */
+        )
+{
+    const ec_input_region_t *region = domain->input_regions,
+          *end = domain->input_regions + domain->input_region_count;
+    const uint8_t *cur;
+    uint8_t *prev;
+    size_t i, j, n, bit;
+
+    memset(domain->changes, 0x00, EC_DOMAIN_CHANGES_SIZE(domain->data_size));
+
+    for (; region < end; region++) {
+        cur = domain->data + region->offset;
+        prev = domain->shadow + region->offset;
+
+        for (i = 0; i < region->size; i += sizeof(unsigned long)) {
+            n = min_t(size_t, region->size - i, sizeof(unsigned long));
+            if (n == sizeof(unsigned long)
+                    && get_unaligned((const unsigned long *) (cur + i))
+                    == get_unaligned((const unsigned long *) (prev + i))) {
+                continue;
+            }
+
+            for (j = i; j < i + n; j++) {
+                if (cur[j] != prev[j]) {
+                    bit = region->offset + j;
+                    domain->changes[bit >> 3] |= 1 << (bit & 7);
+                    prev[j] = cur[j];
+                }
+            }
+        }
+    }
+}
+
+/*****************************************************************************/
+
+/** Domain finish helper function.
+ *
+ * Logs the resulting layout: Every datagram with its expected working
+ * counter, the number of frames, the bytes on the wire per link and the
+ * bytes not covered by any FMMU.
+ */
+static void ec_domain_report_layout(
+        const ec_domain_t *domain /**< EtherCAT domain. */
+        )
+{
+    const ec_datagram_pair_t *datagram_pair;
+    const ec_fmmu_config_t *fmmu;
+    size_t frame_size = 0, wire_size = 0, datagram_size, used = 0;
+    uint32_t covered = 0, fmmu_end;
+    unsigned int frame_count = 0;
+
+    list_for_each_entry(datagram_pair, &domain->datagram_pairs, list) {
+        const ec_datagram_t *datagram =
+            &datagram_pair->datagrams[EC_DEVICE_MAIN];
+        EC_MASTER_INFO(domain->master, "  Datagram %s: Logical offset 0x%08x,"
+                " %zu byte, type %s, expected WC %u.\n", datagram->name,
+                EC_READ_U32(datagram->address), datagram->data_size,
+                ec_datagram_type_string(datagram),
+                datagram_pair->expected_working_counter);
+
+        // pack the datagrams into frames like ec_master_send_datagrams()
+        datagram_size = EC_DATAGRAM_HEADER_SIZE + datagram->data_size
+            + EC_DATAGRAM_FOOTER_SIZE;
+        if (!frame_count || frame_size + datagram_size > ETH_DATA_LEN) {
+            if (frame_count) {
+                wire_size += max_t(size_t, ETH_HLEN + frame_size, ETH_ZLEN);
+            }
+            frame_size = EC_FRAME_HEADER_SIZE;
+            frame_count++;
+        }
+        frame_size += datagram_size;
+    }
+
+    if (frame_count) {
+        wire_size += max_t(size_t, ETH_HLEN + frame_size, ETH_ZLEN);
+    }
+
+    // the FMMU list is ordered by offset
+    list_for_each_entry(fmmu, &domain->fmmu_configs, list) {
+        fmmu_end = fmmu->logical_domain_offset + fmmu->data_size;
+        if (fmmu_end > covered) {
+            used += fmmu_end - max(covered, fmmu->logical_domain_offset);
+            covered = fmmu_end;
+        }
+    }
+
+    EC_MASTER_INFO(domain->master, "  %u frame(s), %zu byte on the wire"
+            " per link, %zu byte padding.\n", frame_count, wire_size,
+            domain->data_size - used);
+}
+
+/*****************************************************************************/
+
 /** Finishes a domain.
  *
  * This allocates the necessary datagrams and writes the correct logical
@@ -317,10 +666,10 @@ int ec_domain_finish(
     const ec_fmmu_config_t *valid_fmmu = NULL;
     unsigned candidate_start = 0;
     unsigned valid_start = 0;
-    const ec_datagram_pair_t *datagram_pair;
     int ret;
 
     domain->logical_base_address = base_address;
+    domain->cycle_counter = 0;
 
     if (domain->data_size && domain->data_origin == EC_ORIG_INTERNAL) {
         if (!(domain->data =
@@ -384,20 +733,26 @@ int ec_domain_finish(
         datagram_count++;
     }
 
+#if EC_MAX_NUM_DEVICES > 1
+    if (ec_master_num_devices(domain->master) > 1) {
+        ret = ec_domain_map_input_regions(domain);
+        if (ret < 0)
+            return ret;
+    }
+#endif
+
+    if (domain->track_changes) {
+        ret = ec_domain_prepare_changes(domain);
+        if (ret < 0)
+            return ret;
+    }
+
     EC_MASTER_INFO(domain->master, "Domain%u: Logical address 0x%08x,"
             " %zu byte, expected working counter %u.\n", domain->index,
             domain->logical_base_address, domain->data_size,
             domain->expected_working_counter);
 
-    list_for_each_entry(datagram_pair, &domain->datagram_pairs, list) {
-        const ec_datagram_t *datagram =
-            &datagram_pair->datagrams[EC_DEVICE_MAIN];
-        EC_MASTER_INFO(domain->master, "  Datagram %s: Logical offset 0x%08x,"
-                " %zu byte, type %s at %p.\n", datagram->name,
-                EC_READ_U32(datagram->address), datagram->data_size,
-                ec_datagram_type_string(datagram), datagram);
-    }
-
+    ec_domain_report_layout(domain);
     return 0;
 }
 
@@ -441,32 +796,6 @@ const ec_fmmu_config_t *ec_domain_find_fmmu(
 
 /*****************************************************************************/
 
-#if EC_MAX_NUM_DEVICES > 1
-
-/** Process received data.
- */
-int data_changed(
-        uint8_t *send_buffer,
-        const ec_datagram_t *datagram,
-        size_t offset,
-        size_t size
-        )
-{
-    uint8_t *sent = send_buffer + offset;
-    uint8_t *recv = datagram->data + offset;
-    size_t i;
-
-    for (i = 0; i < size; i++) {
-        if (recv[i] != sent[i]) {
-            return 1;
-        }
-    }
-
-    return 0;
-}
-
-#endif
-
 /******************************************************************************
  *  Application interface
  *****************************************************************************/
@@ -524,6 +853,110 @@ void ecrt_domain_external_memory(ec_domain_t *domain, uint8_t *mem)
 
 /*****************************************************************************/
 
+int ecrt_domain_memory_mode(ec_domain_t *domain, ec_domain_memory_t mode)
+{
+    EC_MASTER_DBG(domain->master, 1, "ecrt_domain_memory_mode("
+            "domain = 0x%p, mode = %u)\n", domain, mode);
+
+    switch (mode) {
+        case EC_DOMAIN_MEMORY_COPY:
+        case EC_DOMAIN_MEMORY_SCATTER_GATHER:
+            break;
+        default:
+            EC_MASTER_ERR(domain->master, "Invalid memory mode %u!\n",
+                    mode);
+            return -EINVAL;
+    }
+
+    if (domain->master->active) {
+        EC_MASTER_ERR(domain->master, "Memory mode can only be selected"
+                " before activation!\n");
+        return -EBUSY;
+    }
+
+    domain->memory_mode = mode;
+    return 0;
+}
+
+/*****************************************************************************/
+
+int ecrt_domain_layout(ec_domain_t *domain, ec_domain_layout_t layout)
+{
+    EC_MASTER_DBG(domain->master, 1, "ecrt_domain_layout("
+            "domain = 0x%p, layout = %u)\n", domain, layout);
+
+    switch (layout) {
+        case EC_DOMAIN_LAYOUT_DEFAULT:
+        case EC_DOMAIN_LAYOUT_OPTIMIZED:
+            break;
+        default:
+            EC_MASTER_ERR(domain->master, "Invalid domain layout %u!\n",
+                    layout);
+            return -EINVAL;
+    }
+
+    if (!list_empty(&domain->fmmu_configs)) {
+        EC_MASTER_ERR(domain->master, "Domain layout can only be selected"
+                " before registering PDO entries!\n");
+        return -EBUSY;
+    }
+
+    domain->layout = layout;
+    return 0;
+}
+
+/*****************************************************************************/
+
+int ecrt_domain_set_cycle_divisor(ec_domain_t *domain, unsigned int divisor,
+        unsigned int phase)
+{
+    EC_MASTER_DBG(domain->master, 1, "ecrt_domain_set_cycle_divisor("
+            "domain = 0x%p, divisor = %u, phase = %u)\n",
+            domain, divisor, phase);
+
+    if (!divisor || phase >= divisor) {
+        EC_MASTER_ERR(domain->master, "Invalid cycle divisor %u"
+                " with phase %u!\n", divisor, phase);
+        return -EINVAL;
+    }
+
+    if (domain->master->active) {
+        EC_MASTER_ERR(domain->master, "Cycle divisor can only be set"
+                " before activation!\n");
+        return -EBUSY;
+    }
+
+    domain->cycle_divisor = divisor;
+    domain->cycle_phase = phase;
+    return 0;
+}
+
+/*****************************************************************************/
+
+int ecrt_domain_track_changes(ec_domain_t *domain, uint8_t enable)
+{
+    EC_MASTER_DBG(domain->master, 1, "ecrt_domain_track_changes("
+            "domain = 0x%p, enable = %u)\n", domain, enable);
+
+    if (domain->master->active) {
+        EC_MASTER_ERR(domain->master, "Change tracking can only be"
+                " selected before activation!\n");
+        return -EBUSY;
+    }
+
+    domain->track_changes = enable ? 1 : 0;
+    return 0;
+}
+
+/*****************************************************************************/
+
+const uint8_t *ecrt_domain_changes(const ec_domain_t *domain)
+{
+    return domain->shadow ? domain->changes : NULL;
+}
+
+/*****************************************************************************/
+
 uint8_t *ecrt_domain_data(ec_domain_t *domain)
 {
     return domain->data;
@@ -537,9 +970,6 @@ void ecrt_domain_process(ec_domain_t *domain)
     ec_datagram_pair_t *pair;
 #if EC_MAX_NUM_DEVICES > 1
     uint16_t datagram_pair_wc, redundant_wc;
-    unsigned int datagram_offset;
-    ec_fmmu_config_t *fmmu = list_first_entry(&domain->fmmu_configs,
-            ec_fmmu_config_t, list);
     unsigned int redundancy;
 #endif
     unsigned int dev_idx;
@@ -560,79 +990,14 @@ void ecrt_domain_process(ec_domain_t *domain)
 
 #if EC_MAX_NUM_DEVICES > 1
         if (ec_master_num_devices(domain->master) > 1) {
-            ec_datagram_t *main_datagram = &pair->datagrams[EC_DEVICE_MAIN];
-            uint32_t logical_datagram_address =
-                EC_READ_U32(main_datagram->address);
-            size_t datagram_size = main_datagram->data_size;
-
-#if DEBUG_REDUNDANCY
-            EC_MASTER_DBG(domain->master, 1, "dgram %s log=%u\n",
-                    main_datagram->name, logical_datagram_address);
-#endif
-
-            /* Redundancy: Go through FMMU configs to detect data changes. */
-            list_for_each_entry_from(fmmu, &domain->fmmu_configs, list) {
-                ec_datagram_t *backup_datagram =
-                    &pair->datagrams[EC_DEVICE_BACKUP];
-
-                if (fmmu->dir != EC_DIR_INPUT) {
-                    continue;
-                }
-
-                if (fmmu->logical_domain_offset >= datagram_size) {
-                    // fmmu data contained in next datagram pair
-                    break;
-                }
-
-                datagram_offset = fmmu->logical_domain_offset;
-
 #if DEBUG_REDUNDANCY
-                EC_MASTER_DBG(domain->master, 1,
-                        "input fmmu log_off=%u size=%u offset=%u\n",
-                        fmmu->logical_domain_offset, fmmu->data_size,
-                        datagram_offset);
-                if (domain->master->debug_level > 0) {
-                    ec_print_data(pair->send_buffer + datagram_offset,
-                            fmmu->data_size);
-                    ec_print_data(main_datagram->data + datagram_offset,
-                            fmmu->data_size);
-                    ec_print_data(backup_datagram->data + datagram_offset,
-                            fmmu->data_size);
-                }
-#endif
-
-                if (data_changed(pair->send_buffer, main_datagram,
-                            datagram_offset, fmmu->data_size)) {
-                    /* data changed on main link: no copying necessary. */
-#if DEBUG_REDUNDANCY
-                    EC_MASTER_DBG(domain->master, 1, "main changed\n");
-#endif
-                } else if (data_changed(pair->send_buffer, backup_datagram,
-                            datagram_offset, fmmu->data_size)) {
-                    /* data changed on backup link: copy to main memory. */
-#if DEBUG_REDUNDANCY
-                    EC_MASTER_DBG(domain->master, 1, "backup changed\n");
-#endif
-                    memcpy(main_datagram->data + datagram_offset,
-                            backup_datagram->data + datagram_offset,
-                            fmmu->data_size);
-                } else if (datagram_pair_wc ==
-                        pair->expected_working_counter) {
-                    /* no change, but WC complete: use main data. */
-#if DEBUG_REDUNDANCY
-                    EC_MASTER_DBG(domain->master, 1,
-                            "no change but complete\n");
+            EC_MASTER_DBG(domain->master, 1, "dgram %s: %u input regions\n",
+                    pair->datagrams[EC_DEVICE_MAIN].name,
+                    pair->input_region_count);
 #endif
-                } else {
-                    /* no change and WC incomplete: mark WC as zero to avoid
-                     * data.dependent WC flickering. */
-                    datagram_pair_wc = 0;
-#if DEBUG_REDUNDANCY
-                    EC_MASTER_DBG(domain->master, 1,
-                            "no change and incomplete\n");
-#endif
-                }
-            }
+            /* Redundancy: Merge the inputs received on both links. */
+            datagram_pair_wc =
+                ec_datagram_pair_merge_inputs(pair, datagram_pair_wc);
         }
 #endif // EC_MAX_NUM_DEVICES > 1
     }
@@ -715,6 +1080,14 @@ void ecrt_domain_process(ec_domain_t *domain)
         domain->working_counter_changes = 0;
     }
 #endif
+
+    if (domain->shadow) {
+        ec_domain_detect_changes(domain);
+    }
+
+    if (domain->master->status) {
+        ec_master_publish_domain_state(domain->master, domain);
+    }
 }
 
 /*****************************************************************************/
@@ -781,6 +1154,11 @@ void ecrt_domain_state(const ec_domain_t *domain, ec_domain_state_t *state)
 EXPORT_SYMBOL(ecrt_domain_reg_pdo_entry_list);
 EXPORT_SYMBOL(ecrt_domain_size);
 EXPORT_SYMBOL(ecrt_domain_external_memory);
+EXPORT_SYMBOL(ecrt_domain_memory_mode);
+EXPORT_SYMBOL(ecrt_domain_layout);
+EXPORT_SYMBOL(ecrt_domain_set_cycle_divisor);
+EXPORT_SYMBOL(ecrt_domain_track_changes);
+EXPORT_SYMBOL(ecrt_domain_changes);
 EXPORT_SYMBOL(ecrt_domain_data);
 EXPORT_SYMBOL(ecrt_domain_process);
 EXPORT_SYMBOL(ecrt_domain_queue);
@@ -41,11 +41,18 @@
 
 #include "globals.h"
 #include "datagram.h"
+#include "datagram_pair.h"
 #include "master.h"
 #include "fmmu_config.h"
 
 /*****************************************************************************/
 
+/** Size of the change bitmap of a domain in byte.
+ */
+#define EC_DOMAIN_CHANGES_SIZE(DATA_SIZE) (((DATA_SIZE) + 7) / 8)
+
+/*****************************************************************************/
+
 /** EtherCAT domain.
  *
  * Handles the process data and the therefore needed datagrams of a certain
@@ -61,6 +68,27 @@ struct ec_domain
     size_t data_size; /**< Size of the process data. */
     uint8_t *data; /**< Memory for the process data. */
     ec_origin_t data_origin; /**< Origin of the \a data memory. */
+    ec_domain_memory_t memory_mode; /**< Memory mode for frame templates. */
+    ec_domain_layout_t layout; /**< Process data layout. */
+    unsigned int cycle_divisor; /**< The domain is exchanged every \a
+                                  cycle_divisor cycles (see
+                                  ecrt_master_queue_domains()). */
+    unsigned int cycle_phase; /**< Cycle, in which the domain is exchanged,
+                                relative to the divisor. */
+    unsigned int cycle_counter; /**< Cycles since activation modulo \a
+                                  cycle_divisor. */
+    unsigned int due; /**< The domain was queued by
+                        ecrt_master_queue_domains() and has not been
+                        processed, yet. */
+    unsigned int track_changes; /**< Detect input changes (see
+                                  ecrt_domain_track_changes()). */
+    uint8_t *changes; /**< Bitmap of the input bytes changed in the last
+                        ecrt_domain_process(), or NULL. */
+    ec_origin_t changes_origin; /**< Origin of the \a changes memory. */
+    uint8_t *shadow; /**< Inputs of the previous ecrt_domain_process(). */
+    ec_input_region_t *input_regions; /**< Input regions of the domain,
+                                        ordered by offset. */
+    unsigned int input_region_count; /**< Number of input regions. */
     uint32_t logical_base_address; /**< Logical offset address of the
                                      process data. */
     struct list_head datagram_pairs; /**< Datagrams pairs (main/backup) for
@@ -72,6 +100,7 @@ struct ec_domain
                                              since last notification. */
     unsigned int redundancy_active; /**< Non-zero, if redundancy is in use. */
     unsigned long notify_jiffies; /**< Time of last notification. */
+    ec_latency_t latency; /**< Round-trip times of the domain datagrams. */
     uint32_t offset_used[EC_DIR_COUNT]; /**< Next available domain offset of
         PDO, by direction */
     const ec_slave_config_t *sc_in_work; /**< slave_config which is actively
@@ -87,6 +116,8 @@ void ec_domain_clear(ec_domain_t *);
 void ec_domain_add_fmmu_config(ec_domain_t *, ec_fmmu_config_t *);
 int ec_domain_finish(ec_domain_t *, uint32_t);
 
+void ec_domain_changes_memory(ec_domain_t *, uint8_t *);
+
 unsigned int ec_domain_fmmu_count(const ec_domain_t *);
 const ec_fmmu_config_t *ec_domain_find_fmmu(const ec_domain_t *, unsigned int);
 
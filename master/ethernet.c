@@ -305,6 +305,7 @@ void ec_eoe_clear(ec_eoe_t *eoe /**< EoE handler */)
 
     free_netdev(eoe->dev);
 
+    ec_master_release_datagram(eoe->slave->master, &eoe->datagram);
     ec_datagram_clear(&eoe->datagram);
 }
 
@@ -0,0 +1,252 @@
+/******************************************************************************
+ *
+ *  $Id$
+ *
+ *  Copyright (C) 2006-2012  Florian Pose, Ingenieurgemeinschaft IgH
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  The license mentioned above concerns the source code only. Using the
+ *  EtherCAT technology and brand is only permitted in compliance with the
+ *  industrial property and similar rights of Beckhoff Automation GmbH.
+ *
+ *****************************************************************************/
+
+/**
+   \file
+   EtherCAT acyclic datagram scheduler methods.
+*/
+
+/*****************************************************************************/
+
+#include <linux/jiffies.h>
+#include <linux/math64.h>
+#include <linux/string.h>
+
+#include "latency.h"
+#include "ext_scheduler.h"
+
+/*****************************************************************************/
+
+/** Scheduler constructor.
+ */
+void ec_ext_scheduler_init(
+        ec_ext_scheduler_t *sched /**< Acyclic datagram scheduler. */
+        )
+{
+    unsigned int i;
+
+    for (i = 0; i < EC_EXT_CLASS_COUNT; i++) {
+        INIT_LIST_HEAD(&sched->queues[i].datagrams);
+        sched->queues[i].deficit = 0;
+        sched->queues[i].stats.depth = 0;
+        sched->queues[i].stats.max_depth = 0;
+        ec_latency_reset(&sched->queues[i].stats.wait);
+    }
+
+    sched->current = 0;
+}
+
+/*****************************************************************************/
+
+/** Resets the maximum queue depths and the wait time statistics.
+ */
+void ec_ext_scheduler_reset_stats(
+        ec_ext_scheduler_t *sched /**< Acyclic datagram scheduler. */
+        )
+{
+    unsigned int i;
+
+    for (i = 0; i < EC_EXT_CLASS_COUNT; i++) {
+        sched->queues[i].stats.max_depth = sched->queues[i].stats.depth;
+        ec_latency_reset(&sched->queues[i].stats.wait);
+    }
+}
+
+/*****************************************************************************/
+
+/** Returns the number of bytes, a datagram occupies in a frame.
+ *
+ * \return Datagram size including header and working counter.
+ */
+size_t ec_ext_datagram_size(
+        const ec_datagram_t *datagram /**< Datagram. */
+        )
+{
+    return EC_DATAGRAM_HEADER_SIZE + datagram->data_size
+        + EC_DATAGRAM_FOOTER_SIZE;
+}
+
+/*****************************************************************************/
+
+/** Returns the time, a datagram is waiting in the scheduler.
+ *
+ * \return Wait time [ns].
+ */
+static uint32_t ec_ext_datagram_wait_time(
+        const ec_datagram_t *datagram /**< Datagram. */
+        )
+{
+    u64 time_ns;
+
+#ifdef EC_HAVE_CYCLES
+    time_ns = div_u64((u64) (get_cycles() - datagram->cycles_sent)
+            * 1000000, cpu_khz);
+#else
+    time_ns = (u64) (jiffies - datagram->jiffies_sent) * (1000000000 / HZ);
+#endif
+
+    return time_ns > 0xffffffff ? 0xffffffff : (uint32_t) time_ns;
+}
+
+/*****************************************************************************/
+
+/** Appends a datagram to the queue of its class.
+ *
+ * The time of queuing is stored in the datagram's sending timestamps, which
+ * are overwritten on sending anyway.
+ */
+void ec_ext_scheduler_enqueue(
+        ec_ext_scheduler_t *sched, /**< Acyclic datagram scheduler. */
+        ec_ext_class_t ext_class, /**< Datagram class. */
+        ec_datagram_t *datagram /**< Datagram. */
+        )
+{
+    ec_ext_queue_t *queue = &sched->queues[ext_class];
+
+#ifdef EC_HAVE_CYCLES
+    datagram->cycles_sent = get_cycles();
+#endif
+    datagram->jiffies_sent = jiffies;
+
+    list_add_tail(&datagram->queue, &queue->datagrams);
+
+    queue->stats.depth++;
+    if (queue->stats.depth > queue->stats.max_depth) {
+        queue->stats.max_depth = queue->stats.depth;
+    }
+}
+
+/*****************************************************************************/
+
+/** Removes the first datagram from a queue.
+ */
+static void ec_ext_queue_remove(
+        ec_ext_queue_t *queue, /**< Queue. */
+        ec_datagram_t *datagram /**< First datagram of the queue. */
+        )
+{
+    list_del_init(&datagram->queue);
+    queue->stats.depth--;
+
+    if (list_empty(&queue->datagrams)) {
+        // an idle queue must not save up credit
+        queue->deficit = 0;
+    }
+}
+
+/*****************************************************************************/
+
+/** Takes the next datagram to inject.
+ *
+ * The queues are served by deficit round robin: Every queue is credited
+ * with #EC_EXT_QUANTUM bytes per round and may inject datagrams as long as
+ * its credit covers them. Service continues with the same queue on the next
+ * call, so the rounds span several cycles, if the budget is small.
+ *
+ * \return Datagram, or NULL, if all queues are empty or the next datagram
+ *         exceeds the budget.
+ */
+ec_datagram_t *ec_ext_scheduler_dequeue(
+        ec_ext_scheduler_t *sched, /**< Acyclic datagram scheduler. */
+        size_t budget /**< Remaining bytes in this cycle. */
+        )
+{
+    ec_ext_queue_t *queue;
+    ec_datagram_t *datagram;
+    size_t size;
+    unsigned int i;
+
+    // one full round credits every queue with its quantum
+    for (i = 0; i <= EC_EXT_CLASS_COUNT; i++) {
+        queue = &sched->queues[sched->current];
+
+        if (!list_empty(&queue->datagrams)) {
+            datagram = list_entry(queue->datagrams.next,
+                    ec_datagram_t, queue);
+            size = ec_ext_datagram_size(datagram);
+
+            if (size <= queue->deficit) {
+                if (size > budget) {
+                    // keep the credit for the next cycle
+                    return NULL;
+                }
+
+                queue->deficit -= size;
+                ec_latency_add(&queue->stats.wait,
+                        ec_ext_datagram_wait_time(datagram));
+                ec_ext_queue_remove(queue, datagram);
+                return datagram;
+            }
+        }
+
+        sched->current = (sched->current + 1) % EC_EXT_CLASS_COUNT;
+        queue = &sched->queues[sched->current];
+        if (!list_empty(&queue->datagrams)) {
+            queue->deficit += EC_EXT_QUANTUM;
+        }
+    }
+
+    return NULL;
+}
+
+/*****************************************************************************/
+
+/** Takes a datagram, that waits longer than the injection timeout.
+ *
+ * Only the first datagram of every queue has to be checked, because the
+ * queues are in FIFO order.
+ *
+ * \return Expired datagram, or NULL.
+ */
+ec_datagram_t *ec_ext_scheduler_expired(
+        ec_ext_scheduler_t *sched /**< Acyclic datagram scheduler. */
+        )
+{
+    ec_ext_queue_t *queue;
+    ec_datagram_t *datagram;
+    unsigned int i;
+
+    for (i = 0; i < EC_EXT_CLASS_COUNT; i++) {
+        queue = &sched->queues[i];
+        if (list_empty(&queue->datagrams)) {
+            continue;
+        }
+
+        datagram = list_entry(queue->datagrams.next, ec_datagram_t, queue);
+        if (ec_ext_datagram_wait_time(datagram)
+                > EC_SDO_INJECTION_TIMEOUT * 1000) {
+            ec_ext_queue_remove(queue, datagram);
+            return datagram;
+        }
+    }
+
+    return NULL;
+}
+
+/*****************************************************************************/
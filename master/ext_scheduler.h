@@ -0,0 +1,100 @@
+/******************************************************************************
+ *
+ *  $Id$
+ *
+ *  Copyright (C) 2006-2012  Florian Pose, Ingenieurgemeinschaft IgH
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  The license mentioned above concerns the source code only. Using the
+ *  EtherCAT technology and brand is only permitted in compliance with the
+ *  industrial property and similar rights of Beckhoff Automation GmbH.
+ *
+ *****************************************************************************/
+
+/**
+   \file
+   EtherCAT acyclic datagram scheduler.
+*/
+
+/*****************************************************************************/
+
+#ifndef __EC_EXT_SCHEDULER_H__
+#define __EC_EXT_SCHEDULER_H__
+
+#include <linux/list.h>
+
+#include "globals.h"
+#include "datagram.h"
+
+/*****************************************************************************/
+
+/** Quantum, a queue is credited with in every round [byte].
+ *
+ * The quantum covers the largest possible datagram, so that a queue can
+ * inject at least one datagram per round.
+ */
+#define EC_EXT_QUANTUM \
+    (EC_DATAGRAM_HEADER_SIZE + EC_MAX_DATA_SIZE + EC_DATAGRAM_FOOTER_SIZE)
+
+/** Datagram of the acyclic datagram pool.
+ *
+ * Every slave FSM in the execution list owns one of these datagrams. The
+ * pool grows on demand and is only freed on master destruction.
+ */
+typedef struct {
+    struct list_head list; /**< Pool list item. */
+    ec_datagram_t datagram; /**< Datagram. */
+    unsigned int used; /**< The datagram is owned by a slave FSM. */
+} ec_ext_datagram_t;
+
+/** Queue of the acyclic datagram scheduler.
+ */
+typedef struct {
+    struct list_head datagrams; /**< Waiting datagrams. */
+    size_t deficit; /**< Deficit counter [byte]. */
+    ec_ext_queue_stats_t stats; /**< Statistics. */
+} ec_ext_queue_t;
+
+/** Acyclic datagram scheduler.
+ *
+ * Distributes the bandwidth, that the cyclic datagrams leave free, among the
+ * datagram classes by deficit round robin. Each slave has at most one
+ * datagram in flight, so the slaves share the queue of a class in FIFO
+ * order.
+ */
+typedef struct {
+    ec_ext_queue_t queues[EC_EXT_CLASS_COUNT]; /**< Queue per class. */
+    unsigned int current; /**< Index of the queue in service. */
+} ec_ext_scheduler_t;
+
+/*****************************************************************************/
+
+void ec_ext_scheduler_init(ec_ext_scheduler_t *);
+void ec_ext_scheduler_reset_stats(ec_ext_scheduler_t *);
+
+size_t ec_ext_datagram_size(const ec_datagram_t *);
+
+void ec_ext_scheduler_enqueue(ec_ext_scheduler_t *, ec_ext_class_t,
+        ec_datagram_t *);
+ec_datagram_t *ec_ext_scheduler_dequeue(ec_ext_scheduler_t *, size_t);
+ec_datagram_t *ec_ext_scheduler_expired(ec_ext_scheduler_t *);
+
+/*****************************************************************************/
+
+#endif
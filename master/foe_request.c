@@ -62,6 +62,7 @@ void ec_foe_request_init(
     req->buffer = NULL;
     req->file_name = file_name;
     req->buffer_size = 0;
+    req->data_offset = 0;
     req->data_size = 0;
     req->dir = EC_DIR_INVALID;
     req->issue_timeout = 0; // no timeout
@@ -96,6 +97,7 @@ void ec_foe_request_clear_data(
     }
 
     req->buffer_size = 0;
+    req->data_offset = 0;
     req->data_size = 0;
 }
 
@@ -125,6 +127,7 @@ int ec_foe_request_alloc(
     }
 
     req->buffer_size = size;
+    req->data_offset = 0;
     req->data_size = 0;
     return 0;
 }
@@ -133,7 +136,7 @@ int ec_foe_request_alloc(
 
 /** Copies FoE data from an external source.
  *
- * If the \a buffer_size is to small, new memory is allocated.
+ * If the \a buffer_size is too small, new memory is allocated.
  *
  * \return Zero on success, otherwise a negative error code.
  */
@@ -151,12 +154,80 @@ int ec_foe_request_copy_data(
     }
 
     memcpy(req->buffer, source, size);
+    req->data_offset = 0;
     req->data_size = size;
     return 0;
 }
 
 /*****************************************************************************/
 
+/** Appends received FoE data.
+ *
+ * The data, that were not consumed yet, are moved to the front of the
+ * buffer, if the end of the buffer is reached. If the \a buffer_size is too
+ * small, the memory is enlarged.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_foe_request_append(
+        ec_foe_request_t *req, /**< FoE request. */
+        const uint8_t *source, /**< Source data. */
+        size_t size /**< Number of bytes in \a source. */
+        )
+{
+    if (req->data_offset + req->data_size + size > req->buffer_size) {
+        if (req->data_size + size <= req->buffer_size) {
+            memmove(req->buffer, req->buffer + req->data_offset,
+                    req->data_size);
+        } else {
+            size_t buffer_size =
+                max_t(size_t, 2 * req->buffer_size, req->data_size + size);
+            uint8_t *buffer;
+
+            if (!(buffer = (uint8_t *) kmalloc(buffer_size, GFP_KERNEL))) {
+                EC_ERR("Failed to allocate %zu bytes of FoE memory.\n",
+                        buffer_size);
+                return -ENOMEM;
+            }
+
+            if (req->buffer) {
+                memcpy(buffer, req->buffer + req->data_offset,
+                        req->data_size);
+                kfree(req->buffer);
+            }
+
+            req->buffer = buffer;
+            req->buffer_size = buffer_size;
+        }
+
+        req->data_offset = 0;
+    }
+
+    memcpy(req->buffer + req->data_offset + req->data_size, source, size);
+    req->data_size += size;
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** Removes data from the front of the FoE data, that were passed on.
+ */
+void ec_foe_request_consume(
+        ec_foe_request_t *req, /**< FoE request. */
+        size_t size /**< Number of bytes consumed. */
+        )
+{
+    req->data_size -= size;
+
+    if (req->data_size) {
+        req->data_offset += size;
+    } else {
+        req->data_offset = 0;
+    }
+}
+
+/*****************************************************************************/
+
 /** Checks, if the timeout was exceeded.
  *
  * \return non-zero if the timeout was exceeded, else zero.
@@ -191,7 +262,7 @@ uint8_t *ec_foe_request_data(
         ec_foe_request_t *req /**< FoE request. */
         )
 {
-    return req->buffer;
+    return req->buffer + req->data_offset;
 }
 
 /*****************************************************************************/
@@ -51,6 +51,7 @@ typedef struct {
     struct list_head list; /**< List item. */
     uint8_t *buffer; /**< Pointer to FoE data. */
     size_t buffer_size; /**< Size of FoE data memory. */
+    size_t data_offset; /**< Offset of the data not consumed yet. */
     size_t data_size; /**< Size of FoE data. */
 
     uint32_t issue_timeout; /**< Maximum time in ms, the processing of the
@@ -76,6 +77,8 @@ void ec_foe_request_clear(ec_foe_request_t *);
 
 int ec_foe_request_alloc(ec_foe_request_t *, size_t);
 int ec_foe_request_copy_data(ec_foe_request_t *, const uint8_t *, size_t);
+int ec_foe_request_append(ec_foe_request_t *, const uint8_t *, size_t);
+void ec_foe_request_consume(ec_foe_request_t *, size_t);
 int ec_foe_request_timed_out(const ec_foe_request_t *);
 
 void ec_foe_request_write(ec_foe_request_t *);
@@ -0,0 +1,339 @@
+/******************************************************************************
+ *
+ *  $Id$
+ *
+ *  Copyright (C) 2006-2012  Florian Pose, Ingenieurgemeinschaft IgH
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  The license mentioned above concerns the source code only. Using the
+ *  EtherCAT technology and brand is only permitted in compliance with the
+ *  industrial property and similar rights of Beckhoff Automation GmbH.
+ *
+ *****************************************************************************/
+
+/**
+   \file
+   EtherCAT frame template methods.
+*/
+
+/*****************************************************************************/
+
+#include <linux/if_ether.h>
+#include <linux/etherdevice.h>
+#include <linux/mm.h>
+#include <linux/slab.h>
+#include <linux/vmalloc.h>
+
+#include "frame_template.h"
+
+/*****************************************************************************/
+
+/** Frame template constructor.
+ *
+ * Allocates the socket buffer and prepares the Ethernet header and an empty
+ * EtherCAT frame header.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_frame_template_init(
+        ec_frame_template_t *template, /**< Frame template. */
+        struct net_device *net_dev, /**< Network device, or NULL. */
+        unsigned int scatter_gather /**< Build the frame from fragments. */
+        )
+{
+    struct ethhdr *eth;
+
+    INIT_LIST_HEAD(&template->list);
+    template->datagram_count = 0;
+    template->size = EC_FRAME_HEADER_SIZE;
+    template->scatter_gather = scatter_gather;
+    template->header_page = NULL;
+    template->frag_count = 0;
+
+    if (!(template->skb = dev_alloc_skb(ETH_FRAME_LEN))) {
+        return -ENOMEM;
+    }
+
+    if (scatter_gather) {
+        template->header_page = alloc_page(GFP_KERNEL | __GFP_ZERO);
+        if (!template->header_page) {
+            dev_kfree_skb(template->skb);
+            return -ENOMEM;
+        }
+    }
+
+    // add Ethernet-II-header
+    skb_reserve(template->skb, ETH_HLEN);
+    eth = (struct ethhdr *) skb_push(template->skb, ETH_HLEN);
+    eth->h_proto = htons(0x88A4);
+    memset(eth->h_dest, 0xFF, ETH_ALEN);
+
+    // the EtherCAT frame is zero-padded
+    memset(template->skb->data + ETH_HLEN, 0x00, ETH_DATA_LEN);
+
+    ec_frame_template_attach(template, net_dev);
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** Frame template destructor.
+ */
+void ec_frame_template_clear(
+        ec_frame_template_t *template /**< Frame template. */
+        )
+{
+    if (template->scatter_gather) {
+        /* The fragments do not hold page references, so they must not be
+         * released together with the socket buffer. */
+        skb_shinfo(template->skb)->nr_frags = 0;
+        template->skb->data_len = 0;
+        __free_page(template->header_page);
+    }
+
+    dev_kfree_skb(template->skb);
+}
+
+/*****************************************************************************/
+
+/** Associates the frame template with a network device.
+ *
+ * Sets the socket buffer's device and the Ethernet source address.
+ */
+void ec_frame_template_attach(
+        ec_frame_template_t *template, /**< Frame template. */
+        struct net_device *net_dev /**< Network device, or NULL. */
+        )
+{
+    struct ethhdr *eth = (struct ethhdr *) template->skb->data;
+
+    template->skb->dev = net_dev;
+    if (net_dev) {
+        memcpy(eth->h_source, net_dev->dev_addr, ETH_ALEN);
+    }
+}
+
+/*****************************************************************************/
+
+/** Returns the page containing a certain payload address.
+ *
+ * \return Page, or NULL, if the address can not be used for a fragment.
+ */
+static struct page *ec_frame_template_page(
+        const uint8_t *addr /**< Payload address. */
+        )
+{
+    if (is_vmalloc_addr(addr)) {
+        return vmalloc_to_page(addr);
+    }
+
+    if (virt_addr_valid(addr)) {
+        return virt_to_page(addr);
+    }
+
+    return NULL;
+}
+
+/*****************************************************************************/
+
+/** Checks, if the payload memory of a datagram can be referenced by a
+ * scatter-gather template.
+ *
+ * \return Non-zero, if the memory is page-addressable.
+ */
+int ec_frame_template_can_reference(
+        const ec_datagram_t *datagram /**< Datagram. */
+        )
+{
+    return datagram->data_size
+        && ec_frame_template_page(datagram->data)
+        && ec_frame_template_page(datagram->data + datagram->data_size - 1);
+}
+
+/*****************************************************************************/
+
+/** Appends a datagram to the frame template.
+ *
+ * For a linear template, the datagram header and working counter are
+ * serialized immediately. The datagram index and the payload are filled in
+ * on every send. Scatter-gather templates are serialized in
+ * ec_frame_template_finish().
+ *
+ * \retval 0 Success.
+ * \retval -ENOSPC The datagram does not fit into the frame.
+ */
+int ec_frame_template_add_datagram(
+        ec_frame_template_t *template, /**< Frame template. */
+        ec_datagram_t *datagram /**< Datagram. */
+        )
+{
+    uint8_t *frame_data = template->skb->data + ETH_HLEN;
+    uint8_t *cur_data = frame_data + template->size;
+    size_t datagram_size = EC_DATAGRAM_HEADER_SIZE + datagram->data_size
+        + EC_DATAGRAM_FOOTER_SIZE;
+    unsigned int frag_count = 0;
+
+    if (template->datagram_count >= EC_FRAME_TEMPLATE_MAX_DATAGRAMS
+            || template->size + datagram_size > ETH_DATA_LEN) {
+        return -ENOSPC;
+    }
+
+    if (template->scatter_gather) {
+        // payload pages and the trailing working counter
+        frag_count = DIV_ROUND_UP(offset_in_page(datagram->data)
+                + datagram->data_size, PAGE_SIZE) + 1;
+        if (template->frag_count + frag_count > MAX_SKB_FRAGS) {
+            return -ENOSPC;
+        }
+
+        template->frag_count += frag_count;
+        template->headers[template->datagram_count] = NULL;
+        template->datagrams[template->datagram_count++] = datagram;
+        template->size += datagram_size;
+        return 0;
+    }
+
+    // set "datagram following" flag in previous datagram
+    if (template->datagram_count) {
+        uint8_t *follows_word =
+            template->headers[template->datagram_count - 1] + 6;
+        EC_WRITE_U16(follows_word, EC_READ_U16(follows_word) | 0x8000);
+    }
+
+    // EtherCAT datagram header
+    EC_WRITE_U8 (cur_data, datagram->type);
+    EC_WRITE_U8 (cur_data + 1, 0x00); // index is set on sending
+    memcpy(cur_data + 2, datagram->address, EC_ADDR_LEN);
+    EC_WRITE_U16(cur_data + 6, datagram->data_size & 0x7FF);
+    EC_WRITE_U16(cur_data + 8, 0x0000);
+
+    // EtherCAT datagram footer
+    EC_WRITE_U16(cur_data + datagram_size - EC_DATAGRAM_FOOTER_SIZE, 0x0000);
+
+    template->headers[template->datagram_count] = cur_data;
+    template->datagrams[template->datagram_count++] = datagram;
+    template->size += datagram_size;
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** Adds page fragments referencing payload memory.
+ */
+static void ec_frame_template_add_frags(
+        ec_frame_template_t *template, /**< Frame template. */
+        const uint8_t *data, /**< Payload memory. */
+        size_t size /**< Payload size. */
+        )
+{
+    struct sk_buff *skb = template->skb;
+    size_t offset, len;
+
+    while (size) {
+        offset = offset_in_page(data);
+        len = min_t(size_t, size, PAGE_SIZE - offset);
+        skb_fill_page_desc(skb, skb_shinfo(skb)->nr_frags,
+                ec_frame_template_page(data), offset, len);
+        skb->data_len += len;
+        data += len;
+        size -= len;
+    }
+}
+
+/*****************************************************************************/
+
+/** Finishes the frame template after the last datagram was added.
+ *
+ * Serializes a scatter-gather template: The Ethernet header, the EtherCAT
+ * frame header and the first datagram header reside in the linear part of
+ * the socket buffer. Each datagram's payload is followed by a fragment in
+ * the header page, that contains its working counter and the header of the
+ * next datagram (or the frame padding, respectively).
+ */
+void ec_frame_template_finish(
+        ec_frame_template_t *template /**< Frame template. */
+        )
+{
+    uint8_t *header, *trailer;
+    ec_datagram_t *datagram;
+    size_t trailer_size;
+    unsigned int i;
+
+    if (!template->scatter_gather) {
+        return;
+    }
+
+    header = template->skb->data + ETH_HLEN + EC_FRAME_HEADER_SIZE;
+    trailer = page_address(template->header_page);
+
+    for (i = 0; i < template->datagram_count; i++) {
+        datagram = template->datagrams[i];
+
+        // EtherCAT datagram header
+        EC_WRITE_U8 (header, datagram->type);
+        EC_WRITE_U8 (header + 1, 0x00); // index is set on sending
+        memcpy(header + 2, datagram->address, EC_ADDR_LEN);
+        EC_WRITE_U16(header + 6, (datagram->data_size & 0x7FF)
+                | (i + 1 < template->datagram_count ? 0x8000 : 0x0000));
+        EC_WRITE_U16(header + 8, 0x0000);
+        template->headers[i] = header;
+
+        ec_frame_template_add_frags(template,
+                datagram->data, datagram->data_size);
+
+        // working counter and next header, or padding
+        trailer_size = EC_DATAGRAM_FOOTER_SIZE;
+        if (i + 1 < template->datagram_count) {
+            trailer_size += EC_DATAGRAM_HEADER_SIZE;
+        } else if (template->size < ETH_ZLEN - ETH_HLEN) {
+            trailer_size += ETH_ZLEN - ETH_HLEN - template->size;
+        }
+        skb_fill_page_desc(template->skb, skb_shinfo(template->skb)->nr_frags,
+                template->header_page,
+                trailer - (uint8_t *) page_address(template->header_page),
+                trailer_size);
+        template->skb->data_len += trailer_size;
+
+        header = trailer + EC_DATAGRAM_FOOTER_SIZE;
+        trailer += trailer_size;
+    }
+}
+
+/*****************************************************************************/
+
+/** Checks, if all datagrams of the frame template are queued for sending.
+ *
+ * \return Non-zero, if the frame template can be sent.
+ */
+int ec_frame_template_ready(
+        const ec_frame_template_t *template /**< Frame template. */
+        )
+{
+    unsigned int i;
+
+    for (i = 0; i < template->datagram_count; i++) {
+        if (template->datagrams[i]->state != EC_DATAGRAM_QUEUED) {
+            return 0;
+        }
+    }
+
+    return template->datagram_count > 0;
+}
+
+/*****************************************************************************/
@@ -0,0 +1,110 @@
+/******************************************************************************
+ *
+ *  $Id$
+ *
+ *  Copyright (C) 2006-2012  Florian Pose, Ingenieurgemeinschaft IgH
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  The license mentioned above concerns the source code only. Using the
+ *  EtherCAT technology and brand is only permitted in compliance with the
+ *  industrial property and similar rights of Beckhoff Automation GmbH.
+ *
+ *****************************************************************************/
+
+/**
+   \file
+   EtherCAT frame template structure.
+*/
+
+/*****************************************************************************/
+
+#ifndef __EC_FRAME_TEMPLATE_H__
+#define __EC_FRAME_TEMPLATE_H__
+
+#include <linux/list.h>
+#include <linux/netdevice.h>
+#include <linux/skbuff.h>
+
+#include "globals.h"
+#include "datagram.h"
+
+/*****************************************************************************/
+
+/** Maximum number of datagrams in a frame template.
+ *
+ * Every datagram occupies at least its header, one byte of data and the
+ * working counter.
+ */
+#define EC_FRAME_TEMPLATE_MAX_DATAGRAMS \
+    ((ETH_DATA_LEN - EC_FRAME_HEADER_SIZE) / \
+     (EC_DATAGRAM_HEADER_SIZE + 1 + EC_DATAGRAM_FOOTER_SIZE))
+
+/** How the payload of a datagram gets into a prebuilt frame.
+ */
+typedef enum {
+    EC_FRAME_PAYLOAD_COPY, /**< The payload is copied on every send. */
+    EC_FRAME_PAYLOAD_REFERENCE /**< The socket buffer references the datagram
+                                 memory via page fragments (the network
+                                 device has to support scatter-gather). */
+} ec_frame_payload_t;
+
+/** Prebuilt EtherCAT frame.
+ *
+ * Frame templates are built once on master activation, if the application
+ * froze the process data layout (see ecrt_master_freeze_layout()). The
+ * Ethernet header, the EtherCAT datagram headers and the working counters
+ * are serialized in advance into a dedicated socket buffer, so that only the
+ * datagram indices and the payload have to be updated in every cycle.
+ *
+ * A scatter-gather template only holds the headers itself and references
+ * the payload memory of its datagrams, so that nothing has to be copied.
+ */
+typedef struct {
+    struct list_head list; /**< List item. */
+    struct sk_buff *skb; /**< Socket buffer holding the prebuilt frame. */
+    ec_datagram_t *datagrams[EC_FRAME_TEMPLATE_MAX_DATAGRAMS]; /**< Datagrams
+                                                                 contained in
+                                                                 the frame. */
+    uint8_t *headers[EC_FRAME_TEMPLATE_MAX_DATAGRAMS]; /**< Datagram headers
+                                                         in the frame. */
+    unsigned int datagram_count; /**< Number of datagrams. */
+    size_t size; /**< Size of the EtherCAT frame without padding. */
+    unsigned int scatter_gather; /**< The frame is built from fragments. */
+    struct page *header_page; /**< Memory for the datagram headers and
+                                working counters of a scatter-gather
+                                template. */
+    unsigned int frag_count; /**< Number of fragments needed for a
+                               scatter-gather template. */
+} ec_frame_template_t;
+
+/*****************************************************************************/
+
+int ec_frame_template_init(ec_frame_template_t *, struct net_device *,
+        unsigned int);
+void ec_frame_template_clear(ec_frame_template_t *);
+void ec_frame_template_attach(ec_frame_template_t *, struct net_device *);
+
+int ec_frame_template_can_reference(const ec_datagram_t *);
+int ec_frame_template_add_datagram(ec_frame_template_t *, ec_datagram_t *);
+void ec_frame_template_finish(ec_frame_template_t *);
+int ec_frame_template_ready(const ec_frame_template_t *);
+
+/*****************************************************************************/
+
+#endif
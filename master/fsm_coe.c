@@ -1855,9 +1855,11 @@ int ec_fsm_coe_prepare_up(
     }
 
     EC_WRITE_U16(data, 0x2 << 12); // SDO request
-    EC_WRITE_U8 (data + 2, 0x2 << 5); // initiate upload request
+    EC_WRITE_U8 (data + 2, 0x2 << 5 // initiate upload request
+            | ((request->complete_access ? 1 : 0) << 4));
     EC_WRITE_U16(data + 3, request->index);
-    EC_WRITE_U8 (data + 5, request->subindex);
+    EC_WRITE_U8 (data + 5,
+            request->complete_access ? 0x00 : request->subindex);
     memset(data + 6, 0x00, 4);
 
     if (master->debug_level) {
@@ -1883,8 +1885,13 @@ void ec_fsm_coe_up_start(
     ec_slave_t *slave = fsm->slave;
     ec_sdo_request_t *request = fsm->request;
 
-    EC_SLAVE_DBG(slave, 1, "Uploading SDO 0x%04X:%02X.\n",
-            request->index, request->subindex);
+    if (request->complete_access) {
+        EC_SLAVE_DBG(slave, 1, "Uploading SDO 0x%04X via complete"
+                " access.\n", request->index);
+    } else {
+        EC_SLAVE_DBG(slave, 1, "Uploading SDO 0x%04X:%02X.\n",
+                request->index, request->subindex);
+    }
 
     if (!(slave->sii.mailbox_protocols & EC_MBOX_COE)) {
         EC_SLAVE_ERR(slave, "Slave does not support CoE!\n");
@@ -2073,7 +2080,7 @@ void ec_fsm_coe_up_response(
     ec_slave_t *slave = fsm->slave;
     ec_master_t *master = slave->master;
     uint16_t rec_index;
-    uint8_t *data, mbox_prot, rec_subindex;
+    uint8_t *data, mbox_prot, rec_subindex, subindex;
     size_t rec_size, data_size;
     ec_sdo_request_t *request = fsm->request;
     unsigned int expedited, size_specified;
@@ -2166,11 +2173,12 @@ void ec_fsm_coe_up_response(
 
     rec_index = EC_READ_U16(data + 3);
     rec_subindex = EC_READ_U8(data + 5);
+    subindex = request->complete_access ? 0x00 : request->subindex;
 
-    if (rec_index != request->index || rec_subindex != request->subindex) {
+    if (rec_index != request->index || rec_subindex != subindex) {
         EC_SLAVE_ERR(slave, "Received upload response for wrong SDO"
                 " (0x%04X:%02X, requested: 0x%04X:%02X).\n",
-                rec_index, rec_subindex, request->index, request->subindex);
+                rec_index, rec_subindex, request->index, subindex);
         ec_print_data(data, rec_size);
 
         // check for CoE response again
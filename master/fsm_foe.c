@@ -54,6 +54,11 @@
 // uint8_t  reserved
 // uint32_t PacketNo, Password, ErrorCode
 
+/** Number of received data fragments of an FoE read, that may wait for the
+ * reader, before the next acknowledge is held back.
+ */
+#define EC_FSM_FOE_READ_BACKLOG 4
+
 //#define DEBUG_FOE
 
 /*****************************************************************************/
@@ -76,6 +81,11 @@ int ec_foe_prepare_wrq_send(ec_fsm_foe_t *, ec_datagram_t *);
 int ec_foe_prepare_rrq_send(ec_fsm_foe_t *, ec_datagram_t *);
 int ec_foe_prepare_send_ack(ec_fsm_foe_t *, ec_datagram_t *);
 
+void ec_foe_prepare_response(ec_fsm_foe_t *, ec_datagram_t *,
+        void (*)(ec_fsm_foe_t *, ec_datagram_t *));
+void ec_foe_enter_repeat(ec_fsm_foe_t *, ec_datagram_t *);
+
+void ec_foe_set_error(ec_fsm_foe_t *, uint32_t);
 void ec_foe_set_tx_error(ec_fsm_foe_t *, uint32_t);
 void ec_foe_set_rx_error(ec_fsm_foe_t *, uint32_t);
 
@@ -85,15 +95,22 @@ void ec_fsm_foe_error(ec_fsm_foe_t *, ec_datagram_t *);
 void ec_fsm_foe_state_wrq_sent(ec_fsm_foe_t *, ec_datagram_t *);
 void ec_fsm_foe_state_rrq_sent(ec_fsm_foe_t *, ec_datagram_t *);
 
-void ec_fsm_foe_state_ack_check(ec_fsm_foe_t *, ec_datagram_t *);
+void ec_fsm_foe_state_check(ec_fsm_foe_t *, ec_datagram_t *);
+void ec_fsm_foe_state_repeat_state(ec_fsm_foe_t *, ec_datagram_t *);
+void ec_fsm_foe_state_repeat_sent(ec_fsm_foe_t *, ec_datagram_t *);
+void ec_fsm_foe_state_repeat_wait(ec_fsm_foe_t *, ec_datagram_t *);
+
 void ec_fsm_foe_state_ack_read(ec_fsm_foe_t *, ec_datagram_t *);
 
 void ec_fsm_foe_state_data_sent(ec_fsm_foe_t *, ec_datagram_t *);
 
-void ec_fsm_foe_state_data_check(ec_fsm_foe_t *, ec_datagram_t *);
 void ec_fsm_foe_state_data_read(ec_fsm_foe_t *, ec_datagram_t *);
+void ec_fsm_foe_state_ack_hold(ec_fsm_foe_t *, ec_datagram_t *);
 void ec_fsm_foe_state_sent_ack(ec_fsm_foe_t *, ec_datagram_t *);
 
+int ec_foe_read_backlog_full(const ec_fsm_foe_t *);
+void ec_foe_send_ack(ec_fsm_foe_t *, ec_datagram_t *);
+
 void ec_fsm_foe_write_start(ec_fsm_foe_t *, ec_datagram_t *);
 void ec_fsm_foe_read_start(ec_fsm_foe_t *, ec_datagram_t *);
 
@@ -106,6 +123,7 @@ void ec_fsm_foe_init(
         )
 {
     fsm->state = NULL;
+    fsm->read_state = NULL;
     fsm->datagram = NULL;
 }
 
@@ -186,9 +204,6 @@ void ec_fsm_foe_transfer(
         fsm->state = ec_fsm_foe_write_start;
     }
     else {
-        fsm->rx_buffer = fsm->request->buffer;
-        fsm->rx_buffer_size = fsm->request->buffer_size;
-
         fsm->rx_filename = fsm->request->file_name;
         fsm->rx_filename_len = strlen(fsm->rx_filename);
 
@@ -240,12 +255,12 @@ int ec_foe_prepare_data_send(
 
     remaining_size = fsm->tx_buffer_size - fsm->tx_buffer_offset;
 
-    if (remaining_size < fsm->slave->configured_tx_mailbox_size
+    if (remaining_size < fsm->slave->configured_rx_mailbox_size
             - EC_MBOX_HEADER_SIZE - EC_FOE_HEADER_SIZE) {
         current_size = remaining_size;
         fsm->tx_last_packet = 1;
     } else {
-        current_size = fsm->slave->configured_tx_mailbox_size
+        current_size = fsm->slave->configured_rx_mailbox_size
             - EC_MBOX_HEADER_SIZE - EC_FOE_HEADER_SIZE;
     }
 
@@ -344,9 +359,39 @@ void ec_fsm_foe_write_start(
 
 /*****************************************************************************/
 
-/** Check for acknowledge.
+/** Prepares to receive the response to a sent mailbox message.
+ *
+ * If the mailbox state is polled via the master's mailbox status datagram,
+ * the mailbox is checked before fetching it. Otherwise the mailbox is fetched
+ * right away: While it is empty, the fetch datagram is answered with a
+ * working counter of zero, so that a separate check datagram is not
+ * necessary.
+ */
+void ec_foe_prepare_response(
+        ec_fsm_foe_t *fsm, /**< FoE statemachine. */
+        ec_datagram_t *datagram, /**< Datagram to use. */
+        void (*read_state)(ec_fsm_foe_t *, ec_datagram_t *) /**< State
+                                                              processing the
+                                                              response. */
+        )
+{
+    fsm->read_state = read_state;
+    fsm->retries = EC_FSM_RETRIES;
+
+    if (fsm->slave->mbox_status_fmmu) {
+        ec_slave_mbox_prepare_check(fsm->slave, datagram); // can not fail.
+        fsm->state = ec_fsm_foe_state_check;
+    } else {
+        ec_slave_mbox_prepare_fetch(fsm->slave, datagram); // can not fail.
+        fsm->state = read_state;
+    }
+}
+
+/*****************************************************************************/
+
+/** Check for a response.
  */
-void ec_fsm_foe_state_ack_check(
+void ec_fsm_foe_state_check(
         ec_fsm_foe_t *fsm, /**< FoE statemachine. */
         ec_datagram_t *datagram /**< Datagram to use. */
         )
@@ -358,14 +403,14 @@ void ec_fsm_foe_state_ack_check(
 #endif
 
     if (fsm->datagram->state != EC_DATAGRAM_RECEIVED) {
-        ec_foe_set_rx_error(fsm, FOE_RECEIVE_ERROR);
+        ec_foe_set_error(fsm, FOE_RECEIVE_ERROR);
         EC_SLAVE_ERR(slave, "Failed to receive FoE mailbox check datagram: ");
         ec_datagram_print_state(fsm->datagram);
         return;
     }
 
     if (fsm->datagram->working_counter != 1) {
-        ec_foe_set_rx_error(fsm, FOE_WC_ERROR);
+        ec_foe_set_error(fsm, FOE_WC_ERROR);
         EC_SLAVE_ERR(slave, "Reception of FoE mailbox check datagram"
                 " failed: ");
         ec_datagram_print_wc_error(fsm->datagram);
@@ -376,8 +421,8 @@ void ec_fsm_foe_state_ack_check(
         // slave did not put anything in the mailbox yet
         if (time_after(fsm->datagram->jiffies_received,
                     fsm->jiffies_start + EC_FSM_FOE_TIMEOUT_JIFFIES)) {
-            ec_foe_set_tx_error(fsm, FOE_TIMEOUT_ERROR);
-            EC_SLAVE_ERR(slave, "Timeout while waiting for ack response.\n");
+            ec_foe_set_error(fsm, FOE_TIMEOUT_ERROR);
+            EC_SLAVE_ERR(slave, "Timeout while waiting for FoE response.\n");
             return;
         }
 
@@ -390,7 +435,170 @@ void ec_fsm_foe_state_ack_check(
     ec_slave_mbox_prepare_fetch(slave, datagram); // can not fail.
 
     fsm->retries = EC_FSM_RETRIES;
-    fsm->state = ec_fsm_foe_state_ack_read;
+    fsm->state = fsm->read_state;
+}
+
+/*****************************************************************************/
+
+/** Requests the slave to repeat a lost response.
+ *
+ * A fetch datagram that timed out may have emptied the mailbox nevertheless.
+ * Instead of failing the transfer, the repeat protocol of the send mailbox
+ * sync manager is used to get the response again.
+ */
+void ec_foe_enter_repeat(
+        ec_fsm_foe_t *fsm, /**< FoE statemachine. */
+        ec_datagram_t *datagram /**< Datagram to use. */
+        )
+{
+    EC_SLAVE_DBG(fsm->slave, 1, "FoE response lost. Requesting repeat.\n");
+
+    ec_slave_mbox_prepare_repeat_state(fsm->slave, datagram); // can not fail.
+    fsm->state = ec_fsm_foe_state_repeat_state;
+}
+
+/*****************************************************************************/
+
+/** State: REPEAT STATE.
+ *
+ * Toggles the repeat request, unless a previous request is still pending.
+ */
+void ec_fsm_foe_state_repeat_state(
+        ec_fsm_foe_t *fsm, /**< FoE statemachine. */
+        ec_datagram_t *datagram /**< Datagram to use. */
+        )
+{
+    ec_slave_t *slave = fsm->slave;
+    uint8_t activate;
+
+#ifdef DEBUG_FOE
+    EC_SLAVE_DBG(fsm->slave, 0, "%s()\n", __func__);
+#endif
+
+    if (fsm->datagram->state == EC_DATAGRAM_TIMED_OUT && fsm->retries--) {
+        ec_slave_mbox_prepare_repeat_state(slave, datagram); // can not fail.
+        return;
+    }
+
+    if (fsm->datagram->state != EC_DATAGRAM_RECEIVED) {
+        ec_foe_set_error(fsm, FOE_RECEIVE_ERROR);
+        EC_SLAVE_ERR(slave, "Failed to receive FoE repeat state datagram: ");
+        ec_datagram_print_state(fsm->datagram);
+        return;
+    }
+
+    if (fsm->datagram->working_counter != 1) {
+        ec_foe_set_error(fsm, FOE_WC_ERROR);
+        EC_SLAVE_ERR(slave, "Reception of FoE repeat state failed: ");
+        ec_datagram_print_wc_error(fsm->datagram);
+        return;
+    }
+
+    if (!ec_slave_mbox_repeat_done(fsm->datagram)) {
+        // a previous repeat request is still pending
+        ec_slave_mbox_prepare_repeat_state(slave, datagram); // can not fail.
+        fsm->state = ec_fsm_foe_state_repeat_wait;
+        return;
+    }
+
+    activate = EC_READ_U8(fsm->datagram->data);
+    ec_slave_mbox_prepare_repeat(slave, datagram, activate); // can not fail.
+    fsm->state = ec_fsm_foe_state_repeat_sent;
+}
+
+/*****************************************************************************/
+
+/** State: REPEAT SENT.
+ */
+void ec_fsm_foe_state_repeat_sent(
+        ec_fsm_foe_t *fsm, /**< FoE statemachine. */
+        ec_datagram_t *datagram /**< Datagram to use. */
+        )
+{
+    ec_slave_t *slave = fsm->slave;
+
+#ifdef DEBUG_FOE
+    EC_SLAVE_DBG(fsm->slave, 0, "%s()\n", __func__);
+#endif
+
+    if (fsm->datagram->state == EC_DATAGRAM_TIMED_OUT && fsm->retries--) {
+        // the request may have been toggled already
+        ec_slave_mbox_prepare_repeat_state(slave, datagram); // can not fail.
+        fsm->state = ec_fsm_foe_state_repeat_state;
+        return;
+    }
+
+    if (fsm->datagram->state != EC_DATAGRAM_RECEIVED) {
+        ec_foe_set_error(fsm, FOE_RECEIVE_ERROR);
+        EC_SLAVE_ERR(slave, "Failed to send FoE repeat request: ");
+        ec_datagram_print_state(fsm->datagram);
+        return;
+    }
+
+    if (fsm->datagram->working_counter != 1) {
+        ec_foe_set_error(fsm, FOE_WC_ERROR);
+        EC_SLAVE_ERR(slave, "Reception of FoE repeat request failed: ");
+        ec_datagram_print_wc_error(fsm->datagram);
+        return;
+    }
+
+    ec_slave_mbox_prepare_repeat_state(slave, datagram); // can not fail.
+    fsm->state = ec_fsm_foe_state_repeat_wait;
+}
+
+/*****************************************************************************/
+
+/** State: REPEAT WAIT.
+ *
+ * Waits for the slave to acknowledge the repeat request and fetches the
+ * response again.
+ */
+void ec_fsm_foe_state_repeat_wait(
+        ec_fsm_foe_t *fsm, /**< FoE statemachine. */
+        ec_datagram_t *datagram /**< Datagram to use. */
+        )
+{
+    ec_slave_t *slave = fsm->slave;
+
+#ifdef DEBUG_FOE
+    EC_SLAVE_DBG(fsm->slave, 0, "%s()\n", __func__);
+#endif
+
+    if (fsm->datagram->state == EC_DATAGRAM_TIMED_OUT && fsm->retries--) {
+        ec_slave_mbox_prepare_repeat_state(slave, datagram); // can not fail.
+        return;
+    }
+
+    if (fsm->datagram->state != EC_DATAGRAM_RECEIVED) {
+        ec_foe_set_error(fsm, FOE_RECEIVE_ERROR);
+        EC_SLAVE_ERR(slave, "Failed to receive FoE repeat state datagram: ");
+        ec_datagram_print_state(fsm->datagram);
+        return;
+    }
+
+    if (fsm->datagram->working_counter != 1) {
+        ec_foe_set_error(fsm, FOE_WC_ERROR);
+        EC_SLAVE_ERR(slave, "Reception of FoE repeat state failed: ");
+        ec_datagram_print_wc_error(fsm->datagram);
+        return;
+    }
+
+    if (!ec_slave_mbox_repeat_done(fsm->datagram)) {
+        if (time_after(fsm->datagram->jiffies_received,
+                    fsm->jiffies_start + EC_FSM_FOE_TIMEOUT_JIFFIES)) {
+            ec_foe_set_error(fsm, FOE_TIMEOUT_ERROR);
+            EC_SLAVE_ERR(slave, "Timeout while waiting for the FoE"
+                    " response to be repeated.\n");
+            return;
+        }
+
+        ec_slave_mbox_prepare_repeat_state(slave, datagram); // can not fail.
+        return;
+    }
+
+    // the slave put its last response into the mailbox again
+    ec_slave_mbox_prepare_fetch(slave, datagram); // can not fail.
+    fsm->state = fsm->read_state;
 }
 
 /*****************************************************************************/
@@ -411,6 +619,11 @@ void ec_fsm_foe_state_ack_read(
     EC_SLAVE_DBG(fsm->slave, 0, "%s()\n", __func__);
 #endif
 
+    if (fsm->datagram->state == EC_DATAGRAM_TIMED_OUT && fsm->retries--) {
+        ec_foe_enter_repeat(fsm, datagram);
+        return;
+    }
+
     if (fsm->datagram->state != EC_DATAGRAM_RECEIVED) {
         ec_foe_set_rx_error(fsm, FOE_RECEIVE_ERROR);
         EC_SLAVE_ERR(slave, "Failed to receive FoE ack response datagram: ");
@@ -418,6 +631,20 @@ void ec_fsm_foe_state_ack_read(
         return;
     }
 
+    if (fsm->datagram->working_counter == 0) {
+        // mailbox still empty
+        if (time_after(fsm->datagram->jiffies_received,
+                    fsm->jiffies_start + EC_FSM_FOE_TIMEOUT_JIFFIES)) {
+            ec_foe_set_tx_error(fsm, FOE_TIMEOUT_ERROR);
+            EC_SLAVE_ERR(slave, "Timeout while waiting for ack response.\n");
+            return;
+        }
+
+        ec_slave_mbox_prepare_fetch(slave, datagram); // can not fail.
+        fsm->retries = EC_FSM_RETRIES;
+        return;
+    }
+
     if (fsm->datagram->working_counter != 1) {
         ec_foe_set_rx_error(fsm, FOE_WC_ERROR);
         EC_SLAVE_ERR(slave, "Reception of FoE ack response failed: ");
@@ -521,11 +748,7 @@ void ec_fsm_foe_state_wrq_sent(
     }
 
     fsm->jiffies_start = fsm->datagram->jiffies_sent;
-
-    ec_slave_mbox_prepare_check(slave, datagram); // can not fail.
-
-    fsm->retries = EC_FSM_RETRIES;
-    fsm->state = ec_fsm_foe_state_ack_check;
+    ec_foe_prepare_response(fsm, datagram, ec_fsm_foe_state_ack_read);
 }
 
 /*****************************************************************************/
@@ -560,10 +783,8 @@ void ec_fsm_foe_state_data_sent(
         return;
     }
 
-    ec_slave_mbox_prepare_check(slave, datagram);
-    fsm->jiffies_start = jiffies;
-    fsm->retries = EC_FSM_RETRIES;
-    fsm->state = ec_fsm_foe_state_ack_check;
+    fsm->jiffies_start = fsm->datagram->jiffies_sent;
+    ec_foe_prepare_response(fsm, datagram, ec_fsm_foe_state_ack_read);
 }
 
 /*****************************************************************************/
@@ -666,11 +887,7 @@ void ec_fsm_foe_state_rrq_sent(
     }
 
     fsm->jiffies_start = fsm->datagram->jiffies_sent;
-
-    ec_slave_mbox_prepare_check(slave, datagram); // can not fail.
-
-    fsm->retries = EC_FSM_RETRIES;
-    fsm->state = ec_fsm_foe_state_data_check;
+    ec_foe_prepare_response(fsm, datagram, ec_fsm_foe_state_data_read);
 }
 
 /*****************************************************************************/
@@ -708,79 +925,49 @@ void ec_fsm_foe_read_start(
 
 /*****************************************************************************/
 
-/** Check for data.
+/** Start reading data.
  */
-void ec_fsm_foe_state_data_check(
+void ec_fsm_foe_state_data_read(
         ec_fsm_foe_t *fsm, /**< FoE statemachine. */
         ec_datagram_t *datagram /**< Datagram to use. */
         )
 {
+    size_t rec_size;
+    uint32_t packet_no;
+    uint8_t *data, opCode, mbox_prot;
+
     ec_slave_t *slave = fsm->slave;
 
 #ifdef DEBUG_FOE
     EC_SLAVE_DBG(fsm->slave, 0, "%s()\n", __func__);
 #endif
 
-    if (fsm->datagram->state != EC_DATAGRAM_RECEIVED) {
-        ec_foe_set_rx_error(fsm, FOE_RECEIVE_ERROR);
-        EC_SLAVE_ERR(slave, "Failed to send FoE DATA READ: ");
-        ec_datagram_print_state(fsm->datagram);
+    if (fsm->datagram->state == EC_DATAGRAM_TIMED_OUT && fsm->retries--) {
+        ec_foe_enter_repeat(fsm, datagram);
         return;
     }
 
-    if (fsm->datagram->working_counter != 1) {
-        ec_foe_set_rx_error(fsm, FOE_WC_ERROR);
-        EC_SLAVE_ERR(slave, "Reception of FoE DATA READ: ");
-        ec_datagram_print_wc_error(fsm->datagram);
+    if (fsm->datagram->state != EC_DATAGRAM_RECEIVED) {
+        ec_foe_set_rx_error(fsm, FOE_RECEIVE_ERROR);
+        EC_SLAVE_ERR(slave, "Failed to receive FoE DATA READ datagram: ");
+        ec_datagram_print_state(fsm->datagram);
         return;
     }
 
-    if (!ec_slave_mbox_check(fsm->datagram)) {
+    if (fsm->datagram->working_counter == 0) {
+        // mailbox still empty
         if (time_after(fsm->datagram->jiffies_received,
                     fsm->jiffies_start + EC_FSM_FOE_TIMEOUT_JIFFIES)) {
-            ec_foe_set_tx_error(fsm, FOE_TIMEOUT_ERROR);
-            EC_SLAVE_ERR(slave, "Timeout while waiting for ack response.\n");
+            ec_foe_set_rx_error(fsm, FOE_TIMEOUT_ERROR);
+            EC_SLAVE_ERR(slave, "Timeout while waiting for data.\n");
             return;
         }
 
-        ec_slave_mbox_prepare_check(slave, datagram); // can not fail.
+        ec_slave_mbox_prepare_fetch(slave, datagram); // can not fail.
         fsm->retries = EC_FSM_RETRIES;
         return;
     }
 
-    // Fetch response
-    ec_slave_mbox_prepare_fetch(slave, datagram); // can not fail.
-
-    fsm->retries = EC_FSM_RETRIES;
-    fsm->state = ec_fsm_foe_state_data_read;
-}
-
-/*****************************************************************************/
-
-/** Start reading data.
- */
-void ec_fsm_foe_state_data_read(
-        ec_fsm_foe_t *fsm, /**< FoE statemachine. */
-        ec_datagram_t *datagram /**< Datagram to use. */
-        )
-{
-    size_t rec_size;
-    uint32_t packet_no;
-    uint8_t *data, opCode, mbox_prot;
-
-    ec_slave_t *slave = fsm->slave;
-
-#ifdef DEBUG_FOE
-    EC_SLAVE_DBG(fsm->slave, 0, "%s()\n", __func__);
-#endif
-
-    if (fsm->datagram->state != EC_DATAGRAM_RECEIVED) {
-        ec_foe_set_rx_error(fsm, FOE_RECEIVE_ERROR);
-        EC_SLAVE_ERR(slave, "Failed to receive FoE DATA READ datagram: ");
-        ec_datagram_print_state(fsm->datagram);
-        return;
-    }
-
     if (fsm->datagram->working_counter != 1) {
         ec_foe_set_rx_error(fsm, FOE_WC_ERROR);
         EC_SLAVE_ERR(slave, "Reception of FoE DATA READ failed: ");
@@ -852,43 +1039,90 @@ void ec_fsm_foe_state_data_read(
 
     rec_size -= EC_FOE_HEADER_SIZE;
 
-    if (fsm->rx_buffer_size >= fsm->rx_buffer_offset + rec_size) {
-        memcpy(fsm->rx_buffer + fsm->rx_buffer_offset,
-                data + EC_FOE_HEADER_SIZE, rec_size);
-        fsm->rx_buffer_offset += rec_size;
+    if (ec_foe_request_append(fsm->request,
+                data + EC_FOE_HEADER_SIZE, rec_size)) {
+        ec_foe_set_rx_error(fsm, FOE_SEND_RX_DATA_ERROR);
+        return;
     }
+    fsm->rx_buffer_offset += rec_size;
+
+    // the reader drains the data while the transfer continues
+    wake_up_all(&slave->master->request_queue);
 
     fsm->rx_last_packet =
         (rec_size + EC_MBOX_HEADER_SIZE + EC_FOE_HEADER_SIZE
-         != slave->configured_rx_mailbox_size);
-
-    if (fsm->rx_last_packet ||
-            (slave->configured_rx_mailbox_size - EC_MBOX_HEADER_SIZE
-             - EC_FOE_HEADER_SIZE + fsm->rx_buffer_offset)
-            <= fsm->rx_buffer_size) {
-        // either it was the last packet or a new packet will fit into the
-        // delivered buffer
+         != slave->configured_tx_mailbox_size);
 #ifdef DEBUG_FOE
-        EC_SLAVE_DBG(fsm->slave, 0, "last_packet=true\n");
+    EC_SLAVE_DBG(fsm->slave, 0, "last_packet=%u\n", fsm->rx_last_packet);
 #endif
-        if (ec_foe_prepare_send_ack(fsm, datagram)) {
-            ec_foe_set_rx_error(fsm, FOE_RX_DATA_ACK_ERROR);
-            return;
-        }
 
-        fsm->state = ec_fsm_foe_state_sent_ack;
+    if (ec_foe_read_backlog_full(fsm)) {
+        // keep the state machine running until the reader caught up
+        ec_slave_mbox_prepare_check(slave, datagram); // can not fail.
+        fsm->state = ec_fsm_foe_state_ack_hold;
+        return;
     }
-    else {
-        // no more data fits into the delivered buffer
-        // ... wait for new read request
-        EC_SLAVE_ERR(slave, "Data do not fit in receive buffer!\n");
-        printk("  rx_buffer_size = %d\n", fsm->rx_buffer_size);
-        printk("rx_buffer_offset = %d\n", fsm->rx_buffer_offset);
-        printk("        rec_size = %zd\n", rec_size);
-        printk(" rx_mailbox_size = %d\n", slave->configured_rx_mailbox_size);
-        printk("  rx_last_packet = %d\n", fsm->rx_last_packet);
-        fsm->request->result = FOE_READY;
+
+    ec_foe_send_ack(fsm, datagram);
+}
+
+/*****************************************************************************/
+
+/** Checks, if the reader has to consume received data before the slave may
+ * send more.
+ *
+ * \return Non-zero, if the next acknowledge has to be held back.
+ */
+int ec_foe_read_backlog_full(
+        const ec_fsm_foe_t *fsm /**< FoE statemachine. */
+        )
+{
+    size_t payload_size = fsm->slave->configured_tx_mailbox_size
+        - EC_MBOX_HEADER_SIZE - EC_FOE_HEADER_SIZE;
+
+    return fsm->request->data_size >= EC_FSM_FOE_READ_BACKLOG * payload_size;
+}
+
+/*****************************************************************************/
+
+/** Acknowledges a received data fragment.
+ */
+void ec_foe_send_ack(
+        ec_fsm_foe_t *fsm, /**< FoE statemachine. */
+        ec_datagram_t *datagram /**< Datagram to use. */
+        )
+{
+    if (ec_foe_prepare_send_ack(fsm, datagram)) {
+        ec_foe_set_rx_error(fsm, FOE_RX_DATA_ACK_ERROR);
+        return;
     }
+
+    fsm->state = ec_fsm_foe_state_sent_ack;
+}
+
+/*****************************************************************************/
+
+/** State: ACK HOLD.
+ *
+ * Holds back the acknowledge of the last data fragment, until the reader
+ * consumed enough of the received data. Meanwhile, the mailbox is checked
+ * to keep the state machine running.
+ */
+void ec_fsm_foe_state_ack_hold(
+        ec_fsm_foe_t *fsm, /**< FoE statemachine. */
+        ec_datagram_t *datagram /**< Datagram to use. */
+        )
+{
+#ifdef DEBUG_FOE
+    EC_SLAVE_DBG(fsm->slave, 0, "%s()\n", __func__);
+#endif
+
+    if (ec_foe_read_backlog_full(fsm)) {
+        ec_slave_mbox_prepare_check(fsm->slave, datagram); // can not fail.
+        return;
+    }
+
+    ec_foe_send_ack(fsm, datagram);
 }
 
 /*****************************************************************************/
@@ -923,17 +1157,31 @@ void ec_fsm_foe_state_sent_ack(
 
     fsm->jiffies_start = fsm->datagram->jiffies_sent;
 
-    ec_slave_mbox_prepare_check(slave, datagram); // can not fail.
-
     if (fsm->rx_last_packet) {
         fsm->rx_expected_packet_no = 0;
-        fsm->request->data_size = fsm->rx_buffer_offset;
         fsm->state = ec_fsm_foe_end;
     }
     else {
         fsm->rx_expected_packet_no++;
-        fsm->retries = EC_FSM_RETRIES;
-        fsm->state = ec_fsm_foe_state_data_check;
+        ec_foe_prepare_response(fsm, datagram, ec_fsm_foe_state_data_read);
+    }
+}
+
+/*****************************************************************************/
+
+/** Set an error code depending on the transfer direction.
+ *
+ * Used by the states shared by read and write transfers.
+ */
+void ec_foe_set_error(
+        ec_fsm_foe_t *fsm, /**< FoE statemachine. */
+        uint32_t errorcode /**< FoE error code. */
+        )
+{
+    if (fsm->request->dir == EC_DIR_OUTPUT) {
+        ec_foe_set_tx_error(fsm, errorcode);
+    } else {
+        ec_foe_set_rx_error(fsm, errorcode);
     }
 }
 
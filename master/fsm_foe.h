@@ -55,6 +55,10 @@ struct ec_fsm_foe {
     unsigned int retries; /**< Retries upon datagram timeout */
 
     void (*state)(ec_fsm_foe_t *, ec_datagram_t *); /**< FoE state function. */
+    void (*read_state)(ec_fsm_foe_t *, ec_datagram_t *); /**< State
+                                                          processing the
+                                                          fetched
+                                                          response. */
     ec_datagram_t *datagram; /**< Datagram used in previous step. */
     unsigned long jiffies_start; /**< FoE timestamp. */
     uint8_t subindex; /**< Current subindex. */
@@ -70,9 +74,7 @@ struct ec_fsm_foe {
     uint8_t *tx_filename; /**< Name of file to transmit. */
     uint32_t tx_filename_len; /**< Lenth of transmit file name. */
 
-    uint8_t *rx_buffer; /**< Buffer for received data. */
-    uint32_t rx_buffer_size; /**< Size of receive buffer. */
-    uint32_t rx_buffer_offset; /**< Offset in receive buffer. */
+    uint32_t rx_buffer_offset; /**< Number of bytes received. */
     uint32_t rx_expected_packet_no; /**< Expected receive packet number. */
     uint32_t rx_last_packet; /**< Current packet is the last to receive. */
     uint8_t *rx_filename; /**< Name of the file to receive. */
@@ -61,6 +61,7 @@ void ec_fsm_master_state_open_port(ec_fsm_master_t *);
 #endif
 void ec_fsm_master_state_acknowledge(ec_fsm_master_t *);
 void ec_fsm_master_state_configure_slave(ec_fsm_master_t *);
+void ec_fsm_master_state_wait_workers(ec_fsm_master_t *);
 void ec_fsm_master_state_clear_addresses(ec_fsm_master_t *);
 #ifdef EC_LOOP_CONTROL
 void ec_fsm_master_state_loop_control(ec_fsm_master_t *);
@@ -76,31 +77,159 @@ void ec_fsm_master_state_sdo_request(ec_fsm_master_t *);
 void ec_fsm_master_enter_clear_addresses(ec_fsm_master_t *);
 void ec_fsm_master_enter_write_system_times(ec_fsm_master_t *);
 
+void ec_fsm_master_enter_wait_workers(ec_fsm_master_t *,
+        void (*)(ec_fsm_master_t *));
+
+int ec_fsm_master_worker_scan(ec_fsm_master_t *, ec_fsm_master_worker_t *);
+void ec_fsm_master_worker_scanned(ec_fsm_master_t *,
+        ec_fsm_master_worker_t *);
+ec_fsm_master_worker_t *ec_fsm_master_free_worker(ec_fsm_master_t *);
+void ec_fsm_master_worker_configure(ec_fsm_master_t *,
+        ec_fsm_master_worker_t *, ec_slave_t *);
+void ec_fsm_master_worker_configured(ec_fsm_master_t *,
+        ec_fsm_master_worker_t *);
+
+/*****************************************************************************/
+
+/** Initializes a slave worker.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static int ec_fsm_master_worker_init(
+        ec_fsm_master_worker_t *worker, /**< Slave worker. */
+        unsigned int index /**< Worker index. */
+        )
+{
+    int ret;
+
+    ec_datagram_init(&worker->datagram);
+    snprintf(worker->datagram.name, EC_DATAGRAM_NAME_SIZE,
+            "master-worker-%u", index);
+    ret = ec_datagram_prealloc(&worker->datagram, EC_MAX_DATA_SIZE);
+    if (ret < 0) {
+        ec_datagram_clear(&worker->datagram);
+        return ret;
+    }
+
+    worker->slave = NULL;
+    worker->configure = 0;
+    worker->jiffies_start = 0;
+    worker->queue = 0;
+
+    ec_fsm_coe_init(&worker->fsm_coe);
+    ec_fsm_soe_init(&worker->fsm_soe);
+    ec_fsm_pdo_init(&worker->fsm_pdo, &worker->fsm_coe);
+    ec_fsm_change_init(&worker->fsm_change, &worker->datagram);
+    ec_fsm_slave_config_init(&worker->fsm_slave_config,
+            &worker->datagram, &worker->fsm_change, &worker->fsm_coe,
+            &worker->fsm_soe, &worker->fsm_pdo);
+    ec_fsm_slave_scan_init(&worker->fsm_slave_scan, &worker->datagram,
+            &worker->fsm_slave_config, &worker->fsm_pdo);
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** Clears a slave worker.
+ */
+static void ec_fsm_master_worker_clear(
+        ec_fsm_master_worker_t *worker /**< Slave worker. */
+        )
+{
+    ec_fsm_coe_clear(&worker->fsm_coe);
+    ec_fsm_soe_clear(&worker->fsm_soe);
+    ec_fsm_pdo_clear(&worker->fsm_pdo);
+    ec_fsm_change_clear(&worker->fsm_change);
+    ec_fsm_slave_config_clear(&worker->fsm_slave_config);
+    ec_fsm_slave_scan_clear(&worker->fsm_slave_scan);
+    ec_datagram_clear(&worker->datagram);
+}
+
+/*****************************************************************************/
+
+/** Checks a parallelism module parameter.
+ *
+ * \return Number of slaves to process in parallel.
+ */
+static unsigned int ec_fsm_master_check_parallel(
+        ec_master_t *master, /**< EtherCAT master. */
+        const char *name, /**< Parameter name. */
+        unsigned int parallel /**< Parameter value. */
+        )
+{
+    if (parallel >= 1 && parallel <= EC_FSM_MASTER_MAX_WORKERS) {
+        return parallel;
+    }
+
+    EC_MASTER_WARN(master, "Invalid value %u for %s, using %u.\n",
+            parallel, name, parallel ? EC_FSM_MASTER_MAX_WORKERS : 1);
+    return parallel ? EC_FSM_MASTER_MAX_WORKERS : 1;
+}
+
 /*****************************************************************************/
 
 /** Constructor.
+ *
+ * \return Zero on success, otherwise a negative error code.
  */
-void ec_fsm_master_init(
+int ec_fsm_master_init(
         ec_fsm_master_t *fsm, /**< Master state machine. */
         ec_master_t *master, /**< EtherCAT master. */
-        ec_datagram_t *datagram /**< Datagram object to use. */
+        ec_datagram_t *datagram, /**< Datagram object to use. */
+        unsigned int scan_parallel, /**< Number of slaves to scan in
+                                      parallel. */
+        unsigned int config_parallel /**< Maximum number of slaves to
+                                       configure in parallel. */
         )
 {
+    unsigned int count;
+    int ret;
+
     fsm->master = master;
     fsm->datagram = datagram;
+    fsm->queue = 0;
+    fsm->resume = NULL;
+
+    fsm->scan_parallel = ec_fsm_master_check_parallel(master,
+            "scan_parallel", scan_parallel);
+    fsm->config_parallel = ec_fsm_master_check_parallel(master,
+            "config_parallel", config_parallel);
+    fsm->workers_busy = 0;
+    fsm->configs_busy = 0;
+
+    count = max(fsm->scan_parallel, fsm->config_parallel);
+    fsm->workers = kmalloc(sizeof(ec_fsm_master_worker_t) * count,
+            GFP_KERNEL);
+    if (!fsm->workers) {
+        EC_MASTER_ERR(master, "Failed to allocate slave workers.\n");
+        return -ENOMEM;
+    }
+
+    for (fsm->worker_count = 0; fsm->worker_count < count;
+            fsm->worker_count++) {
+        ret = ec_fsm_master_worker_init(
+                &fsm->workers[fsm->worker_count], fsm->worker_count);
+        if (ret < 0) {
+            EC_MASTER_ERR(master, "Failed to init slave worker %u.\n",
+                    fsm->worker_count);
+            goto out_clear_workers;
+        }
+    }
 
     ec_fsm_master_reset(fsm);
 
     // init sub-state-machines
     ec_fsm_coe_init(&fsm->fsm_coe);
-    ec_fsm_soe_init(&fsm->fsm_soe);
-    ec_fsm_pdo_init(&fsm->fsm_pdo, &fsm->fsm_coe);
     ec_fsm_change_init(&fsm->fsm_change, fsm->datagram);
-    ec_fsm_slave_config_init(&fsm->fsm_slave_config, fsm->datagram,
-            &fsm->fsm_change, &fsm->fsm_coe, &fsm->fsm_soe, &fsm->fsm_pdo);
-    ec_fsm_slave_scan_init(&fsm->fsm_slave_scan, fsm->datagram,
-            &fsm->fsm_slave_config, &fsm->fsm_pdo);
     ec_fsm_sii_init(&fsm->fsm_sii, fsm->datagram);
+    return 0;
+
+out_clear_workers:
+    while (fsm->worker_count) {
+        ec_fsm_master_worker_clear(&fsm->workers[--fsm->worker_count]);
+    }
+    kfree(fsm->workers);
+    return ret;
 }
 
 /*****************************************************************************/
@@ -111,14 +240,17 @@ void ec_fsm_master_clear(
         ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
-    // clear sub-state machines
+    unsigned int i;
+
+    // clear sub state machines
     ec_fsm_coe_clear(&fsm->fsm_coe);
-    ec_fsm_soe_clear(&fsm->fsm_soe);
-    ec_fsm_pdo_clear(&fsm->fsm_pdo);
     ec_fsm_change_clear(&fsm->fsm_change);
-    ec_fsm_slave_config_clear(&fsm->fsm_slave_config);
-    ec_fsm_slave_scan_clear(&fsm->fsm_slave_scan);
     ec_fsm_sii_clear(&fsm->fsm_sii);
+
+    for (i = 0; i < fsm->worker_count; i++) {
+        ec_fsm_master_worker_clear(&fsm->workers[i]);
+    }
+    kfree(fsm->workers);
 }
 
 /*****************************************************************************/
@@ -129,14 +261,30 @@ void ec_fsm_master_reset(
         ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
+    ec_master_t *master = fsm->master;
     ec_device_index_t dev_idx;
+    unsigned int i;
 
     fsm->state = ec_fsm_master_state_start;
     fsm->idle = 0;
     fsm->dev_idx = EC_DEVICE_MAIN;
+    fsm->queue = 0;
+
+    for (i = 0; i < fsm->worker_count; i++) {
+        fsm->workers[i].slave = NULL;
+        fsm->workers[i].queue = 0;
+    }
+    fsm->workers_busy = 0;
+
+    if (fsm->configs_busy) {
+        // abandoned slave configurations
+        fsm->configs_busy = 0;
+        master->config_busy = 0;
+        wake_up_interruptible(&master->config_queue);
+    }
 
     for (dev_idx = EC_DEVICE_MAIN;
-            dev_idx < ec_master_num_devices(fsm->master); dev_idx++) {
+            dev_idx < ec_master_num_devices(master); dev_idx++) {
         fsm->link_state[dev_idx] = 0;
         fsm->slaves_responding[dev_idx] = 0;
         fsm->slave_states[dev_idx] = EC_SLAVE_STATE_UNKNOWN;
@@ -147,25 +295,110 @@ void ec_fsm_master_reset(
 
 /*****************************************************************************/
 
+/** Checks, if the master state machine waits for its slave workers.
+ *
+ * The master state machine's own datagram is not used in these states.
+ *
+ * \return Non-zero, if the state machine is waiting.
+ */
+static int ec_fsm_master_waiting(
+        const ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    return fsm->state == ec_fsm_master_state_scan_slave
+        || fsm->state == ec_fsm_master_state_configure_slave
+        || fsm->state == ec_fsm_master_state_wait_workers;
+}
+
+/*****************************************************************************/
+
+/** Executes the slave workers.
+ */
+static void ec_fsm_master_exec_workers(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_fsm_master_worker_t *worker;
+    unsigned int i;
+
+    for (i = 0; i < fsm->worker_count; i++) {
+        worker = &fsm->workers[i];
+
+        if (!worker->slave) {
+            continue;
+        }
+
+        if (worker->datagram.state == EC_DATAGRAM_SENT
+                || worker->datagram.state == EC_DATAGRAM_QUEUED) {
+            // datagram was not sent or received yet.
+            continue;
+        }
+
+        if (worker->configure) {
+            if (ec_fsm_slave_config_exec(&worker->fsm_slave_config)) {
+                worker->queue = 1;
+            } else {
+                ec_fsm_master_worker_configured(fsm, worker);
+            }
+        } else {
+            if (ec_fsm_slave_scan_exec(&worker->fsm_slave_scan)) {
+                worker->queue = 1;
+            } else {
+                ec_fsm_master_worker_scanned(fsm, worker);
+            }
+        }
+    }
+}
+
+/*****************************************************************************/
+
+/** Checks, if the master state machine has datagrams to queue.
+ *
+ * \return Non-zero, if a datagram has to be queued.
+ */
+static int ec_fsm_master_has_datagrams(
+        const ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    unsigned int i;
+
+    if (fsm->queue) {
+        return 1;
+    }
+
+    for (i = 0; i < fsm->worker_count; i++) {
+        if (fsm->workers[i].queue) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+
 /** Executes the current state of the state machine.
  *
- * If the state machine's datagram is not sent or received yet, the execution
- * of the state machine is delayed to the next cycle.
+ * The slave workers are executed first. If the state machine's datagram is
+ * not sent or received yet, the execution of the state machine is delayed to
+ * the next cycle.
  *
- * \return true, if the state machine was executed
+ * \return true, if datagrams have to be queued (see
+ *         ec_fsm_master_queue_datagrams()).
  */
 int ec_fsm_master_exec(
         ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
-    if (fsm->datagram->state == EC_DATAGRAM_SENT
-        || fsm->datagram->state == EC_DATAGRAM_QUEUED) {
-        // datagram was not sent or received yet.
-        return 0;
+    ec_fsm_master_exec_workers(fsm);
+
+    if (fsm->datagram->state != EC_DATAGRAM_SENT
+            && fsm->datagram->state != EC_DATAGRAM_QUEUED) {
+        fsm->state(fsm);
+        fsm->queue = !ec_fsm_master_waiting(fsm);
     }
 
-    fsm->state(fsm);
-    return 1;
+    return ec_fsm_master_has_datagrams(fsm);
 }
 
 /*****************************************************************************/
@@ -177,22 +410,93 @@ int ec_fsm_master_idle(
         const ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
-    return fsm->idle;
+    return fsm->idle && !fsm->workers_busy;
+}
+
+/*****************************************************************************/
+
+/** Queues the datagrams of the master state machine.
+ *
+ * Has to be called after ec_fsm_master_exec() returned true. The datagrams
+ * of the slave workers are queued together with the master state machine's
+ * own datagram, so that they are sent in the same frames.
+ */
+void ec_fsm_master_queue_datagrams(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    unsigned int i;
+
+    if (fsm->queue) {
+        ec_master_queue_datagram(fsm->master, fsm->datagram);
+        fsm->queue = 0;
+    }
+
+    for (i = 0; i < fsm->worker_count; i++) {
+        ec_fsm_master_worker_t *worker = &fsm->workers[i];
+
+        if (worker->queue) {
+            ec_master_queue_datagram(fsm->master, &worker->datagram);
+            worker->queue = 0;
+        }
+    }
+}
+
+/*****************************************************************************/
+
+/** Continues with an action, as soon as all slave workers finished.
+ */
+void ec_fsm_master_enter_wait_workers(
+        ec_fsm_master_t *fsm, /**< Master state machine. */
+        void (*resume)(ec_fsm_master_t *) /**< Action to resume with. */
+        )
+{
+    if (!fsm->workers_busy) {
+        resume(fsm);
+        return;
+    }
+
+    fsm->resume = resume;
+    fsm->state = ec_fsm_master_state_wait_workers;
 }
 
 /*****************************************************************************/
 
 /** Restarts the master state machine.
+ *
+ * Slave workers in progress are finished first.
  */
 void ec_fsm_master_restart(
         ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
+    if (fsm->workers_busy) {
+        ec_fsm_master_enter_wait_workers(fsm, ec_fsm_master_restart);
+        return;
+    }
+
     fsm->dev_idx = EC_DEVICE_MAIN;
     fsm->state = ec_fsm_master_state_start;
     fsm->state(fsm); // execute immediately
 }
 
+/*****************************************************************************/
+
+/** Master state: WAIT WORKERS.
+ *
+ * Waits for all slave workers to finish.
+ */
+void ec_fsm_master_state_wait_workers(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    if (fsm->workers_busy) {
+        return;
+    }
+
+    fsm->resume(fsm);
+}
+
 /******************************************************************************
  * Master state machine
  *****************************************************************************/
@@ -456,6 +760,12 @@ int ec_fsm_master_action_process_sii(
         list_del_init(&request->list); // dequeue
         request->state = EC_INT_REQUEST_BUSY;
 
+        // the cached image does not match the SII contents any more
+        if (request->slave->sii_nwords >= EC_SII_IDENTITY_WORDS) {
+            ec_sii_cache_invalidate(&master->sii_cache,
+                    request->slave->sii_words);
+        }
+
         // found pending SII write operation. execute it!
         EC_SLAVE_DBG(request->slave, 1, "Writing SII data...\n");
         fsm->sii_request = request;
@@ -541,6 +851,7 @@ void ec_fsm_master_action_idle(
 {
     ec_master_t *master = fsm->master;
     ec_slave_t *slave;
+    const ec_dict_t *dict;
 
     // Check for pending internal SDO requests
     if (ec_fsm_master_action_process_sdo(fsm)) {
@@ -562,7 +873,19 @@ void ec_fsm_master_action_idle(
                 || (slave->sii.has_general
                     && !slave->sii.coe_details.enable_sdo_info)
                 || slave->sdo_dictionary_fetched
-                || slave->current_state == EC_SLAVE_STATE_INIT
+                ) continue;
+
+        // identical slaves share the dictionary via the cache
+        dict = ec_dict_cache_find(&master->dict_cache, slave);
+        if (dict && !ec_dict_restore(dict, slave)) {
+            EC_SLAVE_DBG(slave, 1, "Took %u SDOs from the dictionary"
+                    " cache.\n", dict->sdo_count);
+            slave->sdo_dictionary_fetched = 1;
+            ec_slave_attach_pdo_names(slave);
+            continue;
+        }
+
+        if (slave->current_state == EC_SLAVE_STATE_INIT
                 || slave->current_state == EC_SLAVE_STATE_UNKNOWN
                 || jiffies - slave->jiffies_preop < EC_WAIT_SDO_DICT * HZ
                 ) continue;
@@ -614,7 +937,7 @@ void ec_fsm_master_action_next_slave_state(
     }
 
     // all slaves processed
-    ec_fsm_master_action_idle(fsm);
+    ec_fsm_master_enter_wait_workers(fsm, ec_fsm_master_action_idle);
 }
 
 /*****************************************************************************/
@@ -772,8 +1095,9 @@ void ec_fsm_master_action_configure(
 {
     ec_master_t *master = fsm->master;
     ec_slave_t *slave = fsm->slave;
+    ec_fsm_master_worker_t *worker;
 
-    if (master->config_changed) {
+    if (master->config_changed && !fsm->workers_busy) {
         master->config_changed = 0;
 
         // abort iterating through slaves,
@@ -791,10 +1115,11 @@ void ec_fsm_master_action_configure(
     if ((slave->current_state != slave->requested_state
                 || slave->force_config) && !slave->error_flag) {
 
-        // Start slave configuration
-        down(&master->config_sem);
-        master->config_busy = 1;
-        up(&master->config_sem);
+        if (!(worker = ec_fsm_master_free_worker(fsm))) {
+            // wait for a slave worker to become available
+            fsm->state = ec_fsm_master_state_configure_slave;
+            return;
+        }
 
         if (master->debug_level) {
             char old_state[EC_STATE_STRING_SIZE],
@@ -806,12 +1131,8 @@ void ec_fsm_master_action_configure(
                     slave->force_config ? " (forced)" : "");
         }
 
-        fsm->idle = 0;
-        fsm->state = ec_fsm_master_state_configure_slave;
-        ec_fsm_slave_config_start(&fsm->fsm_slave_config, slave);
-        fsm->state(fsm); // execute immediately
-        fsm->datagram->device_index = fsm->slave->device_index;
-        return;
+        // configure the slave and continue checking the other slaves
+        ec_fsm_master_worker_configure(fsm, worker, slave);
     }
 
 #ifdef EC_LOOP_CONTROL
@@ -1040,6 +1361,7 @@ void ec_fsm_master_state_dc_measure_delays(
 {
     ec_master_t *master = fsm->master;
     ec_datagram_t *datagram = fsm->datagram;
+    unsigned int i;
 
     if (datagram->state == EC_DATAGRAM_TIMED_OUT && fsm->retries--) {
         return;
@@ -1072,33 +1394,64 @@ void ec_fsm_master_state_dc_measure_delays(
 
     // begin scanning of slaves
     fsm->slave = master->slaves;
-    EC_MASTER_DBG(master, 1, "Scanning slave %u on %s link.\n",
-            fsm->slave->ring_position,
-            ec_device_names[fsm->slave->device_index != 0]);
+    fsm->scan_busy_jiffies = 0;
+    for (i = 0; i < fsm->scan_parallel; i++) {
+        ec_fsm_master_worker_scan(fsm, &fsm->workers[i]);
+    }
     fsm->state = ec_fsm_master_state_scan_slave;
-    ec_fsm_slave_scan_start(&fsm->fsm_slave_scan, fsm->slave);
-    ec_fsm_slave_scan_exec(&fsm->fsm_slave_scan); // execute immediately
-    fsm->datagram->device_index = fsm->slave->device_index;
 }
 
 /*****************************************************************************/
 
-/** Master state: SCAN SLAVE.
+/** Assigns the next unscanned slave to a slave worker.
  *
- * Executes the sub-statemachine for the scanning of a slave.
+ * \return Non-zero, if the worker got a slave to scan.
  */
-void ec_fsm_master_state_scan_slave(
-        ec_fsm_master_t *fsm /**< Master state machine. */
+int ec_fsm_master_worker_scan(
+        ec_fsm_master_t *fsm, /**< Master state machine. */
+        ec_fsm_master_worker_t *worker /**< Idle slave worker. */
         )
 {
     ec_master_t *master = fsm->master;
+
+    if (fsm->slave >= master->slaves + master->slave_count) {
+        return 0;
+    }
+
+    worker->slave = fsm->slave++;
+    worker->configure = 0;
+    worker->jiffies_start = jiffies;
+    fsm->workers_busy++;
+
+    EC_MASTER_DBG(master, 1, "Scanning slave %u on %s link.\n",
+            worker->slave->ring_position,
+            ec_device_names[worker->slave->device_index != 0]);
+    ec_fsm_slave_scan_start(&worker->fsm_slave_scan, worker->slave);
+    ec_fsm_slave_scan_exec(&worker->fsm_slave_scan); // execute immediately
+    worker->datagram.device_index = worker->slave->device_index;
+    worker->queue = 1;
+    return 1;
+}
+
+/*****************************************************************************/
+
+/** A slave worker finished scanning a slave.
+ *
+ * The worker gets the next unscanned slave assigned.
+ */
+void ec_fsm_master_worker_scanned(
+        ec_fsm_master_t *fsm, /**< Master state machine. */
+        ec_fsm_master_worker_t *worker /**< Slave worker. */
+        )
+{
 #ifdef EC_EOE
-    ec_slave_t *slave = fsm->slave;
+    ec_master_t *master = fsm->master;
+    ec_slave_t *slave = worker->slave;
 #endif
 
-    if (ec_fsm_slave_scan_exec(&fsm->fsm_slave_scan)) {
-        return;
-    }
+    fsm->scan_busy_jiffies += jiffies - worker->jiffies_start;
+    worker->slave = NULL;
+    fsm->workers_busy--;
 
 #ifdef EC_EOE
     if (slave->sii.mailbox_protocols & EC_MBOX_EOE) {
@@ -1116,19 +1469,40 @@ void ec_fsm_master_state_scan_slave(
 #endif
 
     // another slave to fetch?
-    fsm->slave++;
-    if (fsm->slave < master->slaves + master->slave_count) {
-        EC_MASTER_DBG(master, 1, "Scanning slave %u on %s link.\n",
-                fsm->slave->ring_position,
-                ec_device_names[fsm->slave->device_index != 0]);
-        ec_fsm_slave_scan_start(&fsm->fsm_slave_scan, fsm->slave);
-        ec_fsm_slave_scan_exec(&fsm->fsm_slave_scan); // execute immediately
-        fsm->datagram->device_index = fsm->slave->device_index;
+    ec_fsm_master_worker_scan(fsm, worker);
+}
+
+/*****************************************************************************/
+
+/** Master state: SCAN SLAVE.
+ *
+ * Waits for the slave workers to scan all slaves (see
+ * ec_fsm_master_worker_scanned()).
+ */
+void ec_fsm_master_state_scan_slave(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_master_t *master = fsm->master;
+    unsigned long scan_jiffies;
+
+    if (fsm->workers_busy) {
         return;
     }
 
-    EC_MASTER_INFO(master, "Bus scanning completed in %lu ms.\n",
-            (jiffies - fsm->scan_jiffies) * 1000 / HZ);
+    scan_jiffies = jiffies - fsm->scan_jiffies;
+    if (fsm->scan_parallel > 1 && scan_jiffies) {
+        unsigned long speedup = fsm->scan_busy_jiffies * 10 / scan_jiffies;
+
+        EC_MASTER_INFO(master, "Bus scanning completed in %lu ms"
+                " (%u slaves, %u in parallel, %lu.%lu times faster than"
+                " sequential).\n", scan_jiffies * 1000 / HZ,
+                master->slave_count, fsm->scan_parallel,
+                speedup / 10, speedup % 10);
+    } else {
+        EC_MASTER_INFO(master, "Bus scanning completed in %lu ms.\n",
+                scan_jiffies * 1000 / HZ);
+    }
 
     master->scan_busy = 0;
     wake_up_interruptible(&master->scan_queue);
@@ -1155,39 +1529,100 @@ void ec_fsm_master_state_scan_slave(
 
 /*****************************************************************************/
 
-/** Master state: CONFIGURE SLAVE.
+/** Returns a slave worker, that can configure a slave.
  *
- * Starts configuring a slave.
+ * \return Idle slave worker, or NULL, if the configuration limit is reached.
  */
-void ec_fsm_master_state_configure_slave(
+ec_fsm_master_worker_t *ec_fsm_master_free_worker(
         ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
-    ec_master_t *master = fsm->master;
+    unsigned int i;
 
-    if (ec_fsm_slave_config_exec(&fsm->fsm_slave_config)) {
-        return;
+    if (fsm->configs_busy >= fsm->config_parallel) {
+        return NULL;
     }
 
-    fsm->slave->force_config = 0;
+    for (i = 0; i < fsm->worker_count; i++) {
+        if (!fsm->workers[i].slave) {
+            return &fsm->workers[i];
+        }
+    }
 
-    // configuration finished
-    master->config_busy = 0;
-    wake_up_interruptible(&master->config_queue);
+    return NULL;
+}
+
+/*****************************************************************************/
+
+/** Lets a slave worker configure a slave.
+ */
+void ec_fsm_master_worker_configure(
+        ec_fsm_master_t *fsm, /**< Master state machine. */
+        ec_fsm_master_worker_t *worker, /**< Idle slave worker. */
+        ec_slave_t *slave /**< Slave to configure. */
+        )
+{
+    ec_master_t *master = fsm->master;
+
+    down(&master->config_sem);
+    master->config_busy = 1;
+    up(&master->config_sem);
+
+    worker->slave = slave;
+    worker->configure = 1;
+    worker->jiffies_start = jiffies;
+    fsm->workers_busy++;
+    fsm->configs_busy++;
+
+    ec_fsm_slave_config_start(&worker->fsm_slave_config, slave);
+    ec_fsm_slave_config_exec(&worker->fsm_slave_config); // execute immediately
+    worker->datagram.device_index = slave->device_index;
+    worker->queue = 1;
+}
+
+/*****************************************************************************/
 
-    if (!ec_fsm_slave_config_success(&fsm->fsm_slave_config)) {
+/** A slave worker finished configuring a slave.
+ */
+void ec_fsm_master_worker_configured(
+        ec_fsm_master_t *fsm, /**< Master state machine. */
+        ec_fsm_master_worker_t *worker /**< Slave worker. */
+        )
+{
+    ec_master_t *master = fsm->master;
+
+    worker->slave->force_config = 0;
+
+    if (!ec_fsm_slave_config_success(&worker->fsm_slave_config)) {
         // TODO: mark slave_config as failed.
     }
 
-    fsm->idle = 1;
+    worker->slave = NULL;
+    fsm->workers_busy--;
+    fsm->configs_busy--;
 
-#ifdef EC_LOOP_CONTROL
-    // read DL status
-    ec_fsm_master_action_read_dl_status(fsm);
-#else
-    // process next slave
-    ec_fsm_master_action_next_slave_state(fsm);
-#endif
+    if (!fsm->configs_busy) {
+        // configuration finished
+        master->config_busy = 0;
+        wake_up_interruptible(&master->config_queue);
+    }
+}
+
+/*****************************************************************************/
+
+/** Master state: CONFIGURE SLAVE.
+ *
+ * Waits for a slave worker to configure the current slave.
+ */
+void ec_fsm_master_state_configure_slave(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    if (!ec_fsm_master_free_worker(fsm)) {
+        return;
+    }
+
+    ec_fsm_master_action_configure(fsm);
 }
 
 /*****************************************************************************/
@@ -1489,6 +1924,10 @@ void ec_fsm_master_state_sdo_dictionary(
                sdo_count, entry_count);
     }
 
+    if (ec_dict_cache_store(&master->dict_cache, slave)) {
+        EC_SLAVE_WARN(slave, "Failed to cache SDO dictionary.\n");
+    }
+
     // attach pdo names from dictionary
     ec_slave_attach_pdo_names(slave);
 
@@ -61,6 +61,35 @@ typedef struct {
 
 /*****************************************************************************/
 
+/** Maximum number of slave workers.
+ */
+#define EC_FSM_MASTER_MAX_WORKERS 16
+
+/** Slave worker.
+ *
+ * Every worker owns a datagram and the sub-state-machines needed for
+ * scanning or configuring a slave, so that several slaves can be scanned or
+ * configured at once.
+ */
+typedef struct {
+    ec_datagram_t datagram; /**< Datagram used by the worker. */
+    ec_slave_t *slave; /**< Slave being processed, or NULL. */
+    unsigned int configure; /**< The slave is configured instead of being
+                              scanned. */
+    unsigned long jiffies_start; /**< Beginning of the slave processing. */
+    unsigned int queue; /**< The datagram has to be queued. */
+
+    ec_fsm_coe_t fsm_coe; /**< CoE state machine. */
+    ec_fsm_soe_t fsm_soe; /**< SoE state machine. */
+    ec_fsm_pdo_t fsm_pdo; /**< PDO configuration state machine. */
+    ec_fsm_change_t fsm_change; /**< State change state machine. */
+    ec_fsm_slave_config_t fsm_slave_config; /**< Slave configuration state
+                                              machine. */
+    ec_fsm_slave_scan_t fsm_slave_scan; /**< Slave scanning state machine. */
+} ec_fsm_master_worker_t;
+
+/*****************************************************************************/
+
 typedef struct ec_fsm_master ec_fsm_master_t; /**< \see ec_fsm_master */
 
 /** Finite state machine of an EtherCAT master.
@@ -70,11 +99,17 @@ struct ec_fsm_master {
     ec_datagram_t *datagram; /**< datagram used in the state machine */
     unsigned int retries; /**< retries on datagram timeout. */
 
+    unsigned int queue; /**< The datagram has to be queued. */
+
     void (*state)(ec_fsm_master_t *); /**< master state function */
+    void (*resume)(ec_fsm_master_t *); /**< Action to resume with, after all
+                                         slave workers finished. */
     ec_device_index_t dev_idx; /**< Current device index (for scanning etc.).
                                 */
     int idle; /**< state machine is in idle phase */
     unsigned long scan_jiffies; /**< beginning of slave scanning */
+    unsigned long scan_busy_jiffies; /**< Sum of the single slave scan
+                                       times. */
     uint8_t link_state[EC_MAX_NUM_DEVICES]; /**< Last link state for every
                                               device. */
     unsigned int slaves_responding[EC_MAX_NUM_DEVICES]; /**< Number of
@@ -89,24 +124,31 @@ struct ec_fsm_master {
     off_t sii_index; /**< index to SII write request data */
     ec_sdo_request_t *sdo_request; /**< SDO request to process. */
 
+    ec_fsm_master_worker_t *workers; /**< Slave workers. */
+    unsigned int worker_count; /**< Number of slave workers. */
+    unsigned int scan_parallel; /**< Number of slaves to scan in parallel. */
+    unsigned int config_parallel; /**< Maximum number of slaves to configure
+                                    in parallel. */
+    unsigned int workers_busy; /**< Number of busy slave workers. */
+    unsigned int configs_busy; /**< Number of slave workers configuring a
+                                 slave. */
+
     ec_fsm_coe_t fsm_coe; /**< CoE state machine */
-    ec_fsm_soe_t fsm_soe; /**< SoE state machine */
-    ec_fsm_pdo_t fsm_pdo; /**< PDO configuration state machine. */
     ec_fsm_change_t fsm_change; /**< State change state machine */
-    ec_fsm_slave_config_t fsm_slave_config; /**< slave state machine */
-    ec_fsm_slave_scan_t fsm_slave_scan; /**< slave state machine */
     ec_fsm_sii_t fsm_sii; /**< SII state machine */
 };
 
 /*****************************************************************************/
 
-void ec_fsm_master_init(ec_fsm_master_t *, ec_master_t *, ec_datagram_t *);
+int ec_fsm_master_init(ec_fsm_master_t *, ec_master_t *, ec_datagram_t *,
+        unsigned int, unsigned int);
 void ec_fsm_master_clear(ec_fsm_master_t *);
 
 void ec_fsm_master_reset(ec_fsm_master_t *);
 
 int ec_fsm_master_exec(ec_fsm_master_t *);
 int ec_fsm_master_idle(const ec_fsm_master_t *);
+void ec_fsm_master_queue_datagrams(ec_fsm_master_t *);
 
 /*****************************************************************************/
 
@@ -52,6 +52,11 @@
  */
 #define SII_INHIBIT 5
 
+/** Size of the SII control/status and address registers, that precede the
+ * data register [byte].
+ */
+#define SII_DATA_OFFSET 6
+
 //#define SII_DEBUG
 
 /*****************************************************************************/
@@ -77,6 +82,8 @@ void ec_fsm_sii_init(ec_fsm_sii_t *fsm, /**< finite state machine */
 {
     fsm->state = NULL;
     fsm->datagram = datagram;
+    fsm->slave = NULL;
+    fsm->read_size = 4;
 }
 
 /*****************************************************************************/
@@ -101,10 +108,38 @@ void ec_fsm_sii_read(ec_fsm_sii_t *fsm, /**< finite state machine */
                      ec_fsm_sii_addressing_t mode /**< addressing scheme */
                      )
 {
+    if (slave != fsm->slave) {
+        fsm->read_size = 4;
+    }
+
     fsm->state = ec_fsm_sii_state_start_reading;
     fsm->slave = slave;
     fsm->word_offset = word_offset;
     fsm->mode = mode;
+    fsm->words = NULL;
+}
+
+/*****************************************************************************/
+
+/** Initializes the SII state machine for reading a block of words.
+ *
+ * The words are read with as few SII read operations as possible: Slaves
+ * with 64 bit read support deliver 4 words per operation. Each next read
+ * operation is issued as soon as the previous value was fetched.
+ */
+void ec_fsm_sii_read_block(
+        ec_fsm_sii_t *fsm, /**< Finite state machine. */
+        ec_slave_t *slave, /**< Slave to read from. */
+        uint16_t word_offset, /**< Offset of the first word. */
+        uint16_t *words, /**< Destination memory. */
+        size_t nwords, /**< Number of words to read. */
+        ec_fsm_sii_addressing_t mode /**< Addressing scheme. */
+        )
+{
+    ec_fsm_sii_read(fsm, slave, word_offset, mode);
+    fsm->words = words;
+    fsm->nwords = nwords;
+    fsm->words_done = 0;
 }
 
 /*****************************************************************************/
@@ -158,12 +193,9 @@ int ec_fsm_sii_success(ec_fsm_sii_t *fsm /**< Finite state machine */)
  * state functions
  *****************************************************************************/
 
-/**
-   SII state: START READING.
-   Starts reading the slave information interface.
-*/
-
-void ec_fsm_sii_state_start_reading(
+/** Prepares the datagram to initiate a read operation.
+ */
+static void ec_fsm_sii_prepare_read(
         ec_fsm_sii_t *fsm /**< finite state machine */
         )
 {
@@ -195,6 +227,20 @@ void ec_fsm_sii_state_start_reading(
 
 /*****************************************************************************/
 
+/**
+   SII state: START READING.
+   Starts reading the slave information interface.
+*/
+
+void ec_fsm_sii_state_start_reading(
+        ec_fsm_sii_t *fsm /**< finite state machine */
+        )
+{
+    ec_fsm_sii_prepare_read(fsm);
+}
+
+/*****************************************************************************/
+
 /**
    SII state: READ CHECK.
    Checks, if the SII-read-datagram has been sent and issues a fetch datagram.
@@ -229,10 +275,12 @@ void ec_fsm_sii_state_read_check(
     // issue check/fetch datagram
     switch (fsm->mode) {
         case EC_FSM_SII_USE_INCREMENT_ADDRESS:
-            ec_datagram_aprd(datagram, fsm->slave->ring_position, 0x502, 10);
+            ec_datagram_aprd(datagram, fsm->slave->ring_position, 0x502,
+                    SII_DATA_OFFSET + fsm->read_size);
             break;
         case EC_FSM_SII_USE_CONFIGURED_ADDRESS:
-            ec_datagram_fprd(datagram, fsm->slave->station_address, 0x502, 10);
+            ec_datagram_fprd(datagram, fsm->slave->station_address, 0x502,
+                    SII_DATA_OFFSET + fsm->read_size);
             break;
     }
 
@@ -274,7 +322,7 @@ void ec_fsm_sii_state_read_fetch(
 
 #ifdef SII_DEBUG
     EC_SLAVE_DBG(fsm->slave, 0, "checking SII read state:\n");
-    ec_print_data(datagram->data, 10);
+    ec_print_data(datagram->data, datagram->data_size);
 #endif
 
     if (EC_READ_U8(datagram->data + 1) & 0x20) {
@@ -305,8 +353,28 @@ void ec_fsm_sii_state_read_fetch(
         return;
     }
 
-    // SII value received.
-    memcpy(fsm->value, datagram->data + 6, 4);
+    // SII value received. The read size is signalled by the slave and
+    // used to fetch the values of all following read operations.
+    fsm->read_size = EC_READ_U8(datagram->data) & 0x40 ? 8 : 4;
+    fsm->value_size = min(fsm->read_size,
+            datagram->data_size - SII_DATA_OFFSET);
+    memcpy(fsm->value, datagram->data + SII_DATA_OFFSET, fsm->value_size);
+
+    if (fsm->words) {
+        size_t count = min(fsm->value_size / 2,
+                fsm->nwords - fsm->words_done);
+
+        memcpy(fsm->words + fsm->words_done, fsm->value, count * 2);
+        fsm->words_done += count;
+
+        if (fsm->words_done < fsm->nwords) {
+            // initiate the next read operation immediately
+            fsm->word_offset += count;
+            ec_fsm_sii_prepare_read(fsm);
+            return;
+        }
+    }
+
     fsm->state = ec_fsm_sii_state_end;
 }
 
@@ -67,7 +67,13 @@ struct ec_fsm_sii
     void (*state)(ec_fsm_sii_t *); /**< SII state function */
     uint16_t word_offset; /**< input: word offset in SII */
     ec_fsm_sii_addressing_t mode; /**< reading via APRD or NPRD */
-    uint8_t value[4]; /**< raw SII value (32bit) */
+    uint8_t value[8]; /**< raw SII value (32 or 64 bit) */
+    size_t value_size; /**< Number of bytes read into \a value. */
+    size_t read_size; /**< Read size of the slave's SII interface (4 or 8
+                        bytes, see register 0x0502 bit 6). */
+    uint16_t *words; /**< Destination of a block read, or NULL. */
+    size_t nwords; /**< Number of words to read in a block. */
+    size_t words_done; /**< Number of words read in a block. */
     unsigned long jiffies_start; /**< Start timestamp. */
     uint8_t check_once_more; /**< one more try after timeout */
 };
@@ -79,6 +85,8 @@ void ec_fsm_sii_clear(ec_fsm_sii_t *);
 
 void ec_fsm_sii_read(ec_fsm_sii_t *, ec_slave_t *,
                      uint16_t, ec_fsm_sii_addressing_t);
+void ec_fsm_sii_read_block(ec_fsm_sii_t *, ec_slave_t *, uint16_t,
+        uint16_t *, size_t, ec_fsm_sii_addressing_t);
 void ec_fsm_sii_write(ec_fsm_sii_t *, ec_slave_t *, uint16_t,
         const uint16_t *, ec_fsm_sii_addressing_t);
 
@@ -178,6 +178,31 @@ int ec_fsm_slave_is_ready(
     return fsm->state == ec_fsm_slave_state_ready;
 }
 
+/*****************************************************************************/
+
+/** Returns the class of the request, that is currently processed.
+ *
+ * \return Datagram class for the acyclic datagram scheduler.
+ */
+ec_ext_class_t ec_fsm_slave_ext_class(
+        const ec_fsm_slave_t *fsm /**< Slave state machine. */
+        )
+{
+    if (fsm->foe_request) {
+        return EC_EXT_CLASS_FOE;
+    }
+    if (fsm->soe_request) {
+        return EC_EXT_CLASS_SOE;
+    }
+    if (fsm->eoe_request) {
+        return EC_EXT_CLASS_EOE;
+    }
+    if (fsm->reg_request) {
+        return EC_EXT_CLASS_REG;
+    }
+    return EC_EXT_CLASS_COE;
+}
+
 /******************************************************************************
  * Slave state machine
  *****************************************************************************/
@@ -510,9 +535,10 @@ void ec_fsm_slave_state_foe_request(
         return;
     }
 
-    // finished transferring FoE
+    // finished transferring FoE; read data may already be drained
     EC_SLAVE_DBG(slave, 1, "Successfully transferred %zu bytes of FoE"
-            " data.\n", request->data_size);
+            " data.\n", request->dir == EC_DIR_INPUT ?
+            (size_t) fsm->fsm_foe.rx_buffer_offset : request->data_size);
 
     request->state = EC_INT_REQUEST_SUCCESS;
     wake_up_all(&slave->master->request_queue);
@@ -80,6 +80,7 @@ void ec_fsm_slave_clear(ec_fsm_slave_t *);
 int ec_fsm_slave_exec(ec_fsm_slave_t *, ec_datagram_t *);
 void ec_fsm_slave_set_ready(ec_fsm_slave_t *);
 int ec_fsm_slave_is_ready(const ec_fsm_slave_t *);
+ec_ext_class_t ec_fsm_slave_ext_class(const ec_fsm_slave_t *);
 
 /*****************************************************************************/
 
@@ -67,6 +67,7 @@ void ec_fsm_slave_config_state_clear_fmmus(ec_fsm_slave_config_t *);
 void ec_fsm_slave_config_state_clear_sync(ec_fsm_slave_config_t *);
 void ec_fsm_slave_config_state_dc_clear_assign(ec_fsm_slave_config_t *);
 void ec_fsm_slave_config_state_mbox_sync(ec_fsm_slave_config_t *);
+void ec_fsm_slave_config_state_mbox_status(ec_fsm_slave_config_t *);
 #ifdef EC_SII_ASSIGN
 void ec_fsm_slave_config_state_assign_pdi(ec_fsm_slave_config_t *);
 #endif
@@ -93,6 +94,7 @@ void ec_fsm_slave_config_enter_init(ec_fsm_slave_config_t *);
 void ec_fsm_slave_config_enter_clear_sync(ec_fsm_slave_config_t *);
 void ec_fsm_slave_config_enter_dc_clear_assign(ec_fsm_slave_config_t *);
 void ec_fsm_slave_config_enter_mbox_sync(ec_fsm_slave_config_t *);
+void ec_fsm_slave_config_enter_mbox_status(ec_fsm_slave_config_t *);
 #ifdef EC_SII_ASSIGN
 void ec_fsm_slave_config_enter_assign_pdi(ec_fsm_slave_config_t *);
 #endif
@@ -114,6 +116,8 @@ void ec_fsm_slave_config_state_error(ec_fsm_slave_config_t *);
 
 void ec_fsm_slave_config_reconfigure(ec_fsm_slave_config_t *);
 
+uint16_t ec_fsm_slave_config_boot_rx_mailbox_size(const ec_slave_t *);
+
 /*****************************************************************************/
 
 /** Constructor.
@@ -266,6 +270,8 @@ void ec_fsm_slave_config_state_init(
 
     EC_SLAVE_DBG(slave, 1, "Clearing FMMU configurations...\n");
 
+    ec_slave_mbox_set_status_fmmu(slave, 0);
+
     // clear FMMU configurations
     ec_datagram_fpwr(datagram, slave->station_address,
             0x0600, EC_FMMU_PAGE_SIZE * slave->base_fmmu_count);
@@ -420,6 +426,67 @@ void ec_fsm_slave_config_state_dc_clear_assign(
 
 /*****************************************************************************/
 
+/** Determines the size of the bootstrap receive mailbox.
+ *
+ * The size from the SII can be enlarged via the boot_mbox_size module
+ * parameter, so that FoE downloads need less packets. The mailbox is limited
+ * to the maximum datagram size and to the end of the ESC's process memory,
+ * and it must not overlap the bootstrap transmit mailbox. If the memory
+ * layout is not known, the mailbox is not enlarged.
+ *
+ * \return Size of the mailbox in byte.
+ */
+uint16_t ec_fsm_slave_config_boot_rx_mailbox_size(
+        const ec_slave_t *slave /**< EtherCAT slave. */
+        )
+{
+    const ec_sii_t *sii = &slave->sii;
+    size_t size = slave->master->boot_mbox_size;
+    size_t ram_end = EC_PROCESS_RAM_OFFSET
+        + (size_t) slave->base_ram_size * 1024;
+
+    if (size <= sii->boot_rx_mailbox_size) {
+        return sii->boot_rx_mailbox_size;
+    }
+
+    if (!slave->base_ram_size
+            || sii->boot_rx_mailbox_offset < EC_PROCESS_RAM_OFFSET
+            || sii->boot_rx_mailbox_offset + sii->boot_rx_mailbox_size
+            > ram_end
+            || !sii->boot_tx_mailbox_size
+            || (sii->boot_tx_mailbox_offset < sii->boot_rx_mailbox_offset
+                && sii->boot_tx_mailbox_offset + sii->boot_tx_mailbox_size
+                > sii->boot_rx_mailbox_offset)) {
+        EC_SLAVE_WARN(slave, "Unknown memory layout. Not enlarging"
+                " the bootstrap receive mailbox.\n");
+        return sii->boot_rx_mailbox_size;
+    }
+
+    if (size > EC_MAX_DATA_SIZE) {
+        size = EC_MAX_DATA_SIZE;
+    }
+
+    if (size > ram_end - sii->boot_rx_mailbox_offset) {
+        size = ram_end - sii->boot_rx_mailbox_offset;
+    }
+
+    if (sii->boot_tx_mailbox_offset > sii->boot_rx_mailbox_offset
+            && size > sii->boot_tx_mailbox_offset
+            - sii->boot_rx_mailbox_offset) {
+        size = sii->boot_tx_mailbox_offset - sii->boot_rx_mailbox_offset;
+    }
+
+    if (size <= sii->boot_rx_mailbox_size) {
+        return sii->boot_rx_mailbox_size;
+    }
+
+    EC_SLAVE_DBG(slave, 1, "Enlarging bootstrap receive mailbox"
+            " from %u to %zu byte.\n", sii->boot_rx_mailbox_size, size);
+    return size;
+}
+
+/*****************************************************************************/
+
 /** Check for mailbox sync managers to be configured.
  */
 void ec_fsm_slave_config_enter_mbox_sync(
@@ -453,6 +520,7 @@ void ec_fsm_slave_config_enter_mbox_sync(
 
     if (slave->requested_state == EC_SLAVE_STATE_BOOT) {
         ec_sync_t sync;
+        uint16_t rx_size = ec_fsm_slave_config_boot_rx_mailbox_size(slave);
 
         ec_datagram_fpwr(datagram, slave->station_address, 0x0800,
                 EC_SYNC_PAGE_SIZE * 2);
@@ -462,14 +530,13 @@ void ec_fsm_slave_config_enter_mbox_sync(
         sync.physical_start_address = slave->sii.boot_rx_mailbox_offset;
         sync.control_register = 0x26;
         sync.enable = 1;
-        ec_sync_page(&sync, 0, slave->sii.boot_rx_mailbox_size,
+        ec_sync_page(&sync, 0, rx_size,
                 EC_DIR_INVALID, // use default direction
                 0, // no PDO xfer
                 datagram->data);
         slave->configured_rx_mailbox_offset =
             slave->sii.boot_rx_mailbox_offset;
-        slave->configured_rx_mailbox_size =
-            slave->sii.boot_rx_mailbox_size;
+        slave->configured_rx_mailbox_size = rx_size;
 
         ec_sync_init(&sync, slave);
         sync.physical_start_address = slave->sii.boot_tx_mailbox_offset;
@@ -608,6 +675,69 @@ void ec_fsm_slave_config_state_mbox_sync(
         return;
     }
 
+    ec_fsm_slave_config_enter_mbox_status(fsm);
+}
+
+/*****************************************************************************/
+
+/** Map the mailbox state into the master's mailbox status area.
+ */
+void ec_fsm_slave_config_enter_mbox_status(
+        ec_fsm_slave_config_t *fsm /**< slave state machine */
+        )
+{
+    ec_datagram_t *datagram = fsm->datagram;
+    ec_slave_t *slave = fsm->slave;
+    uint8_t fmmu_index;
+
+    if (!ec_slave_mbox_status_possible(slave)) {
+#ifdef EC_SII_ASSIGN
+        ec_fsm_slave_config_enter_assign_pdi(fsm);
+#else
+        ec_fsm_slave_config_enter_boot_preop(fsm);
+#endif
+        return;
+    }
+
+    fmmu_index = ec_slave_mbox_status_fmmu_index(slave);
+    EC_SLAVE_DBG(slave, 1, "Mapping mailbox state with FMMU %u...\n",
+            fmmu_index);
+
+    ec_datagram_fpwr(datagram, slave->station_address,
+            0x0600 + EC_FMMU_PAGE_SIZE * fmmu_index, EC_FMMU_PAGE_SIZE);
+    ec_slave_mbox_status_page(slave, datagram->data);
+    fsm->retries = EC_FSM_RETRIES;
+    fsm->state = ec_fsm_slave_config_state_mbox_status;
+}
+
+/*****************************************************************************/
+
+/** Slave configuration state: MBOX STATUS.
+ *
+ * A failure is not fatal, the mailbox state is polled directly then.
+ */
+void ec_fsm_slave_config_state_mbox_status(
+        ec_fsm_slave_config_t *fsm /**< slave state machine */
+        )
+{
+    ec_datagram_t *datagram = fsm->datagram;
+    ec_slave_t *slave = fsm->slave;
+
+    if (datagram->state == EC_DATAGRAM_TIMED_OUT && fsm->retries--) {
+        return;
+    }
+
+    if (datagram->state != EC_DATAGRAM_RECEIVED) {
+        EC_SLAVE_WARN(slave, "Failed to receive mailbox status"
+                " FMMU datagram: ");
+        ec_datagram_print_state(datagram);
+    } else if (datagram->working_counter != 1) {
+        EC_SLAVE_WARN(slave, "Failed to set mailbox status FMMU: ");
+        ec_datagram_print_wc_error(datagram);
+    } else {
+        ec_slave_mbox_set_status_fmmu(slave, 1);
+    }
+
 #ifdef EC_SII_ASSIGN
     ec_fsm_slave_config_enter_assign_pdi(fsm);
 #else
@@ -1233,6 +1363,17 @@ void ec_fsm_slave_config_enter_fmmu(
                 datagram->data + EC_FMMU_PAGE_SIZE * i);
     }
 
+    // keep the mailbox status FMMU, if it is not needed for process data
+    if (slave->mbox_status_fmmu) {
+        if (ec_slave_mbox_status_possible(slave)) {
+            i = ec_slave_mbox_status_fmmu_index(slave);
+            ec_slave_mbox_status_page(slave,
+                    datagram->data + EC_FMMU_PAGE_SIZE * i);
+        } else {
+            ec_slave_mbox_set_status_fmmu(slave, 0);
+        }
+    }
+
     fsm->retries = EC_FSM_RETRIES;
     fsm->state = ec_fsm_slave_config_state_fmmu;
 }
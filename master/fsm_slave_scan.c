@@ -53,6 +53,7 @@ void ec_fsm_slave_scan_state_datalink(ec_fsm_slave_scan_t *);
 #ifdef EC_SII_ASSIGN
 void ec_fsm_slave_scan_state_assign_sii(ec_fsm_slave_scan_t *);
 #endif
+void ec_fsm_slave_scan_state_sii_identity(ec_fsm_slave_scan_t *);
 void ec_fsm_slave_scan_state_sii_size(ec_fsm_slave_scan_t *);
 void ec_fsm_slave_scan_state_sii_data(ec_fsm_slave_scan_t *);
 #ifdef EC_REGALIAS
@@ -66,6 +67,7 @@ void ec_fsm_slave_scan_state_end(ec_fsm_slave_scan_t *);
 void ec_fsm_slave_scan_state_error(ec_fsm_slave_scan_t *);
 
 void ec_fsm_slave_scan_enter_datalink(ec_fsm_slave_scan_t *);
+void ec_fsm_slave_scan_evaluate_sii(ec_fsm_slave_scan_t *);
 #ifdef EC_REGALIAS
 void ec_fsm_slave_scan_enter_regalias(ec_fsm_slave_scan_t *);
 #endif
@@ -314,6 +316,8 @@ void ec_fsm_slave_scan_state_base(
         slave->base_sync_count = EC_MAX_SYNC_MANAGERS;
     }
 
+    slave->base_ram_size = EC_READ_U8(datagram->data + 6);
+
     octet = EC_READ_U8(datagram->data + 7);
     for (i = 0; i < EC_MAX_PORTS; i++) {
         slave->ports[i].desc = (octet >> (2 * i)) & 0x03;
@@ -442,6 +446,24 @@ void ec_fsm_slave_scan_enter_datalink(
 
 /*****************************************************************************/
 
+/** Enter slave scan state SII_IDENTITY.
+ */
+void ec_fsm_slave_scan_enter_sii_identity(
+        ec_fsm_slave_scan_t *fsm /**< slave state machine */
+        )
+{
+    // Start fetching the identity words to look up the SII image cache
+
+    fsm->sii_identity_valid = 0;
+    ec_fsm_sii_read_block(&fsm->fsm_sii, fsm->slave, 0x0000,
+            fsm->sii_identity, EC_SII_IDENTITY_WORDS,
+            EC_FSM_SII_USE_CONFIGURED_ADDRESS);
+    fsm->state = ec_fsm_slave_scan_state_sii_identity;
+    fsm->state(fsm); // execute state immediately
+}
+
+/*****************************************************************************/
+
 /** Enter slave scan state SII_SIZE.
  */
 void ec_fsm_slave_scan_enter_sii_size(
@@ -517,7 +539,7 @@ void ec_fsm_slave_scan_state_datalink(
 #ifdef EC_SII_ASSIGN
     ec_fsm_slave_scan_enter_assign_sii(fsm);
 #else
-    ec_fsm_slave_scan_enter_sii_size(fsm);
+    ec_fsm_slave_scan_enter_sii_identity(fsm);
 #endif
 }
 
@@ -544,7 +566,7 @@ void ec_fsm_slave_scan_state_assign_sii(
         EC_SLAVE_WARN(slave, "Failed to receive SII assignment datagram: ");
         ec_datagram_print_state(datagram);
         // Try to go on, probably assignment is correct
-        goto continue_with_sii_size;
+        goto continue_with_sii;
     }
 
     if (datagram->working_counter != 1) {
@@ -553,14 +575,85 @@ void ec_fsm_slave_scan_state_assign_sii(
         // Try to go on, probably assignment is correct
     }
 
-continue_with_sii_size:
-    ec_fsm_slave_scan_enter_sii_size(fsm);
+continue_with_sii:
+    ec_fsm_slave_scan_enter_sii_identity(fsm);
 }
 
 #endif
 
 /*****************************************************************************/
 
+/** Allocates memory for the SII contents of the slave.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static int ec_fsm_slave_scan_alloc_sii(
+        ec_fsm_slave_scan_t *fsm /**< slave state machine */
+        )
+{
+    ec_slave_t *slave = fsm->slave;
+
+    if (slave->sii_words) {
+        EC_SLAVE_WARN(slave, "Freeing old SII data...\n");
+        kfree(slave->sii_words);
+    }
+
+    if (!(slave->sii_words =
+                (uint16_t *) kmalloc(slave->sii_nwords * 2, GFP_KERNEL))) {
+        EC_SLAVE_ERR(slave, "Failed to allocate %zu words of SII data.\n",
+               slave->sii_nwords);
+        slave->sii_nwords = 0;
+        slave->error_flag = 1;
+        fsm->state = ec_fsm_slave_scan_state_error;
+        return -ENOMEM;
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+
+/**
+   Slave scan state: SII IDENTITY.
+*/
+
+void ec_fsm_slave_scan_state_sii_identity(
+        ec_fsm_slave_scan_t *fsm /**< slave state machine */
+        )
+{
+    ec_slave_t *slave = fsm->slave;
+    const ec_sii_image_t *image;
+
+    if (ec_fsm_sii_exec(&fsm->fsm_sii))
+        return;
+
+    if (!ec_fsm_sii_success(&fsm->fsm_sii)) {
+        // determining the SII size will report the error
+        ec_fsm_slave_scan_enter_sii_size(fsm);
+        return;
+    }
+
+    image = ec_sii_cache_find(&slave->master->sii_cache, fsm->sii_identity);
+    if (!image) {
+        fsm->sii_identity_valid = 1;
+        ec_fsm_slave_scan_enter_sii_size(fsm);
+        return;
+    }
+
+    EC_SLAVE_DBG(slave, 1, "Taking %zu words of SII data from the cache.\n",
+            image->nwords);
+
+    slave->sii_nwords = image->nwords;
+    if (ec_fsm_slave_scan_alloc_sii(fsm)) {
+        return;
+    }
+    memcpy(slave->sii_words, image->words, image->nwords * 2);
+
+    ec_fsm_slave_scan_evaluate_sii(fsm);
+}
+
+/*****************************************************************************/
+
 /**
    Slave scan state: SII SIZE.
 */
@@ -607,26 +700,25 @@ void ec_fsm_slave_scan_state_sii_size(
     slave->sii_nwords = fsm->sii_offset + 1;
 
 alloc_sii:
-    if (slave->sii_words) {
-        EC_SLAVE_WARN(slave, "Freeing old SII data...\n");
-        kfree(slave->sii_words);
-    }
-
-    if (!(slave->sii_words =
-                (uint16_t *) kmalloc(slave->sii_nwords * 2, GFP_KERNEL))) {
-        EC_SLAVE_ERR(slave, "Failed to allocate %zu words of SII data.\n",
-               slave->sii_nwords);
-        slave->sii_nwords = 0;
-        slave->error_flag = 1;
-        fsm->state = ec_fsm_slave_scan_state_error;
+    if (ec_fsm_slave_scan_alloc_sii(fsm)) {
         return;
     }
 
     // Start fetching SII contents
 
+    if (fsm->sii_identity_valid) {
+        // the identity words are already known
+        memcpy(slave->sii_words, fsm->sii_identity,
+                sizeof(fsm->sii_identity));
+        fsm->sii_offset = EC_SII_IDENTITY_WORDS;
+    } else {
+        fsm->sii_offset = 0x0000;
+    }
+
     fsm->state = ec_fsm_slave_scan_state_sii_data;
-    fsm->sii_offset = 0x0000;
-    ec_fsm_sii_read(&fsm->fsm_sii, slave, fsm->sii_offset,
+    ec_fsm_sii_read_block(&fsm->fsm_sii, slave, fsm->sii_offset,
+            slave->sii_words + fsm->sii_offset,
+            slave->sii_nwords - fsm->sii_offset,
             EC_FSM_SII_USE_CONFIGURED_ADDRESS);
     ec_fsm_sii_exec(&fsm->fsm_sii); // execute state immediately
 }
@@ -640,7 +732,6 @@ alloc_sii:
 void ec_fsm_slave_scan_state_sii_data(ec_fsm_slave_scan_t *fsm /**< slave state machine */)
 {
     ec_slave_t *slave = fsm->slave;
-    uint16_t *cat_word, cat_type, cat_size;
 
     if (ec_fsm_sii_exec(&fsm->fsm_sii)) return;
 
@@ -651,22 +742,25 @@ void ec_fsm_slave_scan_state_sii_data(ec_fsm_slave_scan_t *fsm /**< slave state
         return;
     }
 
-    // 2 words fetched
-
-    if (fsm->sii_offset + 2 <= slave->sii_nwords) { // 2 words fit
-        memcpy(slave->sii_words + fsm->sii_offset, fsm->fsm_sii.value, 4);
-    } else { // copy the last word
-        memcpy(slave->sii_words + fsm->sii_offset, fsm->fsm_sii.value, 2);
+    // an incompletely read image must not be cached
+    if (!slave->error_flag && ec_sii_cache_add(&slave->master->sii_cache,
+                slave->sii_words, slave->sii_nwords)) {
+        EC_SLAVE_WARN(slave, "Failed to cache SII data.\n");
     }
 
-    if (fsm->sii_offset + 2 < slave->sii_nwords) {
-        // fetch the next 2 words
-        fsm->sii_offset += 2;
-        ec_fsm_sii_read(&fsm->fsm_sii, slave, fsm->sii_offset,
-                        EC_FSM_SII_USE_CONFIGURED_ADDRESS);
-        ec_fsm_sii_exec(&fsm->fsm_sii); // execute state immediately
-        return;
-    }
+    ec_fsm_slave_scan_evaluate_sii(fsm);
+}
+
+/*****************************************************************************/
+
+/** Evaluates the SII contents and continues scanning.
+ */
+void ec_fsm_slave_scan_evaluate_sii(
+        ec_fsm_slave_scan_t *fsm /**< slave state machine */
+        )
+{
+    ec_slave_t *slave = fsm->slave;
+    uint16_t *cat_word, cat_type, cat_size;
 
     // Evaluate SII contents
 
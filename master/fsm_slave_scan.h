@@ -44,6 +44,7 @@
 #include "fsm_change.h"
 #include "fsm_coe.h"
 #include "fsm_pdo.h"
+#include "sii_cache.h"
 
 /*****************************************************************************/
 
@@ -63,6 +64,8 @@ struct ec_fsm_slave_scan
 
     void (*state)(ec_fsm_slave_scan_t *); /**< State function. */
     uint16_t sii_offset; /**< SII offset in words. */
+    uint16_t sii_identity[EC_SII_IDENTITY_WORDS]; /**< SII identity words. */
+    unsigned int sii_identity_valid; /**< The identity words were read. */
 
     ec_fsm_sii_t fsm_sii; /**< SII state machine. */
 };
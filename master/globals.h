@@ -106,6 +106,9 @@
 /** Size of a sync manager configuration page. */
 #define EC_SYNC_PAGE_SIZE 8
 
+/** Physical start address of the ESC process memory. */
+#define EC_PROCESS_RAM_OFFSET 0x1000
+
 /** Maximum number of FMMUs per slave. */
 #define EC_MAX_FMMUS 16
 
@@ -220,6 +223,47 @@ typedef enum {
 
 extern const char *ec_device_names[2]; // only main and backup!
 
+/** Number of buckets of a round-trip time histogram.
+ *
+ * Bucket \a i counts the round-trip times from 2^i to 2^(i + 1) - 1 ns
+ * (bucket 0 also counts zero).
+ */
+#define EC_LATENCY_BUCKETS 32
+
+/** Round-trip time statistics.
+ *
+ * The round-trip time of a datagram is measured from sending to the device
+ * poll, that received it.
+ */
+typedef struct {
+    uint64_t count; /**< Number of datagrams measured. */
+    uint64_t sum; /**< Sum of the round-trip times [ns]. */
+    uint32_t min; /**< Minimum round-trip time [ns]. */
+    uint32_t max; /**< Maximum round-trip time [ns]. */
+    uint64_t buckets[EC_LATENCY_BUCKETS]; /**< Logarithmic histogram. */
+} ec_latency_t;
+
+/** Classes of acyclic datagrams.
+ *
+ * The acyclic datagram scheduler keeps a separate queue for each class.
+ */
+typedef enum {
+    EC_EXT_CLASS_COE, /**< CoE (SDO) transfers. */
+    EC_EXT_CLASS_FOE, /**< FoE transfers. */
+    EC_EXT_CLASS_SOE, /**< SoE transfers. */
+    EC_EXT_CLASS_EOE, /**< EoE parameter requests. */
+    EC_EXT_CLASS_REG, /**< Register requests. */
+    EC_EXT_CLASS_COUNT /**< Number of classes. */
+} ec_ext_class_t;
+
+/** Statistics of an acyclic datagram queue.
+ */
+typedef struct {
+    uint32_t depth; /**< Number of waiting datagrams. */
+    uint32_t max_depth; /**< Maximum number of waiting datagrams. */
+    ec_latency_t wait; /**< Times from queuing to injection [ns]. */
+} ec_ext_queue_stats_t;
+
 /*****************************************************************************/
 
 /** Convenience macro for printing EtherCAT-specific information to syslog.
@@ -122,6 +122,12 @@ static ATTRIBUTES int ec_ioctl_master(
     io.phase = (uint8_t) master->phase;
     io.active = (uint8_t) master->active;
     io.scan_busy = master->scan_busy;
+    io.sii_cache_count = master->sii_cache.count;
+    io.dict_cache_count = master->dict_cache.count;
+    io.ext_datagram_count = master->ext_datagram_count;
+    for (j = 0; j < EC_EXT_CLASS_COUNT; j++) {
+        io.ext_queues[j] = master->ext_scheduler.queues[j].stats;
+    }
 
     up(&master->master_sem);
 
@@ -147,6 +153,10 @@ static ATTRIBUTES int ec_ioctl_master(
         io.devices[dev_idx].tx_bytes = device->tx_bytes;
         io.devices[dev_idx].rx_bytes = device->rx_bytes;
         io.devices[dev_idx].tx_errors = device->tx_errors;
+        io.devices[dev_idx].tx_bursts = device->tx_bursts;
+        io.devices[dev_idx].last_tx_burst = device->last_tx_burst;
+        io.devices[dev_idx].max_tx_burst = device->max_tx_burst;
+        io.devices[dev_idx].latency = device->latency;
         for (j = 0; j < EC_RATE_COUNT; j++) {
             io.devices[dev_idx].tx_frame_rates[j] =
                 device->tx_frame_rates[j];
@@ -182,6 +192,9 @@ static ATTRIBUTES int ec_ioctl_master(
     io.app_time = master->app_time;
     io.ref_clock =
         master->dc_ref_clock ? master->dc_ref_clock->ring_position : 0xffff;
+    io.pack_frames = master->pack_frames;
+    io.cycle_frames = master->cycle_frames;
+    io.max_cycle_frames = master->max_cycle_frames;
 
     if (copy_to_user((void __user *) arg, &io, sizeof(io))) {
         return -EFAULT;
@@ -494,6 +507,7 @@ static ATTRIBUTES int ec_ioctl_domain(
     }
     data.expected_working_counter = domain->expected_working_counter;
     data.fmmu_count = ec_domain_fmmu_count(domain);
+    data.latency = domain->latency;
 
     up(&master->master_sem);
 
@@ -631,6 +645,30 @@ static ATTRIBUTES int ec_ioctl_master_rescan(
 
 /*****************************************************************************/
 
+/** Reset the round-trip time statistics of all devices and domains and the
+ * wait time statistics of the acyclic datagram queues.
+ *
+ * The reset is executed by the realtime context (see
+ * ec_master_reset_latency()).
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_reset_latency(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg /**< ioctl() argument. */
+        )
+{
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    ec_master_reset_latency(master);
+
+    up(&master->master_sem);
+    return 0;
+}
+
+/*****************************************************************************/
+
 /** Set slave state.
  *
  * \return Zero on success, otherwise a negative error code.
@@ -818,9 +856,15 @@ static ATTRIBUTES int ec_ioctl_slave_sdo_upload(
         return -ENOMEM;
     }
 
-    ret = ecrt_master_sdo_upload(master, data.slave_position,
-            data.sdo_index, data.sdo_entry_subindex, target,
-            data.target_size, &data.data_size, &data.abort_code);
+    if (data.complete_access) {
+        ret = ecrt_master_sdo_upload_complete(master, data.slave_position,
+                data.sdo_index, target, data.target_size, &data.data_size,
+                &data.abort_code);
+    } else {
+        ret = ecrt_master_sdo_upload(master, data.slave_position,
+                data.sdo_index, data.sdo_entry_subindex, target,
+                data.target_size, &data.data_size, &data.abort_code);
+    }
 
     if (!ret) {
         if (copy_to_user((void __user *) data.target,
@@ -1025,6 +1069,263 @@ static ATTRIBUTES int ec_ioctl_slave_sii_write(
 
 /*****************************************************************************/
 
+/** Get a cached SII image.
+ *
+ * The image is copied, if the buffer is large enough. The size of the image
+ * is returned in any case.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_sii_cache(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg /**< ioctl() argument. */
+        )
+{
+    ec_ioctl_sii_image_t data;
+    const ec_sii_image_t *image;
+    int retval = 0;
+
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
+        return -EFAULT;
+    }
+
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    if (!(image = ec_sii_cache_get(&master->sii_cache, data.index))) {
+        up(&master->master_sem);
+        EC_MASTER_ERR(master, "SII image %u does not exist!\n", data.index);
+        return -EINVAL;
+    }
+
+    if (data.words && data.nwords >= image->nwords
+            && copy_to_user((void __user *) data.words, image->words,
+                image->nwords * sizeof(uint16_t))) {
+        retval = -EFAULT;
+    }
+
+    data.nwords = image->nwords;
+    data.vendor_id = image->vendor_id;
+    data.product_code = image->product_code;
+    data.revision_number = image->revision_number;
+    data.serial_number = image->serial_number;
+
+    up(&master->master_sem);
+
+    if (!retval && copy_to_user((void __user *) arg, &data, sizeof(data))) {
+        retval = -EFAULT;
+    }
+
+    return retval;
+}
+
+/*****************************************************************************/
+
+/** Add an image to the SII cache.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_sii_cache_add(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg /**< ioctl() argument. */
+        )
+{
+    ec_ioctl_sii_image_t data;
+    unsigned int byte_size;
+    uint16_t *words;
+    int ret;
+
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
+        return -EFAULT;
+    }
+
+    if (data.nwords < EC_SII_IDENTITY_WORDS
+            || data.nwords > EC_MAX_SII_SIZE) {
+        EC_MASTER_ERR(master, "Invalid SII image size %u!\n", data.nwords);
+        return -EINVAL;
+    }
+
+    byte_size = sizeof(uint16_t) * data.nwords;
+    if (!(words = kmalloc(byte_size, GFP_KERNEL))) {
+        EC_MASTER_ERR(master, "Failed to allocate %u bytes"
+                " for SII contents.\n", byte_size);
+        return -ENOMEM;
+    }
+
+    if (copy_from_user(words, (void __user *) data.words, byte_size)) {
+        kfree(words);
+        return -EFAULT;
+    }
+
+    if (down_interruptible(&master->master_sem)) {
+        kfree(words);
+        return -EINTR;
+    }
+
+    ret = ec_sii_cache_add(&master->sii_cache, words, data.nwords);
+
+    up(&master->master_sem);
+    kfree(words);
+    return ret;
+}
+
+/*****************************************************************************/
+
+/** Clear the SII cache.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_sii_cache_clear(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg /**< ioctl() argument. */
+        )
+{
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    ec_sii_cache_clear(&master->sii_cache);
+
+    up(&master->master_sem);
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** Get a cached SDO dictionary.
+ *
+ * The serialized dictionary is copied, if the buffer is large enough. Its
+ * size is returned in any case.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_dict_cache(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg /**< ioctl() argument. */
+        )
+{
+    ec_ioctl_dict_t data;
+    const ec_dict_t *dict;
+    uint8_t *buffer;
+    size_t size;
+    int retval = 0;
+
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
+        return -EFAULT;
+    }
+
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    if (!(dict = ec_dict_cache_get(&master->dict_cache, data.index))) {
+        up(&master->master_sem);
+        EC_MASTER_ERR(master, "SDO dictionary %u does not exist!\n",
+                data.index);
+        return -EINVAL;
+    }
+
+    size = ec_dict_serialize(dict, NULL);
+
+    if (data.data && data.size >= size && size) {
+        if (!(buffer = vmalloc(size))) {
+            up(&master->master_sem);
+            EC_MASTER_ERR(master, "Failed to allocate %zu bytes"
+                    " for SDO dictionary.\n", size);
+            return -ENOMEM;
+        }
+
+        ec_dict_serialize(dict, buffer);
+        if (copy_to_user((void __user *) data.data, buffer, size)) {
+            retval = -EFAULT;
+        }
+        vfree(buffer);
+    }
+
+    data.size = size;
+    data.vendor_id = dict->vendor_id;
+    data.product_code = dict->product_code;
+    data.revision_number = dict->revision_number;
+    data.sdo_count = dict->sdo_count;
+
+    up(&master->master_sem);
+
+    if (!retval && copy_to_user((void __user *) arg, &data, sizeof(data))) {
+        retval = -EFAULT;
+    }
+
+    return retval;
+}
+
+/*****************************************************************************/
+
+/** Add a serialized SDO dictionary to the cache.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_dict_cache_add(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg /**< ioctl() argument. */
+        )
+{
+    ec_ioctl_dict_t data;
+    uint8_t *buffer = NULL;
+    int ret;
+
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
+        return -EFAULT;
+    }
+
+    if (data.size) {
+        if (!(buffer = vmalloc(data.size))) {
+            EC_MASTER_ERR(master, "Failed to allocate %u bytes"
+                    " for SDO dictionary.\n", data.size);
+            return -ENOMEM;
+        }
+
+        if (copy_from_user(buffer, (void __user *) data.data, data.size)) {
+            vfree(buffer);
+            return -EFAULT;
+        }
+    }
+
+    if (down_interruptible(&master->master_sem)) {
+        vfree(buffer);
+        return -EINTR;
+    }
+
+    ret = ec_dict_cache_load(&master->dict_cache, data.vendor_id,
+            data.product_code, data.revision_number, buffer, data.size);
+
+    up(&master->master_sem);
+    vfree(buffer);
+
+    if (ret == -EINVAL) {
+        EC_MASTER_ERR(master, "Invalid SDO dictionary data!\n");
+    }
+    return ret;
+}
+
+/*****************************************************************************/
+
+/** Clear the SDO dictionary cache.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_dict_cache_clear(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg /**< ioctl() argument. */
+        )
+{
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    ec_dict_cache_clear(&master->dict_cache);
+
+    up(&master->master_sem);
+    return 0;
+}
+
+/*****************************************************************************/
+
 /** Read a slave's registers.
  *
  * \return Zero on success, otherwise a negative error code.
@@ -1782,6 +2083,8 @@ static ATTRIBUTES int ec_ioctl_activate(
     ec_ioctl_master_activate_t io;
     ec_domain_t *domain;
     off_t offset;
+    unsigned int domain_count, config_count;
+    size_t changes_size = 0;
     int ret;
 
     if (unlikely(!ctx->requested))
@@ -1798,10 +2101,23 @@ static ATTRIBUTES int ec_ioctl_activate(
 
     list_for_each_entry(domain, &master->domains, list) {
         ctx->process_data_size += ecrt_domain_size(domain);
+        if (domain->track_changes) {
+            changes_size +=
+                EC_DOMAIN_CHANGES_SIZE(ecrt_domain_size(domain));
+        }
     }
 
+    domain_count = ec_master_domain_count(master);
+    config_count = ec_master_config_count(master);
+
     up(&master->master_sem);
 
+    /* The status area starts on a separate page behind the process data.
+     * It is followed by the change bitmaps. */
+    io.status_offset = PAGE_ALIGN(ctx->process_data_size);
+    ctx->process_data_size = io.status_offset
+        + EC_IOCTL_STATUS_SIZE(domain_count, config_count) + changes_size;
+
     if (ctx->process_data_size) {
         ctx->process_data = vmalloc(ctx->process_data_size);
         if (!ctx->process_data) {
@@ -1809,6 +2125,10 @@ static ATTRIBUTES int ec_ioctl_activate(
             return -ENOMEM;
         }
 
+        ec_master_set_status(master,
+                (ec_ioctl_status_t *) (ctx->process_data + io.status_offset),
+                domain_count, config_count);
+
         /* Set the memory as external process data memory for the
          * domains.
          */
@@ -1819,6 +2139,18 @@ static ATTRIBUTES int ec_ioctl_activate(
             offset += ecrt_domain_size(domain);
         }
 
+        offset = io.status_offset
+            + EC_IOCTL_STATUS_SIZE(domain_count, config_count);
+        list_for_each_entry(domain, &master->domains, list) {
+            if (!domain->track_changes || domain->index >= domain_count) {
+                continue;
+            }
+            ec_domain_changes_memory(domain, ctx->process_data + offset);
+            EC_IOCTL_STATUS_DOMAINS(master->status)[domain->index]
+                .changes_offset = offset;
+            offset += EC_DOMAIN_CHANGES_SIZE(ecrt_domain_size(domain));
+        }
+
 #ifdef EC_IOCTL_RTDM
         /* RTDM uses a different approach for memory-mapping, which has to be
          * initiated by the kernel.
@@ -1903,71 +2235,201 @@ static ATTRIBUTES int ec_ioctl_set_send_interval(
 
 /*****************************************************************************/
 
-/** Send frames.
+/** Freeze the frame layout of the domain datagrams.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_send(
+static ATTRIBUTES int ec_ioctl_freeze_layout(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    size_t sent_bytes;
+    uint32_t freeze;
+    int ret;
 
     if (unlikely(!ctx->requested)) {
         return -EPERM;
     }
 
-    sent_bytes = ecrt_master_send(master);
-
-    if (copy_to_user((void __user *) arg, &sent_bytes, sizeof(sent_bytes))) {
+    if (get_user(freeze, (uint32_t __user *) arg)) {
         return -EFAULT;
     }
 
-    return 0;
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    ret = ecrt_master_freeze_layout(master, freeze != 0);
+
+    up(&master->master_sem);
+    return ret;
 }
 
 /*****************************************************************************/
 
-/** Receive frames.
+/** Select frame packing.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_receive(
+static ATTRIBUTES int ec_ioctl_pack_frames(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
+    uint32_t pack;
+    int ret;
+
     if (unlikely(!ctx->requested)) {
         return -EPERM;
     }
 
-    ecrt_master_receive(master);
-    return 0;
+    if (get_user(pack, (uint32_t __user *) arg)) {
+        return -EFAULT;
+    }
+
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    ret = ecrt_master_pack_frames(master, pack != 0);
+
+    up(&master->master_sem);
+    return ret;
 }
 
 /*****************************************************************************/
 
-/** Get the master state.
+/** Send frames.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_master_state(
+static ATTRIBUTES int ec_ioctl_send(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_master_state_t data;
+    size_t sent_bytes;
 
-    ecrt_master_state(master, &data);
+    if (unlikely(!ctx->requested)) {
+        return -EPERM;
+    }
 
-    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
-        return -EFAULT;
+    sent_bytes = ecrt_master_send(master);
 
-    return 0;
+    if (copy_to_user((void __user *) arg, &sent_bytes, sizeof(sent_bytes))) {
+        return -EFAULT;
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** Receive frames.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_receive(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    if (unlikely(!ctx->requested)) {
+        return -EPERM;
+    }
+
+    ecrt_master_receive(master);
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** Execute several steps of a realtime cycle.
+ *
+ * The domain pointers and states are kept in the file handle's context to
+ * keep them off the kernel stack.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_cycle(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    ec_ioctl_cycle_t data;
+    ec_domain_t **domains = ctx->cycle_domains;
+    ec_domain_state_t *states = ctx->cycle_states;
+    ec_cycle_t cycle;
+    unsigned int i;
+    int ret;
+
+    if (unlikely(!ctx->requested)) {
+        return -EPERM;
+    }
+
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
+        return -EFAULT;
+    }
+
+    if (data.domain_count > EC_CYCLE_MAX_DOMAINS) {
+        return -EINVAL;
+    }
+
+    /* no locking of master_sem needed, because domains will not be deleted
+     * in the meantime. */
+
+    for (i = 0; i < data.domain_count; i++) {
+        domains[i] = ec_master_find_domain(master, data.domain_indices[i]);
+        if (!domains[i]) {
+            return -ENOENT;
+        }
+    }
+
+    cycle.steps = data.steps;
+    cycle.app_time = data.app_time;
+    cycle.domains = domains;
+    cycle.domain_count = data.domain_count;
+    cycle.domain_states = data.domain_states ? states : NULL;
+
+    ret = ecrt_master_cycle(master, &cycle);
+    if (ret < 0) {
+        return ret;
+    }
+
+    if ((data.steps & EC_CYCLE_DOMAIN_STATE) && data.domain_states
+            && data.domain_count) {
+        if (copy_to_user((void __user *) data.domain_states, states,
+                    data.domain_count * sizeof(states[0]))) {
+            return -EFAULT;
+        }
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** Get the master state.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_master_state(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    ec_master_state_t data;
+
+    ecrt_master_state(master, &data);
+
+    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
+        return -EFAULT;
+
+    return 0;
 }
 
 /*****************************************************************************/
@@ -3169,6 +3631,50 @@ static ATTRIBUTES int ec_ioctl_domain_queue(
 
 /*****************************************************************************/
 
+/** Queue the domains due in the current cycle.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_queue_domains(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    if (unlikely(!ctx->requested))
+        return -EPERM;
+
+    /* no locking of master_sem needed, because domains will not be deleted
+     * in the meantime. */
+
+    ecrt_master_queue_domains(master);
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** Process the domains queued with ecrt_master_queue_domains().
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_process_domains(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    if (unlikely(!ctx->requested))
+        return -EPERM;
+
+    /* no locking of master_sem needed, because domains will not be deleted
+     * in the meantime. */
+
+    ecrt_master_process_domains(master);
+    return 0;
+}
+
+/*****************************************************************************/
+
 /** Get the domain state.
  *
  * \return Zero on success, otherwise a negative error code.
@@ -3207,6 +3713,154 @@ static ATTRIBUTES int ec_ioctl_domain_state(
 
 /*****************************************************************************/
 
+/** Selects the memory mode of a domain.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_domain_memory(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    ec_ioctl_domain_memory_t data;
+    ec_domain_t *domain;
+    int ret;
+
+    if (unlikely(!ctx->requested))
+        return -EPERM;
+
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
+        return -EFAULT;
+    }
+
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    if (!(domain = ec_master_find_domain(master, data.domain_index))) {
+        up(&master->master_sem);
+        return -ENOENT;
+    }
+
+    ret = ecrt_domain_memory_mode(domain, data.mode);
+
+    up(&master->master_sem);
+    return ret;
+}
+
+/*****************************************************************************/
+
+/** Sets the process data layout of a domain.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_domain_layout(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    ec_ioctl_domain_layout_t data;
+    ec_domain_t *domain;
+    int ret;
+
+    if (unlikely(!ctx->requested))
+        return -EPERM;
+
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
+        return -EFAULT;
+    }
+
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    if (!(domain = ec_master_find_domain(master, data.domain_index))) {
+        up(&master->master_sem);
+        return -ENOENT;
+    }
+
+    ret = ecrt_domain_layout(domain, data.layout);
+
+    up(&master->master_sem);
+    return ret;
+}
+
+/*****************************************************************************/
+
+/** Sets the cycle divisor and phase of a domain.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_domain_cycle(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    ec_ioctl_domain_cycle_t data;
+    ec_domain_t *domain;
+    int ret;
+
+    if (unlikely(!ctx->requested))
+        return -EPERM;
+
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
+        return -EFAULT;
+    }
+
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    if (!(domain = ec_master_find_domain(master, data.domain_index))) {
+        up(&master->master_sem);
+        return -ENOENT;
+    }
+
+    ret = ecrt_domain_set_cycle_divisor(domain, data.divisor, data.phase);
+
+    up(&master->master_sem);
+    return ret;
+}
+
+/*****************************************************************************/
+
+/** Enables the input change detection of a domain.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_domain_changes(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    ec_ioctl_domain_changes_t data;
+    ec_domain_t *domain;
+    int ret;
+
+    if (unlikely(!ctx->requested))
+        return -EPERM;
+
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
+        return -EFAULT;
+    }
+
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    if (!(domain = ec_master_find_domain(master, data.domain_index))) {
+        up(&master->master_sem);
+        return -ENOENT;
+    }
+
+    ret = ecrt_domain_track_changes(domain, data.enable != 0);
+
+    up(&master->master_sem);
+    return ret;
+}
+
+/*****************************************************************************/
+
 /** Sets an SDO request's SDO index and subindex.
  *
  * \return Zero on success, otherwise a negative error code.
@@ -3357,7 +4011,11 @@ static ATTRIBUTES int ec_ioctl_sdo_request_read(
         return -ENOENT;
     }
 
-    ecrt_sdo_request_read(req);
+    if (data.complete_access) {
+        ecrt_sdo_request_read_complete(req);
+    } else {
+        ecrt_sdo_request_read(req);
+    }
     return 0;
 }
 
@@ -3935,97 +4593,193 @@ static ATTRIBUTES int ec_ioctl_voe_data(
 
 /*****************************************************************************/
 
+/** Frees an FoE read stream.
+ */
+static void ec_ioctl_foe_read_free(
+        ec_ioctl_foe_read_t *foe_read /**< FoE read stream. */
+        )
+{
+    ec_foe_request_clear(&foe_read->request);
+    kfree(foe_read);
+}
+
+/*****************************************************************************/
+
+#ifndef EC_IOCTL_RTDM
+
+/** Releases the FoE read stream of a file handle.
+ *
+ * A transfer in progress can not be aborted, so this discards the remaining
+ * data until its end.
+ */
+void ec_ioctl_clear_foe_read(
+        ec_master_t *master, /**< EtherCAT master. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    ec_foe_request_t *request;
+    int busy;
+
+    if (!ctx->foe_read) {
+        return;
+    }
+
+    request = &ctx->foe_read->request;
+
+    down(&master->master_sem);
+    if (request->state == EC_INT_REQUEST_QUEUED) {
+        list_del(&request->list);
+    }
+    busy = request->state == EC_INT_REQUEST_BUSY;
+    up(&master->master_sem);
+
+    while (busy) {
+        // the state machine holds back its acknowledges for a full buffer
+        wait_event(master->request_queue, request->data_size
+                || request->state != EC_INT_REQUEST_BUSY);
+
+        down(&master->master_sem);
+        ec_foe_request_consume(request, request->data_size);
+        busy = request->state == EC_INT_REQUEST_BUSY;
+        up(&master->master_sem);
+    }
+
+    ec_ioctl_foe_read_free(ctx->foe_read);
+    ctx->foe_read = NULL;
+}
+
+#endif
+
+/*****************************************************************************/
+
 /** Read a file from a slave via FoE.
+ *
+ * The file is streamed: The first call schedules the transfer. Every call
+ * blocks until data are available and returns at most \a buffer_size bytes
+ * of the data received so far. A call returning no data marks the end of
+ * the file. Until then, calls for another slave or file fail with -EBUSY.
+ * The slave is only asked for more data, while a few mailbox payloads at most
+ * wait for the reader.
  *
  * \return Zero on success, otherwise a negative error code.
  */
 static ATTRIBUTES int ec_ioctl_slave_foe_read(
         ec_master_t *master, /**< EtherCAT master. */
-        void *arg /**< ioctl() argument. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
     ec_ioctl_slave_foe_t io;
-    ec_foe_request_t request;
+    ec_ioctl_foe_read_t *foe_read = ctx->foe_read;
+    ec_foe_request_t *request;
     ec_slave_t *slave;
-    int ret;
+    int ret = 0;
 
     if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
         return -EFAULT;
     }
 
-    ec_foe_request_init(&request, io.file_name);
-    ret = ec_foe_request_alloc(&request, 10000); // FIXME
-    if (ret) {
-        ec_foe_request_clear(&request);
-        return ret;
+    if (!io.buffer_size) {
+        return -EINVAL;
     }
 
-    ec_foe_request_read(&request);
-
-    if (down_interruptible(&master->master_sem)) {
-        ec_foe_request_clear(&request);
-        return -EINTR;
+    if (foe_read && (foe_read->slave_position != io.slave_position
+                || strncmp(foe_read->file_name, io.file_name,
+                    sizeof(foe_read->file_name) - 1))) {
+        // another file is still being read via this file handle
+        return -EBUSY;
     }
 
-    if (!(slave = ec_master_find_slave(master, 0, io.slave_position))) {
-        up(&master->master_sem);
-        ec_foe_request_clear(&request);
-        EC_MASTER_ERR(master, "Slave %u does not exist!\n",
-                io.slave_position);
-        return -EINVAL;
-    }
+    if (!foe_read) {
+        foe_read = kmalloc(sizeof(ec_ioctl_foe_read_t), GFP_KERNEL);
+        if (!foe_read) {
+            return -ENOMEM;
+        }
 
-    EC_SLAVE_DBG(slave, 1, "Scheduling FoE read request.\n");
+        foe_read->slave_position = io.slave_position;
+        memcpy(foe_read->file_name, io.file_name, sizeof(io.file_name));
+        foe_read->file_name[sizeof(foe_read->file_name) - 1] = 0;
+        request = &foe_read->request;
+        ec_foe_request_init(request, foe_read->file_name);
+        ec_foe_request_read(request);
 
-    // schedule request.
-    list_add_tail(&request.list, &slave->foe_requests);
+        if (down_interruptible(&master->master_sem)) {
+            ec_ioctl_foe_read_free(foe_read);
+            return -EINTR;
+        }
 
-    up(&master->master_sem);
+        if (!(slave = ec_master_find_slave(master, 0, io.slave_position))) {
+            up(&master->master_sem);
+            ec_ioctl_foe_read_free(foe_read);
+            EC_MASTER_ERR(master, "Slave %u does not exist!\n",
+                    io.slave_position);
+            return -EINVAL;
+        }
 
-    // wait for processing through FSM
+        EC_SLAVE_DBG(slave, 1, "Scheduling FoE read request.\n");
+
+        // schedule request.
+        list_add_tail(&request->list, &slave->foe_requests);
+
+        up(&master->master_sem);
+
+        ctx->foe_read = foe_read;
+    }
+
+    request = &foe_read->request;
+
+    // wait for data or for the end of the transfer
     if (wait_event_interruptible(master->request_queue,
-                request.state != EC_INT_REQUEST_QUEUED)) {
+                request->data_size ||
+                (request->state != EC_INT_REQUEST_QUEUED &&
+                 request->state != EC_INT_REQUEST_BUSY))) {
         // interrupted by signal
         down(&master->master_sem);
-        if (request.state == EC_INT_REQUEST_QUEUED) {
-            list_del(&request.list);
+        if (request->state == EC_INT_REQUEST_QUEUED) {
+            list_del(&request->list);
             up(&master->master_sem);
-            ec_foe_request_clear(&request);
+            ctx->foe_read = NULL;
+            ec_ioctl_foe_read_free(foe_read);
             return -EINTR;
         }
-        // request already processing: interrupt not possible.
+        // request already processing: continued with the next call.
         up(&master->master_sem);
+        return -EINTR;
     }
 
-    // wait until master FSM has finished processing
-    wait_event(master->request_queue, request.state != EC_INT_REQUEST_BUSY);
+    if (down_interruptible(&master->master_sem)) {
+        return -EINTR;
+    }
 
-    io.result = request.result;
-    io.error_code = request.error_code;
+    io.data_size = min(request->data_size, io.buffer_size);
+    if (copy_to_user((void __user *) io.buffer,
+                request->buffer + request->data_offset, io.data_size)) {
+        up(&master->master_sem);
+        return -EFAULT;
+    }
+    ec_foe_request_consume(request, io.data_size);
 
-    if (request.state != EC_INT_REQUEST_SUCCESS) {
-        io.data_size = 0;
-        ret = -EIO;
-    } else {
-        if (request.data_size > io.buffer_size) {
-            EC_MASTER_ERR(master, "Buffer too small.\n");
-            ec_foe_request_clear(&request);
-            return -EOVERFLOW;
-        }
-        io.data_size = request.data_size;
-        if (copy_to_user((void __user *) io.buffer,
-                    request.buffer, io.data_size)) {
-            ec_foe_request_clear(&request);
-            return -EFAULT;
+    io.result = request->result;
+    io.error_code = request->error_code;
+
+    if (!io.data_size) {
+        // all data passed on and the transfer is finished
+        if (request->state != EC_INT_REQUEST_SUCCESS) {
+            ret = -EIO;
         }
-        ret = 0;
+        ctx->foe_read = NULL;
+    }
+
+    up(&master->master_sem);
+
+    if (!ctx->foe_read) {
+        ec_ioctl_foe_read_free(foe_read);
     }
 
     if (__copy_to_user((void __user *) arg, &io, sizeof(io))) {
         ret = -EFAULT;
     }
 
-    ec_foe_request_clear(&request);
     return ret;
 }
 
@@ -4281,6 +5035,13 @@ long EC_IOCTL(
             }
             ret = ec_ioctl_master_rescan(master, arg);
             break;
+        case EC_IOCTL_RESET_LATENCY:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_reset_latency(master, arg);
+            break;
         case EC_IOCTL_SLAVE_STATE:
             if (!ctx->writable) {
                 ret = -EPERM;
@@ -4314,6 +5075,40 @@ long EC_IOCTL(
             }
             ret = ec_ioctl_slave_sii_write(master, arg);
             break;
+        case EC_IOCTL_SII_CACHE:
+            ret = ec_ioctl_sii_cache(master, arg);
+            break;
+        case EC_IOCTL_SII_CACHE_ADD:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_sii_cache_add(master, arg);
+            break;
+        case EC_IOCTL_SII_CACHE_CLEAR:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_sii_cache_clear(master, arg);
+            break;
+        case EC_IOCTL_DICT_CACHE:
+            ret = ec_ioctl_dict_cache(master, arg);
+            break;
+        case EC_IOCTL_DICT_CACHE_ADD:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_dict_cache_add(master, arg);
+            break;
+        case EC_IOCTL_DICT_CACHE_CLEAR:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_dict_cache_clear(master, arg);
+            break;
         case EC_IOCTL_SLAVE_REG_READ:
             ret = ec_ioctl_slave_reg_read(master, arg);
             break;
@@ -4325,7 +5120,7 @@ long EC_IOCTL(
             ret = ec_ioctl_slave_reg_write(master, arg);
             break;
         case EC_IOCTL_SLAVE_FOE_READ:
-            ret = ec_ioctl_slave_foe_read(master, arg);
+            ret = ec_ioctl_slave_foe_read(master, arg, ctx);
             break;
         case EC_IOCTL_SLAVE_FOE_WRITE:
             if (!ctx->writable) {
@@ -4427,6 +5222,13 @@ long EC_IOCTL(
             }
             ret = ec_ioctl_receive(master, arg, ctx);
             break;
+        case EC_IOCTL_CYCLE:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_cycle(master, arg, ctx);
+            break;
         case EC_IOCTL_MASTER_STATE:
             ret = ec_ioctl_master_state(master, arg, ctx);
             break;
@@ -4634,6 +5436,20 @@ long EC_IOCTL(
             }
             ret = ec_ioctl_domain_queue(master, arg, ctx);
             break;
+        case EC_IOCTL_QUEUE_DOMAINS:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_queue_domains(master, arg, ctx);
+            break;
+        case EC_IOCTL_PROCESS_DOMAINS:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_process_domains(master, arg, ctx);
+            break;
         case EC_IOCTL_DOMAIN_STATE:
             ret = ec_ioctl_domain_state(master, arg, ctx);
             break;
@@ -4739,6 +5555,48 @@ long EC_IOCTL(
             }
             ret = ec_ioctl_set_send_interval(master, arg, ctx);
             break;
+        case EC_IOCTL_FREEZE_LAYOUT:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_freeze_layout(master, arg, ctx);
+            break;
+        case EC_IOCTL_PACK_FRAMES:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_pack_frames(master, arg, ctx);
+            break;
+        case EC_IOCTL_DOMAIN_MEMORY:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_domain_memory(master, arg, ctx);
+            break;
+        case EC_IOCTL_DOMAIN_LAYOUT:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_domain_layout(master, arg, ctx);
+            break;
+        case EC_IOCTL_DOMAIN_CYCLE:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_domain_cycle(master, arg, ctx);
+            break;
+        case EC_IOCTL_DOMAIN_CHANGES:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_domain_changes(master, arg, ctx);
+            break;
         default:
             ret = -ENOTTY;
             break;
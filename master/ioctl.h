@@ -56,7 +56,7 @@
  *
  * Increment this when changing the ioctl interface!
  */
-#define EC_IOCTL_VERSION_MAGIC 30
+#define EC_IOCTL_VERSION_MAGIC 47
 
 // Command-line tool
 #define EC_IOCTL_MODULE                EC_IOR(0x00, ec_ioctl_module_t)
@@ -154,6 +154,22 @@
 #define EC_IOCTL_VOE_DATA             EC_IOWR(0x58, ec_ioctl_voe_t)
 #define EC_IOCTL_SET_SEND_INTERVAL     EC_IOW(0x59, size_t)
 #define EC_IOCTL_SC_OVERLAPPING_IO     EC_IOW(0x5a, ec_ioctl_config_t)
+#define EC_IOCTL_FREEZE_LAYOUT         EC_IOW(0x5b, uint32_t)
+#define EC_IOCTL_DOMAIN_MEMORY         EC_IOW(0x5c, ec_ioctl_domain_memory_t)
+#define EC_IOCTL_CYCLE                 EC_IOW(0x5d, ec_ioctl_cycle_t)
+#define EC_IOCTL_RESET_LATENCY          EC_IO(0x5e)
+#define EC_IOCTL_DOMAIN_LAYOUT         EC_IOW(0x5f, ec_ioctl_domain_layout_t)
+#define EC_IOCTL_PACK_FRAMES           EC_IOW(0x60, uint32_t)
+#define EC_IOCTL_DOMAIN_CYCLE          EC_IOW(0x61, ec_ioctl_domain_cycle_t)
+#define EC_IOCTL_QUEUE_DOMAINS          EC_IO(0x62)
+#define EC_IOCTL_PROCESS_DOMAINS        EC_IO(0x63)
+#define EC_IOCTL_DOMAIN_CHANGES        EC_IOW(0x64, ec_ioctl_domain_changes_t)
+#define EC_IOCTL_SII_CACHE            EC_IOWR(0x65, ec_ioctl_sii_image_t)
+#define EC_IOCTL_SII_CACHE_ADD         EC_IOW(0x66, ec_ioctl_sii_image_t)
+#define EC_IOCTL_SII_CACHE_CLEAR        EC_IO(0x67)
+#define EC_IOCTL_DICT_CACHE           EC_IOWR(0x68, ec_ioctl_dict_t)
+#define EC_IOCTL_DICT_CACHE_ADD        EC_IOW(0x69, ec_ioctl_dict_t)
+#define EC_IOCTL_DICT_CACHE_CLEAR       EC_IO(0x6a)
 
 /*****************************************************************************/
 
@@ -187,10 +203,14 @@ typedef struct {
         uint64_t tx_bytes;
         uint64_t rx_bytes;
         uint64_t tx_errors;
+        uint64_t tx_bursts;
+        uint32_t last_tx_burst;
+        uint32_t max_tx_burst;
         int32_t tx_frame_rates[EC_RATE_COUNT];
         int32_t rx_frame_rates[EC_RATE_COUNT];
         int32_t tx_byte_rates[EC_RATE_COUNT];
         int32_t rx_byte_rates[EC_RATE_COUNT];
+        ec_latency_t latency;
     } devices[EC_MAX_NUM_DEVICES];
     uint32_t num_devices;
     uint64_t tx_count;
@@ -204,6 +224,13 @@ typedef struct {
     int32_t loss_rates[EC_RATE_COUNT];
     uint64_t app_time;
     uint16_t ref_clock;
+    uint8_t pack_frames;
+    uint32_t cycle_frames;
+    uint32_t max_cycle_frames;
+    uint32_t sii_cache_count;
+    uint32_t dict_cache_count;
+    uint32_t ext_datagram_count;
+    ec_ext_queue_stats_t ext_queues[EC_EXT_CLASS_COUNT];
 } ec_ioctl_master_t;
 
 /*****************************************************************************/
@@ -312,6 +339,7 @@ typedef struct {
     uint16_t working_counter[EC_MAX_NUM_DEVICES];
     uint16_t expected_working_counter;
     uint32_t fmmu_count;
+    ec_latency_t latency;
 } ec_ioctl_domain_t;
 
 /*****************************************************************************/
@@ -383,6 +411,7 @@ typedef struct {
     uint16_t slave_position;
     uint16_t sdo_index;
     uint8_t sdo_entry_subindex;
+    uint8_t complete_access;
     size_t target_size;
     uint8_t *target;
 
@@ -418,6 +447,36 @@ typedef struct {
 
 /*****************************************************************************/
 
+typedef struct {
+    // inputs
+    uint32_t index;
+    uint32_t nwords;
+    uint16_t *words;
+
+    // outputs
+    uint32_t vendor_id;
+    uint32_t product_code;
+    uint32_t revision_number;
+    uint32_t serial_number;
+} ec_ioctl_sii_image_t;
+
+/*****************************************************************************/
+
+typedef struct {
+    // inputs
+    uint32_t index;
+    uint32_t size;
+    uint8_t *data;
+
+    // outputs
+    uint32_t vendor_id;
+    uint32_t product_code;
+    uint32_t revision_number;
+    uint32_t sdo_count;
+} ec_ioctl_dict_t;
+
+/*****************************************************************************/
+
 typedef struct {
     // inputs
     uint16_t slave_position;
@@ -628,6 +687,7 @@ typedef struct {
     // outputs
     void *process_data;
     size_t process_data_size;
+    size_t status_offset;
 } ec_ioctl_master_activate_t;
 
 /*****************************************************************************/
@@ -726,6 +786,92 @@ typedef struct {
 
 /*****************************************************************************/
 
+typedef struct {
+    // inputs
+    uint32_t domain_index;
+    uint32_t mode;
+} ec_ioctl_domain_memory_t;
+
+/*****************************************************************************/
+
+typedef struct {
+    // inputs
+    uint32_t domain_index;
+    uint32_t layout;
+} ec_ioctl_domain_layout_t;
+
+/*****************************************************************************/
+
+typedef struct {
+    // inputs
+    uint32_t domain_index;
+    uint32_t divisor;
+    uint32_t phase;
+} ec_ioctl_domain_cycle_t;
+
+/*****************************************************************************/
+
+typedef struct {
+    // inputs
+    uint32_t domain_index;
+    uint32_t enable;
+} ec_ioctl_domain_changes_t;
+
+/*****************************************************************************/
+
+typedef struct {
+    // inputs
+    uint32_t steps;
+    uint64_t app_time;
+    uint32_t domain_count;
+    uint32_t domain_indices[EC_CYCLE_MAX_DOMAINS];
+
+    // outputs
+    ec_domain_state_t *domain_states;
+} ec_ioctl_cycle_t;
+
+/*****************************************************************************/
+
+/** Status area published behind the process data in the mapped memory.
+ *
+ * The header is followed by \a domain_count domain entries and
+ * \a config_count slave configuration states. Each sequence counter is odd
+ * while the kernel updates the data it protects; a reader has to retry, if
+ * the counter was odd or changed while reading. The master's counter also
+ * protects the slave configuration states.
+ */
+typedef struct {
+    uint32_t sequence;
+    uint32_t domain_count;
+    uint32_t config_count;
+    uint32_t num_devices;
+    ec_master_state_t master_state;
+    ec_master_link_state_t link_states[EC_MAX_NUM_DEVICES];
+} ec_ioctl_status_t;
+
+typedef struct {
+    uint32_t sequence;
+    ec_domain_state_t state;
+    uint32_t changes_offset; // change bitmap in the mapped memory, or 0
+} ec_ioctl_domain_status_t;
+
+/** Domain entries of a status area. */
+#define EC_IOCTL_STATUS_DOMAINS(STATUS) \
+    ((ec_ioctl_domain_status_t *) ((STATUS) + 1))
+
+/** Slave configuration states of a status area. */
+#define EC_IOCTL_STATUS_CONFIGS(STATUS, DOMAIN_COUNT) \
+    ((ec_slave_config_state_t *) \
+     (EC_IOCTL_STATUS_DOMAINS(STATUS) + (DOMAIN_COUNT)))
+
+/** Size of a status area. */
+#define EC_IOCTL_STATUS_SIZE(DOMAIN_COUNT, CONFIG_COUNT) \
+    (sizeof(ec_ioctl_status_t) \
+     + (DOMAIN_COUNT) * sizeof(ec_ioctl_domain_status_t) \
+     + (CONFIG_COUNT) * sizeof(ec_slave_config_state_t))
+
+/*****************************************************************************/
+
 typedef struct {
     // inputs
     uint32_t config_index;
@@ -737,6 +883,7 @@ typedef struct {
     size_t size;
     uint8_t *data;
     uint32_t timeout;
+    uint8_t complete_access;
     ec_request_state_t state;
 } ec_ioctl_sdo_request_t;
 
@@ -792,6 +939,16 @@ typedef struct {
 
 #ifdef __KERNEL__
 
+#include "foe_request.h"
+
+/** FoE read stream of a file handle.
+ */
+typedef struct {
+    ec_foe_request_t request; /**< FoE read request. */
+    uint16_t slave_position; /**< Ring position of the slave. */
+    uint8_t file_name[255]; /**< Name of the file to read. */
+} ec_ioctl_foe_read_t;
+
 /** Context data structure for file handles.
  */
 typedef struct {
@@ -799,10 +956,15 @@ typedef struct {
     unsigned int requested; /**< Master was requested via this file handle. */
     uint8_t *process_data; /**< Total process data area. */
     size_t process_data_size; /**< Size of the \a process_data. */
+    ec_ioctl_foe_read_t *foe_read; /**< FoE read in progress, or NULL. */
+    ec_domain_t *cycle_domains[EC_CYCLE_MAX_DOMAINS]; /**< Cycle domains. */
+    ec_domain_state_t cycle_states[EC_CYCLE_MAX_DOMAINS]; /**< Domain states
+                                                            of a cycle. */
 } ec_ioctl_context_t;
 
 long ec_ioctl(ec_master_t *, ec_ioctl_context_t *, unsigned int,
         void __user *);
+void ec_ioctl_clear_foe_read(ec_master_t *, ec_ioctl_context_t *);
 
 #ifdef EC_RTDM
 
@@ -0,0 +1,78 @@
+/******************************************************************************
+ *
+ *  $Id$
+ *
+ *  Copyright (C) 2006-2012  Florian Pose, Ingenieurgemeinschaft IgH
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  The license mentioned above concerns the source code only. Using the
+ *  EtherCAT technology and brand is only permitted in compliance with the
+ *  industrial property and similar rights of Beckhoff Automation GmbH.
+ *
+ *****************************************************************************/
+
+/**
+   \file
+   EtherCAT round-trip time statistics methods.
+*/
+
+/*****************************************************************************/
+
+#include <linux/bitops.h>
+#include <linux/string.h>
+
+#include "latency.h"
+
+/*****************************************************************************/
+
+/** Resets the round-trip time statistics.
+ */
+void ec_latency_reset(
+        ec_latency_t *latency /**< Round-trip time statistics. */
+        )
+{
+    memset(latency, 0x00, sizeof(ec_latency_t));
+    latency->min = 0xffffffff;
+}
+
+/*****************************************************************************/
+
+/** Adds a round-trip time to the statistics.
+ */
+void ec_latency_add(
+        ec_latency_t *latency, /**< Round-trip time statistics. */
+        uint32_t time /**< Round-trip time [ns]. */
+        )
+{
+    unsigned int bucket = time ? fls(time) - 1 : 0;
+
+    latency->buckets[bucket]++;
+    latency->count++;
+    latency->sum += time;
+
+    if (time < latency->min) {
+        latency->min = time;
+    }
+
+    if (time > latency->max) {
+        latency->max = time;
+    }
+}
+
+/*****************************************************************************/
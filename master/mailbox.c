@@ -40,6 +40,7 @@
 #include "mailbox.h"
 #include "datagram.h"
 #include "master.h"
+#include "slave_config.h"
 
 /*****************************************************************************/
 
@@ -102,6 +103,11 @@ int ec_slave_mbox_prepare_check(const ec_slave_t *slave, /**< slave */
         return ret;
 
     ec_datagram_zero(datagram);
+
+    if (slave->mbox_status_fmmu) {
+        // answered by the master's mailbox status datagram
+        datagram->mbox_status_index = slave->ring_position;
+    }
     return 0;
 }
 
@@ -140,6 +146,66 @@ int ec_slave_mbox_prepare_fetch(const ec_slave_t *slave, /**< slave */
 
 /*****************************************************************************/
 
+/** Prepares a datagram to read the repeat state of the send mailbox.
+ *
+ * Reads the activation register of the send mailbox sync manager (containing
+ * the repeat request) and its PDI control register (containing the repeat
+ * acknowledge).
+ *
+ * \return 0 in case of success, else < 0
+ */
+int ec_slave_mbox_prepare_repeat_state(
+        const ec_slave_t *slave, /**< slave */
+        ec_datagram_t *datagram /**< datagram */
+        )
+{
+    int ret = ec_datagram_fprd(datagram, slave->station_address, 0x080E, 2);
+    if (ret)
+        return ret;
+
+    ec_datagram_zero(datagram);
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** Prepares a datagram to request a repeat of the last mailbox response.
+ *
+ * Toggles the repeat request bit of the send mailbox sync manager, so that
+ * the slave writes its last response into the mailbox again. This is
+ * necessary, if a fetch datagram was lost after the slave handed out the
+ * mailbox contents.
+ *
+ * \return 0 in case of success, else < 0
+ */
+int ec_slave_mbox_prepare_repeat(
+        const ec_slave_t *slave, /**< slave */
+        ec_datagram_t *datagram, /**< datagram */
+        uint8_t activate /**< Current value of the activation register. */
+        )
+{
+    int ret = ec_datagram_fpwr(datagram, slave->station_address, 0x080E, 1);
+    if (ret)
+        return ret;
+
+    EC_WRITE_U8(datagram->data, activate ^ 0x02);
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** Processes a repeat state datagram.
+ *
+ * \return Non-zero, if the slave acknowledged the last repeat request.
+ */
+int ec_slave_mbox_repeat_done(const ec_datagram_t *datagram /**< datagram */)
+{
+    return !((EC_READ_U8(datagram->data) ^ EC_READ_U8(datagram->data + 1))
+            & 0x02);
+}
+
+/*****************************************************************************/
+
 /**
    Mailbox error codes.
 */
@@ -208,3 +274,86 @@ uint8_t *ec_slave_mbox_fetch(const ec_slave_t *slave, /**< slave */
 }
 
 /*****************************************************************************/
+
+/** Checks, if the mailbox state of a slave can be polled via the master's
+ * mailbox status area.
+ *
+ * The mailbox status FMMU is the last FMMU of the slave, so it must not be
+ * used by the slave configuration.
+ *
+ * \return Non-zero, if the mailbox status FMMU can be configured.
+ */
+int ec_slave_mbox_status_possible(
+        const ec_slave_t *slave /**< Slave. */
+        )
+{
+    unsigned int used_fmmus =
+        slave->config ? slave->config->used_fmmus : 0;
+
+    return slave->master->mbox_status
+        && slave->sii.mailbox_protocols
+        && slave->ring_position < EC_MAX_DATA_SIZE
+        && slave->base_fmmu_count > used_fmmus;
+}
+
+/*****************************************************************************/
+
+/** Returns the index of the mailbox status FMMU.
+ *
+ * \return FMMU index.
+ */
+uint8_t ec_slave_mbox_status_fmmu_index(
+        const ec_slave_t *slave /**< Slave. */
+        )
+{
+    return slave->base_fmmu_count - 1;
+}
+
+/*****************************************************************************/
+
+/** Writes the configuration page of the mailbox status FMMU.
+ *
+ * The FMMU maps the SM1 status register to the slave's byte in the mailbox
+ * status area.
+ */
+void ec_slave_mbox_status_page(
+        const ec_slave_t *slave, /**< Slave. */
+        uint8_t *data /**< Configuration page memory. */
+        )
+{
+    EC_WRITE_U32(data,      EC_MBOX_STATUS_ADDRESS + slave->ring_position);
+    EC_WRITE_U16(data + 4,  1); // size of fmmu
+    EC_WRITE_U8 (data + 6,  0x00); // logical start bit
+    EC_WRITE_U8 (data + 7,  0x07); // logical end bit
+    EC_WRITE_U16(data + 8,  0x080D); // SM1 status register
+    EC_WRITE_U8 (data + 10, 0x00); // physical start bit
+    EC_WRITE_U8 (data + 11, 0x01); // read access
+    EC_WRITE_U16(data + 12, 0x0001); // enable
+    EC_WRITE_U16(data + 14, 0x0000); // reserved
+}
+
+/*****************************************************************************/
+
+/** Marks the mailbox status FMMU of a slave as configured or cleared.
+ *
+ * The master counts the configured FMMUs to determine the expected working
+ * counter of the mailbox status datagram.
+ */
+void ec_slave_mbox_set_status_fmmu(
+        ec_slave_t *slave, /**< Slave. */
+        unsigned int configured /**< The FMMU is configured. */
+        )
+{
+    if (slave->mbox_status_fmmu == configured) {
+        return;
+    }
+
+    slave->mbox_status_fmmu = configured;
+    if (configured) {
+        slave->master->mbox_status_count++;
+    } else {
+        slave->master->mbox_status_count--;
+    }
+}
+
+/*****************************************************************************/
@@ -45,6 +45,15 @@
  */
 #define EC_MBOX_HEADER_SIZE 6
 
+/** Logical address of the master's mailbox status area.
+ *
+ * If mailbox status polling is enabled, the SM1 status register of every
+ * mailbox slave is mapped to the byte at the slave's ring position via an
+ * additional FMMU. A single LRD datagram then reports the mailbox states of
+ * all slaves.
+ */
+#define EC_MBOX_STATUS_ADDRESS 0xFFFF0000
+
 /** Mailbox types.
  *
  * These are used in the 'Type' field of the mailbox header.
@@ -66,6 +75,16 @@ int      ec_slave_mbox_check(const ec_datagram_t *);
 int      ec_slave_mbox_prepare_fetch(const ec_slave_t *, ec_datagram_t *);
 uint8_t *ec_slave_mbox_fetch(const ec_slave_t *, const ec_datagram_t *,
                              uint8_t *, size_t *);
+int      ec_slave_mbox_prepare_repeat_state(const ec_slave_t *,
+                                            ec_datagram_t *);
+int      ec_slave_mbox_prepare_repeat(const ec_slave_t *, ec_datagram_t *,
+                                      uint8_t);
+int      ec_slave_mbox_repeat_done(const ec_datagram_t *);
+
+int      ec_slave_mbox_status_possible(const ec_slave_t *);
+uint8_t  ec_slave_mbox_status_fmmu_index(const ec_slave_t *);
+void     ec_slave_mbox_status_page(const ec_slave_t *, uint8_t *);
+void     ec_slave_mbox_set_status_fmmu(ec_slave_t *, unsigned int);
 
 /*****************************************************************************/
 
@@ -44,11 +44,16 @@
 #include <linux/device.h>
 #include <linux/version.h>
 #include <linux/hrtimer.h>
+#include <linux/math64.h>
 #include "globals.h"
 #include "slave.h"
 #include "slave_config.h"
 #include "device.h"
 #include "datagram.h"
+#include "datagram_pair.h"
+#include "domain.h"
+#include "latency.h"
+#include "mailbox.h"
 #ifdef EC_EOE
 #include "ethernet.h"
 #endif
@@ -70,20 +75,12 @@
  */
 static cycles_t timeout_cycles;
 
-/** Timeout for external datagram injection [cycles].
- */
-static cycles_t ext_injection_timeout_cycles;
-
 #else
 
 /** Frame timeout in jiffies.
  */
 static unsigned long timeout_jiffies;
 
-/** Timeout for external datagram injection [jiffies].
- */
-static unsigned long ext_injection_timeout_jiffies;
-
 #endif
 
 /** List of intervals for statistics [s].
@@ -95,6 +92,7 @@ const unsigned int rate_intervals[] = {
 /*****************************************************************************/
 
 void ec_master_clear_slave_configs(ec_master_t *);
+static void ec_master_clear_ext_datagrams(ec_master_t *);
 void ec_master_clear_domains(ec_master_t *);
 static int ec_master_idle_thread(void *);
 static int ec_master_operation_thread(void *);
@@ -113,13 +111,9 @@ void ec_master_init_static(void)
 {
 #ifdef EC_HAVE_CYCLES
     timeout_cycles = (cycles_t) EC_IO_TIMEOUT /* us */ * (cpu_khz / 1000);
-    ext_injection_timeout_cycles =
-        (cycles_t) EC_SDO_INJECTION_TIMEOUT /* us */ * (cpu_khz / 1000);
 #else
     // one jiffy may always elapse between time measurement
     timeout_jiffies = max(EC_IO_TIMEOUT * HZ / 1000000, 1);
-    ext_injection_timeout_jiffies =
-        max(EC_SDO_INJECTION_TIMEOUT * HZ / 1000000, 1);
 #endif
 }
 
@@ -136,7 +130,16 @@ int ec_master_init(ec_master_t *master, /**< EtherCAT master */
         const uint8_t *backup_mac, /**< MAC address of backup device */
         dev_t device_number, /**< Character device number. */
         struct class *class, /**< Device class. */
-        unsigned int debug_level /**< Debug level (module parameter). */
+        unsigned int debug_level, /**< Debug level (module parameter). */
+        unsigned int scan_parallel, /**< Number of slaves to scan in
+                                      parallel (module parameter). */
+        unsigned int config_parallel, /**< Maximum number of slaves to
+                                       configure in parallel (module
+                                       parameter). */
+        unsigned int mbox_status, /**< Poll the mailbox states via the mailbox
+                                    status area (module parameter). */
+        unsigned int boot_mbox_size /**< Minimum size of the bootstrap receive
+                                      mailbox (module parameter). */
         )
 {
     int ret;
@@ -192,20 +195,26 @@ int ec_master_init(ec_master_t *master, /**< EtherCAT master */
     init_waitqueue_head(&master->config_queue);
 
     INIT_LIST_HEAD(&master->datagram_queue);
+    INIT_LIST_HEAD(&master->sent_queue);
     master->datagram_index = 0;
+    memset(master->datagram_by_index, 0x00,
+            sizeof(master->datagram_by_index));
 
     INIT_LIST_HEAD(&master->ext_datagram_queue);
     sema_init(&master->ext_queue_sem, 1);
 
-    master->ext_ring_idx_rt = 0;
-    master->ext_ring_idx_fsm = 0;
-
-    // init external datagram ring
-    for (i = 0; i < EC_EXT_RING_SIZE; i++) {
-        ec_datagram_t *datagram = &master->ext_datagram_ring[i];
-        ec_datagram_init(datagram);
-        snprintf(datagram->name, EC_DATAGRAM_NAME_SIZE, "ext-%u", i);
+    // the datagram pool grows on demand
+    INIT_LIST_HEAD(&master->ext_datagrams);
+    master->ext_datagram_count = 0;
+    for (i = 0; i < EC_EXT_CLASS_COUNT; i++) {
+        INIT_LIST_HEAD(&master->ext_submitted[i]);
     }
+    master->ext_seq_fsm = 0;
+    master->ext_seq_rt = 0;
+    ec_ext_scheduler_init(&master->ext_scheduler);
+    master->latency_reset_seq = 0;
+    master->latency_reset_rx = 0;
+    master->latency_reset_tx = 0;
 
     // send interval in IDLE phase
     ec_master_set_send_interval(master, 1000000 / HZ);
@@ -218,6 +227,7 @@ int ec_master_init(ec_master_t *master, /**< EtherCAT master */
     master->stats.timeouts = 0;
     master->stats.corrupted = 0;
     master->stats.unmatched = 0;
+    master->stats.index_collisions = 0;
     master->stats.output_jiffies = 0;
 
     master->thread = NULL;
@@ -234,8 +244,17 @@ int ec_master_init(ec_master_t *master, /**< EtherCAT master */
     master->app_send_cb = NULL;
     master->app_receive_cb = NULL;
     master->app_cb_data = NULL;
+    master->freeze_layout = 0;
+    master->pack_frames = 0;
+    master->cycle_frames = 0;
+    master->max_cycle_frames = 0;
+    master->status = NULL;
+    master->status_domain_count = 0;
+    master->status_config_count = 0;
 
     INIT_LIST_HEAD(&master->sii_requests);
+    ec_sii_cache_init(&master->sii_cache);
+    ec_dict_cache_init(&master->dict_cache);
     INIT_LIST_HEAD(&master->emerg_reg_requests);
 
     init_waitqueue_head(&master->request_queue);
@@ -260,17 +279,11 @@ int ec_master_init(ec_master_t *master, /**< EtherCAT master */
     }
 
     // create state machine object
-    ec_fsm_master_init(&master->fsm, master, &master->fsm_datagram);
-
-    // alloc external datagram ring
-    for (i = 0; i < EC_EXT_RING_SIZE; i++) {
-        ec_datagram_t *datagram = &master->ext_datagram_ring[i];
-        ret = ec_datagram_prealloc(datagram, EC_MAX_DATA_SIZE);
-        if (ret) {
-            EC_MASTER_ERR(master, "Failed to allocate external"
-                    " datagram %u.\n", i);
-            goto out_clear_ext_datagrams;
-        }
+    ret = ec_fsm_master_init(&master->fsm, master, &master->fsm_datagram,
+            scan_parallel, config_parallel);
+    if (ret < 0) {
+        ec_datagram_clear(&master->fsm_datagram);
+        goto out_clear_devices;
     }
 
     // init reference sync datagram
@@ -282,7 +295,7 @@ int ec_master_init(ec_master_t *master, /**< EtherCAT master */
         ec_datagram_clear(&master->ref_sync_datagram);
         EC_MASTER_ERR(master, "Failed to allocate reference"
                 " synchronisation datagram.\n");
-        goto out_clear_ext_datagrams;
+        goto out_clear_fsm;
     }
 
     // init sync datagram
@@ -308,13 +321,33 @@ int ec_master_init(ec_master_t *master, /**< EtherCAT master */
         goto out_clear_sync;
     }
 
+    master->boot_mbox_size = boot_mbox_size;
+
+    // init mailbox status datagram
+    master->mbox_status = mbox_status;
+    master->mbox_status_count = 0;
+    master->mbox_status_wc = 0;
+    INIT_LIST_HEAD(&master->mbox_check_queue);
+    INIT_LIST_HEAD(&master->mbox_check_sent);
+    ec_datagram_init(&master->mbox_status_datagram);
+    snprintf(master->mbox_status_datagram.name, EC_DATAGRAM_NAME_SIZE,
+            "mbox-status");
+    ret = ec_datagram_prealloc(&master->mbox_status_datagram,
+            EC_MAX_DATA_SIZE);
+    if (ret < 0) {
+        ec_datagram_clear(&master->mbox_status_datagram);
+        EC_MASTER_ERR(master, "Failed to allocate mailbox"
+                " status datagram.\n");
+        goto out_clear_sync_mon;
+    }
+
     master->dc_ref_config = NULL;
     master->dc_ref_clock = NULL;
 
     // init character device
     ret = ec_cdev_init(&master->cdev, master, device_number);
     if (ret)
-        goto out_clear_sync_mon;
+        goto out_clear_mbox_status;
 
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(2, 6, 27)
     master->class_device = device_create(class, NULL,
@@ -359,16 +392,15 @@ out_unregister_class_device:
 #endif
 out_clear_cdev:
     ec_cdev_clear(&master->cdev);
+out_clear_mbox_status:
+    ec_datagram_clear(&master->mbox_status_datagram);
 out_clear_sync_mon:
     ec_datagram_clear(&master->sync_mon_datagram);
 out_clear_sync:
     ec_datagram_clear(&master->sync_datagram);
 out_clear_ref_sync:
     ec_datagram_clear(&master->ref_sync_datagram);
-out_clear_ext_datagrams:
-    for (i = 0; i < EC_EXT_RING_SIZE; i++) {
-        ec_datagram_clear(&master->ext_datagram_ring[i]);
-    }
+out_clear_fsm:
     ec_fsm_master_clear(&master->fsm);
     ec_datagram_clear(&master->fsm_datagram);
 out_clear_devices:
@@ -386,7 +418,7 @@ void ec_master_clear(
         ec_master_t *master /**< EtherCAT master */
         )
 {
-    unsigned int dev_idx, i;
+    unsigned int dev_idx;
 
 #ifdef EC_RTDM
     ec_rtdm_dev_clear(&master->rtdm_dev);
@@ -406,14 +438,15 @@ void ec_master_clear(
     ec_master_clear_domains(master);
     ec_master_clear_slave_configs(master);
     ec_master_clear_slaves(master);
+    ec_sii_cache_clear(&master->sii_cache);
+    ec_dict_cache_clear(&master->dict_cache);
 
+    ec_datagram_clear(&master->mbox_status_datagram);
     ec_datagram_clear(&master->sync_mon_datagram);
     ec_datagram_clear(&master->sync_datagram);
     ec_datagram_clear(&master->ref_sync_datagram);
 
-    for (i = 0; i < EC_EXT_RING_SIZE; i++) {
-        ec_datagram_clear(&master->ext_datagram_ring[i]);
-    }
+    ec_master_clear_ext_datagrams(master);
 
     ec_fsm_master_clear(&master->fsm);
     ec_datagram_clear(&master->fsm_datagram);
@@ -468,6 +501,7 @@ void ec_master_clear_slave_configs(ec_master_t *master)
 void ec_master_clear_slaves(ec_master_t *master)
 {
     ec_slave_t *slave;
+    ec_ext_datagram_t *ext;
 
     master->dc_ref_clock = NULL;
 
@@ -489,6 +523,11 @@ void ec_master_clear_slaves(ec_master_t *master)
     INIT_LIST_HEAD(&master->fsm_exec_list);
     master->fsm_exec_count = 0;
 
+    // datagrams, that are still in flight, are reused after their return
+    list_for_each_entry(ext, &master->ext_datagrams, list) {
+        ext->used = 0;
+    }
+
     for (slave = master->slaves;
             slave < master->slaves + master->slave_count;
             slave++) {
@@ -501,6 +540,7 @@ void ec_master_clear_slaves(ec_master_t *master)
     }
 
     master->slave_count = 0;
+    master->mbox_status_count = 0;
 }
 
 /*****************************************************************************/
@@ -526,7 +566,23 @@ void ec_master_clear_config(
         ec_master_t *master /**< EtherCAT master. */
         )
 {
+    ec_device_index_t dev_idx;
+
     down(&master->master_sem);
+
+    // frame templates reference the domain datagrams
+    down(&master->io_sem);
+    for (dev_idx = EC_DEVICE_MAIN;
+            dev_idx < ec_master_num_devices(master); dev_idx++) {
+        ec_device_clear_frame_templates(&master->devices[dev_idx]);
+    }
+    up(&master->io_sem);
+
+    // the status area is released together with the process data
+    master->status = NULL;
+    master->status_domain_count = 0;
+    master->status_config_count = 0;
+
     ec_master_clear_domains(master);
     ec_master_clear_slave_configs(master);
     up(&master->master_sem);
@@ -534,6 +590,95 @@ void ec_master_clear_config(
 
 /*****************************************************************************/
 
+/** Sets the status area, where the master publishes its state and the states
+ * of the domains and slave configurations.
+ *
+ * The area is part of the process data memory mapped to user space and has
+ * to provide room for the given number of entries (see
+ * EC_IOCTL_STATUS_SIZE()). It is reset on ec_master_clear_config().
+ */
+void ec_master_set_status(
+        ec_master_t *master, /**< EtherCAT master. */
+        ec_ioctl_status_t *status, /**< Status area. */
+        unsigned int domain_count, /**< Number of domain entries. */
+        unsigned int config_count /**< Number of slave configuration
+                                    entries. */
+        )
+{
+    memset(status, 0x00, EC_IOCTL_STATUS_SIZE(domain_count, config_count));
+    status->domain_count = domain_count;
+    status->config_count = config_count;
+    status->num_devices = ec_master_num_devices(master);
+
+    master->status_domain_count = domain_count;
+    master->status_config_count = config_count;
+    master->status = status;
+}
+
+/*****************************************************************************/
+
+/** Publishes the master state, the link states and the slave configuration
+ * states in the status area.
+ *
+ * The data are protected by the master's sequence counter, which is odd
+ * while they are written.
+ */
+static void ec_master_publish_state(
+        ec_master_t *master /**< EtherCAT master. */
+        )
+{
+    ec_ioctl_status_t *status = master->status;
+    ec_slave_config_state_t *config_states =
+        EC_IOCTL_STATUS_CONFIGS(status, master->status_domain_count);
+    ec_slave_config_t *sc;
+    unsigned int dev_idx, i = 0;
+
+    status->sequence++;
+    smp_wmb();
+
+    ecrt_master_state(master, &status->master_state);
+    for (dev_idx = EC_DEVICE_MAIN; dev_idx < ec_master_num_devices(master);
+            dev_idx++) {
+        ecrt_master_link_state(master, dev_idx,
+                &status->link_states[dev_idx]);
+    }
+
+    list_for_each_entry(sc, &master->configs, list) {
+        if (i >= master->status_config_count) {
+            break;
+        }
+        ecrt_slave_config_state(sc, &config_states[i++]);
+    }
+
+    smp_wmb();
+    status->sequence++;
+}
+
+/*****************************************************************************/
+
+/** Publishes the state of a domain in the status area.
+ */
+void ec_master_publish_domain_state(
+        ec_master_t *master, /**< EtherCAT master. */
+        ec_domain_t *domain /**< Domain. */
+        )
+{
+    ec_ioctl_domain_status_t *entry;
+
+    if (domain->index >= master->status_domain_count) {
+        return;
+    }
+
+    entry = EC_IOCTL_STATUS_DOMAINS(master->status) + domain->index;
+    entry->sequence++;
+    smp_wmb();
+    ecrt_domain_state(domain, &entry->state);
+    smp_wmb();
+    entry->sequence++;
+}
+
+/*****************************************************************************/
+
 /** Internal sending callback.
  */
 void ec_master_internal_send_cb(
@@ -749,6 +894,10 @@ int ec_master_enter_operation_phase(
     master->app_send_cb = NULL;
     master->app_receive_cb = NULL;
     master->app_cb_data = NULL;
+    master->freeze_layout = 0;
+    master->pack_frames = 0;
+    master->cycle_frames = 0;
+    master->max_cycle_frames = 0;
     return ret;
 
 out_allow:
@@ -781,26 +930,64 @@ void ec_master_leave_operation_phase(
 
 /*****************************************************************************/
 
+/** Takes over the datagrams submitted by the slave FSMs.
+ */
+static void ec_master_take_ext_datagrams(
+        ec_master_t *master /**< EtherCAT master */
+        )
+{
+    ec_datagram_t *datagram, *next;
+    unsigned int i;
+
+    for (i = 0; i < EC_EXT_CLASS_COUNT; i++) {
+        list_for_each_entry_safe(datagram, next,
+                &master->ext_submitted[i], queue) {
+            list_del_init(&datagram->queue);
+
+            if (ec_ext_datagram_size(datagram) > master->max_queue_size) {
+                datagram->state = EC_DATAGRAM_ERROR;
+                EC_MASTER_ERR(master, "External datagram %s is too large,"
+                        " size=%zu, max_queue_size=%zu\n",
+                        datagram->name, datagram->data_size,
+                        master->max_queue_size);
+                continue;
+            }
+
+            ec_ext_scheduler_enqueue(&master->ext_scheduler, i, datagram);
+        }
+    }
+}
+
+/*****************************************************************************/
+
 /** Injects external datagrams that fit into the datagram queue.
+ *
+ * The acyclic datagram scheduler hands out datagrams as long as the bytes
+ * already queued for this cycle leave room for them.
  */
 void ec_master_inject_external_datagrams(
         ec_master_t *master /**< EtherCAT master */
         )
 {
     ec_datagram_t *datagram;
-    size_t queue_size = 0, new_queue_size = 0;
+    size_t queue_size = 0;
 #if DEBUG_INJECT
     unsigned int datagram_count = 0;
 #endif
 
-    if (master->ext_ring_idx_rt == master->ext_ring_idx_fsm) {
-        // nothing to inject
-        return;
+    if (master->ext_seq_rt != master->ext_seq_fsm) {
+        ec_master_take_ext_datagrams(master);
+        master->ext_seq_rt = master->ext_seq_fsm;
+    }
+
+    if (master->latency_reset_tx != master->latency_reset_seq) {
+        ec_ext_scheduler_reset_stats(&master->ext_scheduler);
+        master->latency_reset_tx = master->latency_reset_seq;
     }
 
     list_for_each_entry(datagram, &master->datagram_queue, queue) {
         if (datagram->state == EC_DATAGRAM_QUEUED) {
-            queue_size += datagram->data_size;
+            queue_size += ec_ext_datagram_size(datagram);
         }
     }
 
@@ -809,87 +996,119 @@ void ec_master_inject_external_datagrams(
             queue_size);
 #endif
 
-    while (master->ext_ring_idx_rt != master->ext_ring_idx_fsm) {
-        datagram = &master->ext_datagram_ring[master->ext_ring_idx_rt];
-
-        if (datagram->state != EC_DATAGRAM_INIT) {
-            // skip datagram
-            master->ext_ring_idx_rt =
-                (master->ext_ring_idx_rt + 1) % EC_EXT_RING_SIZE;
-            continue;
-        }
-
-        new_queue_size = queue_size + datagram->data_size;
-        if (new_queue_size <= master->max_queue_size) {
+    while (queue_size < master->max_queue_size
+            && (datagram = ec_ext_scheduler_dequeue(&master->ext_scheduler,
+                    master->max_queue_size - queue_size))) {
+        queue_size += ec_ext_datagram_size(datagram);
 #if DEBUG_INJECT
-            EC_MASTER_DBG(master, 1, "Injecting datagram %s"
-                    " size=%zu, queue_size=%zu\n", datagram->name,
-                    datagram->data_size, new_queue_size);
-            datagram_count++;
-#endif
-#ifdef EC_HAVE_CYCLES
-            datagram->cycles_sent = 0;
+        EC_MASTER_DBG(master, 1, "Injecting datagram %s"
+                " size=%zu, queue_size=%zu\n", datagram->name,
+                datagram->data_size, queue_size);
+        datagram_count++;
 #endif
-            datagram->jiffies_sent = 0;
-            ec_master_queue_datagram(master, datagram);
-            queue_size = new_queue_size;
-        }
-        else if (datagram->data_size > master->max_queue_size) {
-            datagram->state = EC_DATAGRAM_ERROR;
-            EC_MASTER_ERR(master, "External datagram %s is too large,"
-                    " size=%zu, max_queue_size=%zu\n",
-                    datagram->name, datagram->data_size,
-                    master->max_queue_size);
-        }
-        else { // datagram does not fit in the current cycle
-#ifdef EC_HAVE_CYCLES
-            cycles_t cycles_now = get_cycles();
+        ec_master_queue_datagram(master, datagram);
+    }
 
-            if (cycles_now - datagram->cycles_sent
-                    > ext_injection_timeout_cycles)
-#else
-            if (jiffies - datagram->jiffies_sent
-                    > ext_injection_timeout_jiffies)
-#endif
-            {
+    while ((datagram = ec_ext_scheduler_expired(&master->ext_scheduler))) {
+        datagram->state = EC_DATAGRAM_ERROR;
 #if defined EC_RT_SYSLOG || DEBUG_INJECT
-                unsigned int time_us;
+        EC_MASTER_ERR(master, "Timeout: Injecting external datagram %s"
+                " size=%zu, max_queue_size=%zu\n", datagram->name,
+                datagram->data_size, master->max_queue_size);
 #endif
+    }
 
-                datagram->state = EC_DATAGRAM_ERROR;
-
-#if defined EC_RT_SYSLOG || DEBUG_INJECT
-#ifdef EC_HAVE_CYCLES
-                time_us = (unsigned int)
-                    ((cycles_now - datagram->cycles_sent) * 1000LL)
-                    / cpu_khz;
-#else
-                time_us = (unsigned int)
-                    ((jiffies - datagram->jiffies_sent) * 1000000 / HZ);
-#endif
-                EC_MASTER_ERR(master, "Timeout %u us: Injecting"
-                        " external datagram %s size=%zu,"
-                        " max_queue_size=%zu\n", time_us, datagram->name,
-                        datagram->data_size, master->max_queue_size);
-#endif
-            }
-            else {
 #if DEBUG_INJECT
-                EC_MASTER_DBG(master, 1, "Deferred injecting"
-                        " external datagram %s size=%u, queue_size=%u\n",
-                        datagram->name, datagram->data_size, queue_size);
+    EC_MASTER_DBG(master, 1, "Injected %u datagrams.\n", datagram_count);
 #endif
-                break;
-            }
+}
+
+/*****************************************************************************/
+
+/** Queues the mailbox status datagram, if mailbox checks are waiting.
+ *
+ * The mailbox checks waiting at this point are answered by this datagram,
+ * so that every answer reflects a mailbox state read after the check was
+ * requested.
+ */
+static void ec_master_queue_mbox_status(
+        ec_master_t *master /**< EtherCAT master */
+        )
+{
+    ec_datagram_t *datagram = &master->mbox_status_datagram;
+    ec_datagram_t *check, *next;
+
+    if (list_empty(&master->mbox_check_queue)
+            || !list_empty(&master->mbox_check_sent)) {
+        return;
+    }
+
+    if (!master->mbox_status_count) {
+        // no mailbox status FMMUs configured (any more)
+        list_for_each_entry_safe(check, next, &master->mbox_check_queue,
+                queue) {
+            list_del_init(&check->queue);
+            check->mbox_status_index = -1;
+            ec_master_queue_datagram(master, check);
         }
+        return;
+    }
+
+    ec_datagram_lrd(datagram, EC_MBOX_STATUS_ADDRESS,
+            min_t(size_t, master->slave_count, EC_MAX_DATA_SIZE));
+    ec_datagram_zero(datagram);
+    master->mbox_status_wc = master->mbox_status_count;
 
-        master->ext_ring_idx_rt =
-            (master->ext_ring_idx_rt + 1) % EC_EXT_RING_SIZE;
+    list_splice_init(&master->mbox_check_queue, &master->mbox_check_sent);
+    ec_master_queue_datagram(master, datagram);
+}
+
+/*****************************************************************************/
+
+/** Answers the mailbox checks from the received mailbox status datagram.
+ *
+ * If the working counter does not match the number of configured mailbox
+ * status FMMUs, the mailbox checks are sent as separate datagrams instead.
+ */
+static void ec_master_process_mbox_status(
+        ec_master_t *master /**< EtherCAT master */
+        )
+{
+    ec_datagram_t *datagram = &master->mbox_status_datagram;
+    ec_datagram_t *check, *next;
+    unsigned int valid;
+
+    if (list_empty(&master->mbox_check_sent)
+            || datagram->state == EC_DATAGRAM_QUEUED
+            || datagram->state == EC_DATAGRAM_SENT) {
+        return;
     }
 
-#if DEBUG_INJECT
-    EC_MASTER_DBG(master, 1, "Injected %u datagrams.\n", datagram_count);
+    valid = datagram->state == EC_DATAGRAM_RECEIVED
+        && datagram->working_counter == master->mbox_status_wc;
+
+    list_for_each_entry_safe(check, next, &master->mbox_check_sent, queue) {
+        list_del_init(&check->queue);
+
+        if (!valid
+                || (size_t) check->mbox_status_index >= datagram->data_size) {
+            // poll the mailbox state of this slave directly
+            check->mbox_status_index = -1;
+            ec_master_queue_datagram(master, check);
+            continue;
+        }
+
+        EC_WRITE_U8(check->data + 5,
+                EC_READ_U8(datagram->data + check->mbox_status_index));
+        check->working_counter = 1;
+#ifdef EC_HAVE_CYCLES
+        check->cycles_sent = datagram->cycles_sent;
+        check->cycles_received = datagram->cycles_received;
 #endif
+        check->jiffies_sent = datagram->jiffies_sent;
+        check->jiffies_received = datagram->jiffies_received;
+        check->state = EC_DATAGRAM_RECEIVED;
+    }
 }
 
 /*****************************************************************************/
@@ -910,23 +1129,106 @@ void ec_master_set_send_interval(
 
 /*****************************************************************************/
 
-/** Searches for a free datagram in the external datagram ring.
+/** Takes a datagram from the pool for a slave FSM.
  *
- * \return Next free datagram, or NULL.
+ * Datagrams, that the realtime side still holds (their FSM was removed by
+ * a bus rescan meanwhile), are skipped. If no datagram is free, the pool is
+ * extended.
+ *
+ * \return Datagram, or NULL, if the pool could not be extended.
  */
-ec_datagram_t *ec_master_get_external_datagram(
+static ec_datagram_t *ec_master_alloc_ext_datagram(
         ec_master_t *master /**< EtherCAT master */
         )
 {
-    if ((master->ext_ring_idx_fsm + 1) % EC_EXT_RING_SIZE !=
-            master->ext_ring_idx_rt) {
-        ec_datagram_t *datagram =
-            &master->ext_datagram_ring[master->ext_ring_idx_fsm];
-        return datagram;
+    ec_ext_datagram_t *ext;
+
+    list_for_each_entry(ext, &master->ext_datagrams, list) {
+        if (ext->used) {
+            break; // unused datagrams are in front
+        }
+
+        if (ext->datagram.state != EC_DATAGRAM_QUEUED &&
+                ext->datagram.state != EC_DATAGRAM_SENT) {
+            ext->used = 1;
+            list_move_tail(&ext->list, &master->ext_datagrams);
+            return &ext->datagram;
+        }
     }
-    else {
+
+    if (!(ext = kmalloc(sizeof(ec_ext_datagram_t), GFP_KERNEL))) {
+        EC_MASTER_ERR(master, "Failed to allocate external datagram.\n");
         return NULL;
     }
+
+    ec_datagram_init(&ext->datagram);
+    snprintf(ext->datagram.name, EC_DATAGRAM_NAME_SIZE, "ext-%u",
+            master->ext_datagram_count);
+    if (ec_datagram_prealloc(&ext->datagram, EC_MAX_DATA_SIZE)) {
+        EC_MASTER_ERR(master, "Failed to allocate external"
+                " datagram memory.\n");
+        ec_datagram_clear(&ext->datagram);
+        kfree(ext);
+        return NULL;
+    }
+
+    ext->used = 1;
+    list_add_tail(&ext->list, &master->ext_datagrams);
+    master->ext_datagram_count++;
+    return &ext->datagram;
+}
+
+/*****************************************************************************/
+
+/** Returns a datagram to the pool.
+ */
+static void ec_master_free_ext_datagram(
+        ec_master_t *master, /**< EtherCAT master */
+        ec_datagram_t *datagram /**< Datagram taken from the pool. */
+        )
+{
+    ec_ext_datagram_t *ext =
+        container_of(datagram, ec_ext_datagram_t, datagram);
+
+    ext->used = 0;
+    list_move(&ext->list, &master->ext_datagrams);
+}
+
+/*****************************************************************************/
+
+/** Frees the datagram pool.
+ */
+static void ec_master_clear_ext_datagrams(
+        ec_master_t *master /**< EtherCAT master */
+        )
+{
+    ec_ext_datagram_t *ext, *next;
+
+    list_for_each_entry_safe(ext, next, &master->ext_datagrams, list) {
+        list_del(&ext->list);
+        ec_datagram_clear(&ext->datagram);
+        kfree(ext);
+    }
+
+    master->ext_datagram_count = 0;
+}
+
+/*****************************************************************************/
+
+/** Hands the datagram of a slave FSM over to the realtime side.
+ *
+ * The datagram counts as queued from now on, so that neither the FSM nor
+ * the pool touch it before it was answered.
+ */
+static void ec_master_submit_ext_datagram(
+        ec_master_t *master, /**< EtherCAT master */
+        const ec_fsm_slave_t *fsm, /**< Slave FSM. */
+        ec_datagram_t *datagram /**< Datagram to submit. */
+        )
+{
+    datagram->state = EC_DATAGRAM_QUEUED;
+    list_add_tail(&datagram->queue,
+            &master->ext_submitted[ec_fsm_slave_ext_class(fsm)]);
 }
 
 /*****************************************************************************/
@@ -938,24 +1240,30 @@ void ec_master_queue_datagram(
         ec_datagram_t *datagram /**< datagram */
         )
 {
-    ec_datagram_t *queued_datagram;
-
     /* It is possible, that a datagram in the queue is re-initialized with the
      * ec_datagram_<type>() methods and then shall be queued with this method.
      * In that case, the state is already reset to EC_DATAGRAM_INIT. Check if
      * the datagram is queued to avoid duplicate queuing (which results in an
      * infinite loop!). Set the state to EC_DATAGRAM_QUEUED again, probably
-     * causing an unmatched datagram. */
-    list_for_each_entry(queued_datagram, &master->datagram_queue, queue) {
-        if (queued_datagram == datagram) {
-            datagram->skip_count++;
+     * causing an unmatched datagram.
+     *
+     * The queue list item is re-initialized every time a datagram is removed
+     * from a queue, so a non-empty list item means, that it is queued. */
+    if (!list_empty(&datagram->queue)) {
+        datagram->skip_count++;
 #ifdef EC_RT_SYSLOG
-            EC_MASTER_DBG(master, 1,
-                    "Datagram %p already queued (skipping).\n", datagram);
+        EC_MASTER_DBG(master, 1,
+                "Datagram %p already queued (skipping).\n", datagram);
 #endif
-            datagram->state = EC_DATAGRAM_QUEUED;
-            return;
-        }
+        datagram->state = EC_DATAGRAM_QUEUED;
+        return;
+    }
+
+    if (datagram->mbox_status_index >= 0) {
+        // answered by the next mailbox status datagram
+        list_add_tail(&datagram->queue, &master->mbox_check_queue);
+        datagram->state = EC_DATAGRAM_QUEUED;
+        return;
     }
 
     list_add_tail(&datagram->queue, &master->datagram_queue);
@@ -972,21 +1280,150 @@ void ec_master_queue_datagram_ext(
         )
 {
     down(&master->ext_queue_sem);
-    list_add_tail(&datagram->queue, &master->ext_datagram_queue);
+    if (list_empty(&datagram->queue)) {
+        list_add_tail(&datagram->queue, &master->ext_datagram_queue);
+    }
     up(&master->ext_queue_sem);
 }
 
 /*****************************************************************************/
 
+/** Removes a datagram from the datagram index table.
+ *
+ * A datagram, that was sent but never received, may still be referenced by
+ * the index table. This has to be called before freeing the datagram's
+ * memory.
+ */
+void ec_master_release_datagram(
+        ec_master_t *master, /**< EtherCAT master */
+        const ec_datagram_t *datagram /**< datagram */
+        )
+{
+    unsigned int i;
+
+    for (i = 0; i < EC_DATAGRAM_INDEX_COUNT; i++) {
+        if (master->datagram_by_index[i] == datagram) {
+            master->datagram_by_index[i] = NULL;
+        }
+    }
+}
+
+/*****************************************************************************/
+
+/** Assigns the next datagram index and registers the datagram in the index
+ * table.
+ */
+static void ec_master_index_datagram(
+        ec_master_t *master, /**< EtherCAT master */
+        ec_datagram_t *datagram /**< datagram */
+        )
+{
+    datagram->index = master->datagram_index++;
+
+    if (unlikely(master->datagram_by_index[datagram->index] &&
+                master->datagram_by_index[datagram->index]->state
+                == EC_DATAGRAM_SENT)) {
+        master->stats.index_collisions++;
+#ifdef EC_RT_SYSLOG
+        ec_master_output_stats(master);
+#endif
+    }
+    master->datagram_by_index[datagram->index] = datagram;
+
+    EC_MASTER_DBG(master, 2, "Adding datagram 0x%02X\n", datagram->index);
+}
+
+/*****************************************************************************/
+
+/** Searches the next frame template of a device, that can be sent.
+ *
+ * \return Frame template, or NULL.
+ */
+static ec_frame_template_t *ec_master_next_frame_template(
+        ec_device_t *device, /**< EtherCAT device */
+        ec_frame_template_t *template /**< Previous template, or NULL. */
+        )
+{
+    template = list_prepare_entry(template, &device->frame_templates, list);
+    list_for_each_entry_continue(template, &device->frame_templates, list) {
+        if (ec_frame_template_ready(template)) {
+            return template;
+        }
+    }
+
+    return NULL;
+}
+
+/*****************************************************************************/
+
+/** Fills a frame template with the current datagram contents.
+ *
+ * Only the datagram indices and the payload are written. The payload is not
+ * copied, if it is referenced by a scatter-gather template. The datagrams
+ * are marked as sent, so that they are not picked up again for another
+ * frame.
+ *
+ * \return Pointer behind the last datagram of the template.
+ */
+static uint8_t *ec_master_fill_frame_template(
+        ec_master_t *master, /**< EtherCAT master */
+        ec_frame_template_t *template, /**< Frame template. */
+        struct list_head *sent_datagrams /**< List of sent datagrams. */
+        )
+{
+    ec_datagram_t *datagram = NULL;
+    uint8_t *header = NULL;
+    unsigned int i;
+
+    for (i = 0; i < template->datagram_count; i++) {
+        datagram = template->datagrams[i];
+        header = template->headers[i];
+        list_move_tail(&datagram->sent, sent_datagrams);
+        ec_master_index_datagram(master, datagram);
+        datagram->state = EC_DATAGRAM_SENT;
+
+        EC_WRITE_U8(header + 1, datagram->index);
+        if (!template->scatter_gather) {
+            memcpy(header + EC_DATAGRAM_HEADER_SIZE, datagram->data,
+                    datagram->data_size);
+        }
+    }
+
+    if (!template->scatter_gather) {
+        // reset "datagram following" flag, that may be left from appending
+        EC_WRITE_U16(header + 6, datagram->data_size & 0x7FF);
+    }
+
+    /* For scatter-gather templates, this points behind the linear part of
+     * the socket buffer. The padding is part of the last fragment. */
+    return template->skb->data + ETH_HLEN + template->size;
+}
+
+/*****************************************************************************/
+
 /** Sends the datagrams in the queue for a certain device.
  *
+ * If frame templates exist for the device (see ecrt_master_freeze_layout()),
+ * these are sent first. Any other queued datagrams are appended to the last
+ * template frame and to further frames from the transmit ring.
+ *
+ * By default, a frame is closed as soon as the next queued datagram does not
+ * fit. With frame packing enabled (see ecrt_master_pack_frames()), the rest
+ * of the queue is searched for datagrams that still fit (first-fit). As the
+ * application's datagrams are queued before the ones of the master's state
+ * machines, their placement does not depend on the acyclic traffic.
+ *
+ * All frames are sent in one burst, so that a driver supporting
+ * ecdev_set_flush() notifies the hardware only once.
  */
 size_t ec_master_send_datagrams(
         ec_master_t *master, /**< EtherCAT master */
         ec_device_index_t device_index /**< Device index. */
         )
 {
+    ec_device_t *device = &master->devices[device_index];
     ec_datagram_t *datagram, *next;
+    ec_frame_template_t *frame_template, *next_template;
     size_t datagram_size;
     uint8_t *frame_data, *cur_data = NULL;
     void *follows_word;
@@ -994,7 +1431,7 @@ size_t ec_master_send_datagrams(
     cycles_t cycles_start, cycles_sent, cycles_end;
 #endif
     unsigned long jiffies_sent;
-    unsigned int frame_count, more_datagrams_waiting;
+    unsigned int frame_count, ring_frame_count, more_datagrams_waiting;
     struct list_head sent_datagrams;
     size_t sent_bytes = 0;
 
@@ -1002,66 +1439,91 @@ size_t ec_master_send_datagrams(
     cycles_start = get_cycles();
 #endif
     frame_count = 0;
+    ring_frame_count = 0;
     INIT_LIST_HEAD(&sent_datagrams);
 
     EC_MASTER_DBG(master, 2, "%s(device_index = %u)\n",
             __func__, device_index);
 
+    frame_template = ec_master_next_frame_template(device, NULL);
+    ec_device_begin_burst(device);
+
     do {
         frame_data = NULL;
         follows_word = NULL;
         more_datagrams_waiting = 0;
+        next_template = NULL;
+
+        if (frame_template) {
+            // prebuilt frame
+            next_template =
+                ec_master_next_frame_template(device, frame_template);
+            frame_data = frame_template->skb->data + ETH_HLEN;
+            cur_data = ec_master_fill_frame_template(master,
+                    frame_template, &sent_datagrams);
+            follows_word =
+                frame_template->headers[frame_template->datagram_count - 1]
+                + 6;
+        }
 
-        // fill current frame with datagrams
-        list_for_each_entry(datagram, &master->datagram_queue, queue) {
-            if (datagram->state != EC_DATAGRAM_QUEUED ||
-                    datagram->device_index != device_index) {
-                continue;
-            }
+        if (next_template) {
+            // further prebuilt frames are pending
+            more_datagrams_waiting = 1;
+        } else if (frame_template && frame_template->scatter_gather) {
+            // nothing can be appended, use a frame from the ring
+            more_datagrams_waiting = 1;
+        } else {
+            // fill current frame with datagrams
+            list_for_each_entry(datagram, &master->datagram_queue, queue) {
+                if (datagram->state != EC_DATAGRAM_QUEUED ||
+                        datagram->device_index != device_index) {
+                    continue;
+                }
 
-            if (!frame_data) {
-                // fetch pointer to transmit socket buffer
-                frame_data =
-                    ec_device_tx_data(&master->devices[device_index]);
-                cur_data = frame_data + EC_FRAME_HEADER_SIZE;
-            }
+                if (!frame_data) {
+                    // fetch pointer to transmit socket buffer
+                    frame_data = ec_device_tx_data(device);
+                    cur_data = frame_data + EC_FRAME_HEADER_SIZE;
+                }
 
-            // does the current datagram fit in the frame?
-            datagram_size = EC_DATAGRAM_HEADER_SIZE + datagram->data_size
-                + EC_DATAGRAM_FOOTER_SIZE;
-            if (cur_data - frame_data + datagram_size > ETH_DATA_LEN) {
-                more_datagrams_waiting = 1;
-                break;
-            }
+                // does the current datagram fit in the frame?
+                datagram_size = EC_DATAGRAM_HEADER_SIZE + datagram->data_size
+                    + EC_DATAGRAM_FOOTER_SIZE;
+                if (cur_data - frame_data + datagram_size > ETH_DATA_LEN) {
+                    more_datagrams_waiting = 1;
+                    if (master->pack_frames) {
+                        // try to fill the gap with a later datagram
+                        continue;
+                    }
+                    break;
+                }
 
-            list_add_tail(&datagram->sent, &sent_datagrams);
-            datagram->index = master->datagram_index++;
+                list_move_tail(&datagram->sent, &sent_datagrams);
+                ec_master_index_datagram(master, datagram);
 
-            EC_MASTER_DBG(master, 2, "Adding datagram 0x%02X\n",
-                    datagram->index);
+                // set "datagram following" flag in previous datagram
+                if (follows_word) {
+                    EC_WRITE_U16(follows_word,
+                            EC_READ_U16(follows_word) | 0x8000);
+                }
 
-            // set "datagram following" flag in previous datagram
-            if (follows_word) {
-                EC_WRITE_U16(follows_word,
-                        EC_READ_U16(follows_word) | 0x8000);
+                // EtherCAT datagram header
+                EC_WRITE_U8 (cur_data, datagram->type);
+                EC_WRITE_U8 (cur_data + 1, datagram->index);
+                memcpy(cur_data + 2, datagram->address, EC_ADDR_LEN);
+                EC_WRITE_U16(cur_data + 6, datagram->data_size & 0x7FF);
+                EC_WRITE_U16(cur_data + 8, 0x0000);
+                follows_word = cur_data + 6;
+                cur_data += EC_DATAGRAM_HEADER_SIZE;
+
+                // EtherCAT datagram data
+                memcpy(cur_data, datagram->data, datagram->data_size);
+                cur_data += datagram->data_size;
+
+                // EtherCAT datagram footer
+                EC_WRITE_U16(cur_data, 0x0000); // reset working counter
+                cur_data += EC_DATAGRAM_FOOTER_SIZE;
             }
-
-            // EtherCAT datagram header
-            EC_WRITE_U8 (cur_data, datagram->type);
-            EC_WRITE_U8 (cur_data + 1, datagram->index);
-            memcpy(cur_data + 2, datagram->address, EC_ADDR_LEN);
-            EC_WRITE_U16(cur_data + 6, datagram->data_size & 0x7FF);
-            EC_WRITE_U16(cur_data + 8, 0x0000);
-            follows_word = cur_data + 6;
-            cur_data += EC_DATAGRAM_HEADER_SIZE;
-
-            // EtherCAT datagram data
-            memcpy(cur_data, datagram->data, datagram->data_size);
-            cur_data += datagram->data_size;
-
-            // EtherCAT datagram footer
-            EC_WRITE_U16(cur_data, 0x0000); // reset working counter
-            cur_data += EC_DATAGRAM_FOOTER_SIZE;
         }
 
         if (list_empty(&sent_datagrams)) {
@@ -1080,8 +1542,13 @@ size_t ec_master_send_datagrams(
         EC_MASTER_DBG(master, 2, "frame size: %zu\n", cur_data - frame_data);
 
         // send frame
-        ec_device_send(&master->devices[device_index],
-                cur_data - frame_data);
+        if (frame_template) {
+            ec_device_send_frame(device, frame_template->skb,
+                    cur_data - frame_data);
+        } else {
+            ec_device_send(device, cur_data - frame_data);
+            ring_frame_count++;
+        }
         /* preamble and inter-frame gap */
         sent_bytes += ETH_HLEN + cur_data - frame_data + ETH_FCS_LEN + 20;
 #ifdef EC_HAVE_CYCLES
@@ -1096,12 +1563,17 @@ size_t ec_master_send_datagrams(
             datagram->cycles_sent = cycles_sent;
 #endif
             datagram->jiffies_sent = jiffies_sent;
-            list_del_init(&datagram->sent); // empty list of sent datagrams
+            // empty list of sent datagrams
+            list_move_tail(&datagram->sent, &master->sent_queue);
         }
 
         frame_count++;
+        frame_template = next_template;
     }
-    while (more_datagrams_waiting && frame_count < EC_TX_RING_SIZE);
+    while (more_datagrams_waiting && ring_frame_count < EC_TX_RING_SIZE);
+
+    // post all frames to the hardware
+    ec_device_end_burst(device);
 
 #ifdef EC_HAVE_CYCLES
     if (unlikely(master->debug_level > 1)) {
@@ -1116,6 +1588,31 @@ size_t ec_master_send_datagrams(
 
 /*****************************************************************************/
 
+/** Calculates the round-trip time of a received datagram.
+ *
+ * \return Time from sending to the device poll, that received the datagram,
+ *         in nanoseconds.
+ */
+static uint32_t ec_master_datagram_rtt(
+        const ec_device_t *device, /**< EtherCAT device. */
+        const ec_datagram_t *datagram /**< Received datagram. */
+        )
+{
+    u64 time_ns;
+
+#ifdef EC_HAVE_CYCLES
+    time_ns = div_u64((u64) (device->cycles_poll - datagram->cycles_sent)
+            * 1000000, cpu_khz);
+#else
+    time_ns = (u64) (device->jiffies_poll - datagram->jiffies_sent)
+        * (1000000000 / HZ);
+#endif
+
+    return time_ns > 0xffffffff ? 0xffffffff : (uint32_t) time_ns;
+}
+
+/*****************************************************************************/
+
 /** Processes a received frame.
  *
  * This function is called by the network driver for every received frame.
@@ -1131,9 +1628,10 @@ void ec_master_receive_datagrams(
 {
     size_t frame_size, data_size;
     uint8_t datagram_type, datagram_index;
-    unsigned int cmd_follows, matched;
+    unsigned int cmd_follows;
     const uint8_t *cur_data;
     ec_datagram_t *datagram;
+    uint32_t rtt;
 
     if (unlikely(size < EC_FRAME_HEADER_SIZE)) {
         if (master->debug_level || FORCE_OUTPUT_CORRUPTED) {
@@ -1194,20 +1692,15 @@ void ec_master_receive_datagrams(
             return;
         }
 
-        // search for matching datagram in the queue
-        matched = 0;
-        list_for_each_entry(datagram, &master->datagram_queue, queue) {
-            if (datagram->index == datagram_index
-                && datagram->state == EC_DATAGRAM_SENT
-                && datagram->type == datagram_type
-                && datagram->data_size == data_size) {
-                matched = 1;
-                break;
-            }
-        }
+        // look up matching datagram in the index table
+        datagram = master->datagram_by_index[datagram_index];
 
         // no matching datagram was found
-        if (!matched) {
+        if (!datagram
+                || datagram->index != datagram_index
+                || datagram->state != EC_DATAGRAM_SENT
+                || datagram->type != datagram_type
+                || datagram->data_size != data_size) {
             master->stats.unmatched++;
 #ifdef EC_RT_SYSLOG
             ec_master_output_stats(master);
@@ -1242,6 +1735,7 @@ void ec_master_receive_datagrams(
         cur_data += EC_DATAGRAM_FOOTER_SIZE;
 
         // dequeue the received datagram
+        master->datagram_by_index[datagram_index] = NULL;
         datagram->state = EC_DATAGRAM_RECEIVED;
 #ifdef EC_HAVE_CYCLES
         datagram->cycles_received =
@@ -1250,11 +1744,33 @@ void ec_master_receive_datagrams(
         datagram->jiffies_received =
             master->devices[EC_DEVICE_MAIN].jiffies_poll;
         list_del_init(&datagram->queue);
+        list_del_init(&datagram->sent);
+
+        // update the round-trip time statistics
+        rtt = ec_master_datagram_rtt(device, datagram);
+        ec_latency_add(&device->latency, rtt);
+        if (datagram->latency) {
+            ec_latency_add(datagram->latency, rtt);
+        }
     }
 }
 
 /*****************************************************************************/
 
+/** Requests a reset of the latency statistics.
+ *
+ * The statistics are updated in the realtime context. To not race with these
+ * updates, the reset is executed there, too: The round-trip times are reset
+ * by the next ecrt_master_receive(), the scheduler statistics by the next
+ * injection of acyclic datagrams.
+ */
+void ec_master_reset_latency(ec_master_t *master /**< EtherCAT master */)
+{
+    master->latency_reset_seq++;
+}
+
+/*****************************************************************************/
+
 /** Output master statistics.
  *
  * This function outputs statistical data on demand, but not more often than
@@ -1283,6 +1799,13 @@ void ec_master_output_stats(ec_master_t *master /**< EtherCAT master */)
                     master->stats.unmatched == 1 ? "" : "s");
             master->stats.unmatched = 0;
         }
+        if (master->stats.index_collisions) {
+            EC_MASTER_WARN(master, "%u datagram index collision%s"
+                    " (index space wrapped)!\n",
+                    master->stats.index_collisions,
+                    master->stats.index_collisions == 1 ? "" : "s");
+            master->stats.index_collisions = 0;
+        }
     }
 }
 
@@ -1444,6 +1967,11 @@ void ec_master_nanosleep(const unsigned long nsecs)
 /*****************************************************************************/
 
 /** Execute slave FSMs.
+ *
+ * Every FSM in the execution list owns a datagram from the pool and
+ * proceeds as soon as its datagram was answered, independent of the
+ * others. The datagrams are handed over to the acyclic datagram scheduler
+ * in batches.
  */
 void ec_master_exec_slave_fsms(
         ec_master_t *master /**< EtherCAT master. */
@@ -1451,30 +1979,27 @@ void ec_master_exec_slave_fsms(
 {
     ec_datagram_t *datagram;
     ec_fsm_slave_t *fsm, *next;
-    unsigned int count = 0;
+    unsigned int count = 0, submitted = 0;
+
+    if (master->ext_seq_rt != master->ext_seq_fsm) {
+        // the realtime side did not take over the last batch yet
+        return;
+    }
 
     list_for_each_entry_safe(fsm, next, &master->fsm_exec_list, list) {
-        if (!fsm->datagram) {
+        datagram = fsm->datagram;
+        if (!datagram) {
             EC_MASTER_WARN(master, "Slave %u FSM has zero datagram."
                     "This is a bug!\n", fsm->slave->ring_position);
             list_del_init(&fsm->list);
             master->fsm_exec_count--;
-            return;
+            continue;
         }
 
-        if (fsm->datagram->state == EC_DATAGRAM_INIT ||
-                fsm->datagram->state == EC_DATAGRAM_QUEUED ||
-                fsm->datagram->state == EC_DATAGRAM_SENT) {
+        if (datagram->state == EC_DATAGRAM_INIT ||
+                datagram->state == EC_DATAGRAM_QUEUED ||
+                datagram->state == EC_DATAGRAM_SENT) {
             // previous datagram was not sent or received yet.
-            // wait until next thread execution
-            return;
-        }
-
-        datagram = ec_master_get_external_datagram(master);
-        if (!datagram) {
-            // no free datagrams at the moment
-            EC_MASTER_WARN(master, "No free datagram during"
-                    " slave FSM execution. This is a bug!\n");
             continue;
         }
 
@@ -1488,13 +2013,14 @@ void ec_master_exec_slave_fsms(
             EC_MASTER_DBG(master, 1, "FSM consumed datagram %s\n",
                     datagram->name);
 #endif
-            master->ext_ring_idx_fsm =
-                (master->ext_ring_idx_fsm + 1) % EC_EXT_RING_SIZE;
+            ec_master_submit_ext_datagram(master, fsm, datagram);
+            submitted = 1;
         }
         else {
             // FSM finished
             list_del_init(&fsm->list);
             master->fsm_exec_count--;
+            ec_master_free_ext_datagram(master, datagram);
 #if DEBUG_INJECT
             EC_MASTER_DBG(master, 1, "FSM finished. %u remaining.\n",
                     master->fsm_exec_count);
@@ -1502,17 +2028,18 @@ void ec_master_exec_slave_fsms(
         }
     }
 
-    while (master->fsm_exec_count < EC_EXT_RING_SIZE / 2
-            && count < master->slave_count) {
+    while (count < master->slave_count) {
+        fsm = &master->fsm_slave->fsm;
 
-        if (ec_fsm_slave_is_ready(&master->fsm_slave->fsm)) {
-            datagram = ec_master_get_external_datagram(master);
+        if (ec_fsm_slave_is_ready(fsm)) {
+            if (!(datagram = ec_master_alloc_ext_datagram(master))) {
+                break;
+            }
 
-            if (ec_fsm_slave_exec(&master->fsm_slave->fsm, datagram)) {
-                master->ext_ring_idx_fsm =
-                    (master->ext_ring_idx_fsm + 1) % EC_EXT_RING_SIZE;
-                list_add_tail(&master->fsm_slave->fsm.list,
-                        &master->fsm_exec_list);
+            if (ec_fsm_slave_exec(fsm, datagram)) {
+                ec_master_submit_ext_datagram(master, fsm, datagram);
+                submitted = 1;
+                list_add_tail(&fsm->list, &master->fsm_exec_list);
                 master->fsm_exec_count++;
 #if DEBUG_INJECT
                 EC_MASTER_DBG(master, 1, "New slave %u FSM"
@@ -1521,6 +2048,9 @@ void ec_master_exec_slave_fsms(
                         master->fsm_exec_count);
 #endif
             }
+            else {
+                ec_master_free_ext_datagram(master, datagram);
+            }
         }
 
         master->fsm_slave++;
@@ -1529,6 +2059,12 @@ void ec_master_exec_slave_fsms(
         }
         count++;
     }
+
+    if (submitted) {
+        // let the realtime side take over the datagrams, see
+        // ec_master_inject_external_datagrams()
+        master->ext_seq_fsm++;
+    }
 }
 
 /*****************************************************************************/
@@ -1570,7 +2106,7 @@ static int ec_master_idle_thread(void *priv_data)
         // queue and send
         down(&master->io_sem);
         if (fsm_exec) {
-            ec_master_queue_datagram(master, &master->fsm_datagram);
+            ec_fsm_master_queue_datagrams(&master->fsm);
         }
         sent_bytes = ecrt_master_send(master);
         up(&master->io_sem);
@@ -2301,6 +2837,200 @@ ec_domain_t *ecrt_master_create_domain(
 
 /*****************************************************************************/
 
+/** Determines, how the payload of a domain datagram gets into its frame
+ * template, depending on the domain's memory mode.
+ *
+ * \return Payload handling.
+ */
+static ec_frame_payload_t ec_master_frame_payload(
+        const ec_device_t *device, /**< EtherCAT device */
+        const ec_datagram_pair_t *pair, /**< Datagram pair. */
+        ec_device_index_t dev_idx /**< Device index. */
+        )
+{
+    const ec_domain_t *domain = pair->domain;
+
+    switch (domain->memory_mode) {
+        case EC_DOMAIN_MEMORY_SCATTER_GATHER:
+            if (device->dev && (device->dev->features & NETIF_F_SG)
+                    && ec_frame_template_can_reference(
+                        &pair->datagrams[dev_idx])) {
+                return EC_FRAME_PAYLOAD_REFERENCE;
+            }
+            // fall through
+        default:
+            return EC_FRAME_PAYLOAD_COPY;
+    }
+}
+
+/*****************************************************************************/
+
+/** Checks, if a domain is the first one of its cycle group.
+ *
+ * Domains with the same cycle divisor and phase (see
+ * ecrt_domain_set_cycle_divisor()) are queued in the same cycles.
+ *
+ * \return Non-zero, if no domain created before has the same divisor and
+ *         phase.
+ */
+static int ec_master_first_of_cycle_group(
+        const ec_master_t *master, /**< EtherCAT master */
+        const ec_domain_t *domain /**< Domain. */
+        )
+{
+    const ec_domain_t *other;
+
+    list_for_each_entry(other, &master->domains, list) {
+        if (other == domain) {
+            return 1;
+        }
+        if (other->cycle_divisor == domain->cycle_divisor
+                && other->cycle_phase == domain->cycle_phase) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*****************************************************************************/
+
+/** Builds the frame templates for the domains of a cycle group.
+ *
+ * The datagrams of the domains are packed in the order of their creation
+ * into prebuilt frames. Datagrams with referenced payload go into separate
+ * scatter-gather frames.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static int ec_master_build_group_templates(
+        ec_master_t *master, /**< EtherCAT master */
+        ec_device_index_t dev_idx, /**< Device index. */
+        const ec_domain_t *group, /**< First domain of the cycle group. */
+        unsigned int *template_count /**< Number of built templates. */
+        )
+{
+    ec_device_t *device = &master->devices[dev_idx];
+    ec_domain_t *domain;
+    ec_datagram_pair_t *pair;
+    ec_datagram_t *datagram;
+    ec_frame_template_t *template = NULL;
+    ec_frame_payload_t payload;
+    unsigned int sg;
+    int ret;
+
+    list_for_each_entry(domain, &master->domains, list) {
+        if (domain->cycle_divisor != group->cycle_divisor
+                || domain->cycle_phase != group->cycle_phase) {
+            continue;
+        }
+
+        list_for_each_entry(pair, &domain->datagram_pairs, list) {
+            datagram = &pair->datagrams[dev_idx];
+            payload = ec_master_frame_payload(device, pair, dev_idx);
+            sg = payload == EC_FRAME_PAYLOAD_REFERENCE;
+
+            if (payload == EC_FRAME_PAYLOAD_COPY &&
+                    domain->memory_mode != EC_DOMAIN_MEMORY_COPY) {
+                EC_MASTER_WARN(master, "Domain%u: Payload of datagram"
+                        " %s has to be copied.\n",
+                        domain->index, datagram->name);
+            }
+
+            if (template && template->scatter_gather == sg &&
+                    !ec_frame_template_add_datagram(template, datagram)) {
+                continue;
+            }
+
+            if (template) {
+                ec_frame_template_finish(template);
+            }
+
+            if (!(template = kmalloc(sizeof(ec_frame_template_t),
+                            GFP_KERNEL))) {
+                EC_MASTER_ERR(master, "Failed to allocate"
+                        " frame template!\n");
+                return -ENOMEM;
+            }
+
+            ret = ec_frame_template_init(template, device->dev, sg);
+            if (ret < 0) {
+                EC_MASTER_ERR(master, "Failed to init frame template!\n");
+                kfree(template);
+                return ret;
+            }
+
+            list_add_tail(&template->list, &device->frame_templates);
+            (*template_count)++;
+
+            // a domain datagram always fits into an empty frame
+            ret = ec_frame_template_add_datagram(template, datagram);
+            if (ret < 0) {
+                EC_MASTER_ERR(master, "Failed to add datagram"
+                        " to frame template!\n");
+                return ret;
+            }
+        }
+    }
+
+    if (template) {
+        ec_frame_template_finish(template);
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** Builds the frame templates for the domain datagrams.
+ *
+ * The templates are built separately for each device and for each cycle
+ * group. Domains with different cycle divisors or phases (see
+ * ecrt_domain_set_cycle_divisor()) never share a frame, so that every
+ * template is complete in the cycles, in which its group is queued by
+ * ecrt_master_queue_domains().
+ *
+ * In case of an error, the templates built so far are kept until the
+ * configuration is cleared.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static int ec_master_build_frame_templates(
+        ec_master_t *master /**< EtherCAT master */
+        )
+{
+    ec_device_index_t dev_idx;
+    ec_domain_t *group;
+    unsigned int template_count;
+    int ret;
+
+    for (dev_idx = EC_DEVICE_MAIN; dev_idx < ec_master_num_devices(master);
+            dev_idx++) {
+        template_count = 0;
+
+        list_for_each_entry(group, &master->domains, list) {
+            if (!ec_master_first_of_cycle_group(master, group)) {
+                continue;
+            }
+
+            ret = ec_master_build_group_templates(master, dev_idx, group,
+                    &template_count);
+            if (ret < 0) {
+                return ret;
+            }
+        }
+
+        EC_MASTER_DBG(master, 1, "Built %u frame template%s for %s"
+                " device.\n", template_count,
+                template_count == 1 ? "" : "s",
+                ec_device_names[dev_idx != EC_DEVICE_MAIN]);
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+
 int ecrt_master_activate(ec_master_t *master)
 {
     uint32_t domain_offset;
@@ -2331,6 +3061,16 @@ int ecrt_master_activate(ec_master_t *master)
         domain_offset += domain->data_size;
     }
 
+    if (master->freeze_layout) {
+        down(&master->io_sem);
+        ret = ec_master_build_frame_templates(master);
+        up(&master->io_sem);
+        if (ret < 0) {
+            up(&master->master_sem);
+            return ret;
+        }
+    }
+
     up(&master->master_sem);
 
     // restart EoE process and master thread with new locking
@@ -2451,15 +3191,17 @@ size_t ecrt_master_send(ec_master_t *master)
     ec_datagram_t *datagram, *n;
     ec_device_index_t dev_idx;
     size_t sent_bytes = 0;
+    u64 tx_count = master->devices[EC_DEVICE_MAIN].tx_count;
 
 
     if (master->injection_seq_rt != master->injection_seq_fsm) {
-        // inject datagram produced by master FSM
-        ec_master_queue_datagram(master, &master->fsm_datagram);
+        // inject datagrams produced by master FSM
+        ec_fsm_master_queue_datagrams(&master->fsm);
         master->injection_seq_rt = master->injection_seq_fsm;
     }
 
     ec_master_inject_external_datagrams(master);
+    ec_master_queue_mbox_status(master);
 
     for (dev_idx = EC_DEVICE_MAIN; dev_idx < ec_master_num_devices(master);
             dev_idx++) {
@@ -2468,8 +3210,13 @@ size_t ecrt_master_send(ec_master_t *master)
             list_for_each_entry_safe(datagram, n,
                     &master->datagram_queue, queue) {
                 if (datagram->device_index == dev_idx) {
+                    if (master->datagram_by_index[datagram->index]
+                            == datagram) {
+                        master->datagram_by_index[datagram->index] = NULL;
+                    }
                     datagram->state = EC_DATAGRAM_ERROR;
                     list_del_init(&datagram->queue);
+                    list_del_init(&datagram->sent);
                 }
             }
 
@@ -2490,6 +3237,12 @@ size_t ecrt_master_send(ec_master_t *master)
             ec_master_send_datagrams(master, dev_idx));
     }
 
+    master->cycle_frames =
+        master->devices[EC_DEVICE_MAIN].tx_count - tx_count;
+    if (master->cycle_frames > master->max_cycle_frames) {
+        master->max_cycle_frames = master->cycle_frames;
+    }
+
     return sent_bytes;
 }
 
@@ -2499,6 +3252,19 @@ void ecrt_master_receive(ec_master_t *master)
 {
     unsigned int dev_idx;
     ec_datagram_t *datagram, *next;
+    ec_domain_t *domain;
+
+    // apply a reset requested via ec_master_reset_latency()
+    if (master->latency_reset_rx != master->latency_reset_seq) {
+        for (dev_idx = EC_DEVICE_MAIN;
+                dev_idx < ec_master_num_devices(master); dev_idx++) {
+            ec_latency_reset(&master->devices[dev_idx].latency);
+        }
+        list_for_each_entry(domain, &master->domains, list) {
+            ec_latency_reset(&domain->latency);
+        }
+        master->latency_reset_rx = master->latency_reset_seq;
+    }
 
     // receive datagrams
     for (dev_idx = EC_DEVICE_MAIN; dev_idx < ec_master_num_devices(master);
@@ -2507,41 +3273,59 @@ void ecrt_master_receive(ec_master_t *master)
     }
     ec_master_update_device_stats(master);
 
-    // dequeue all datagrams that timed out
-    list_for_each_entry_safe(datagram, next, &master->datagram_queue, queue) {
-        if (datagram->state != EC_DATAGRAM_SENT) continue;
+    /* Dequeue the datagrams that timed out. The sent queue is ordered by
+     * the sending time, so only the oldest datagrams have to be inspected.
+     */
+    list_for_each_entry_safe(datagram, next, &master->sent_queue, sent) {
+        if (datagram->state != EC_DATAGRAM_SENT) {
+            // re-queued or re-initialized meanwhile
+            list_del_init(&datagram->sent);
+            continue;
+        }
 
 #ifdef EC_HAVE_CYCLES
         if (master->devices[EC_DEVICE_MAIN].cycles_poll -
-                datagram->cycles_sent > timeout_cycles) {
+                datagram->cycles_sent <= timeout_cycles) {
 #else
         if (master->devices[EC_DEVICE_MAIN].jiffies_poll -
-                datagram->jiffies_sent > timeout_jiffies) {
+                datagram->jiffies_sent <= timeout_jiffies) {
 #endif
-            list_del_init(&datagram->queue);
-            datagram->state = EC_DATAGRAM_TIMED_OUT;
-            master->stats.timeouts++;
+            break;
+        }
+
+        if (master->datagram_by_index[datagram->index] == datagram) {
+            master->datagram_by_index[datagram->index] = NULL;
+        }
+        list_del_init(&datagram->queue);
+        list_del_init(&datagram->sent);
+        datagram->state = EC_DATAGRAM_TIMED_OUT;
+        master->stats.timeouts++;
 
 #ifdef EC_RT_SYSLOG
-            ec_master_output_stats(master);
+        ec_master_output_stats(master);
 
-            if (unlikely(master->debug_level > 0)) {
-                unsigned int time_us;
+        if (unlikely(master->debug_level > 0)) {
+            unsigned int time_us;
 #ifdef EC_HAVE_CYCLES
-                time_us = (unsigned int)
-                    (master->devices[EC_DEVICE_MAIN].cycles_poll -
-                        datagram->cycles_sent) * 1000 / cpu_khz;
+            time_us = (unsigned int)
+                (master->devices[EC_DEVICE_MAIN].cycles_poll -
+                    datagram->cycles_sent) * 1000 / cpu_khz;
 #else
-                time_us = (unsigned int)
-                    ((master->devices[EC_DEVICE_MAIN].jiffies_poll -
-                            datagram->jiffies_sent) * 1000000 / HZ);
+            time_us = (unsigned int)
+                ((master->devices[EC_DEVICE_MAIN].jiffies_poll -
+                        datagram->jiffies_sent) * 1000000 / HZ);
 #endif
-                EC_MASTER_DBG(master, 0, "TIMED OUT datagram %p,"
-                        " index %02X waited %u us.\n",
-                        datagram, datagram->index, time_us);
-            }
-#endif /* RT_SYSLOG */
+            EC_MASTER_DBG(master, 0, "TIMED OUT datagram %p,"
+                    " index %02X waited %u us.\n",
+                    datagram, datagram->index, time_us);
         }
+#endif /* RT_SYSLOG */
+    }
+
+    ec_master_process_mbox_status(master);
+
+    if (master->status) {
+        ec_master_publish_state(master);
     }
 }
 
@@ -2553,7 +3337,7 @@ void ecrt_master_send_ext(ec_master_t *master)
 
     list_for_each_entry_safe(datagram, next, &master->ext_datagram_queue,
             queue) {
-        list_del(&datagram->queue);
+        list_del_init(&datagram->queue);
         ec_master_queue_datagram(master, datagram);
     }
 
@@ -2743,6 +3527,128 @@ void ecrt_master_callbacks(ec_master_t *master,
 
 /*****************************************************************************/
 
+int ecrt_master_cycle(ec_master_t *master, const ec_cycle_t *cycle)
+{
+    unsigned int i;
+
+    if (cycle->steps & EC_CYCLE_RECEIVE) {
+        ecrt_master_receive(master);
+    }
+
+    if (cycle->steps & EC_CYCLE_DOMAIN_PROCESS) {
+        for (i = 0; i < cycle->domain_count; i++) {
+            ecrt_domain_process(cycle->domains[i]);
+        }
+    }
+
+    if (cycle->steps & EC_CYCLE_PROCESS_DOMAINS) {
+        ecrt_master_process_domains(master);
+    }
+
+    if ((cycle->steps & EC_CYCLE_DOMAIN_STATE) && cycle->domain_states) {
+        for (i = 0; i < cycle->domain_count; i++) {
+            ecrt_domain_state(cycle->domains[i], &cycle->domain_states[i]);
+        }
+    }
+
+    if (cycle->steps & EC_CYCLE_APP_TIME) {
+        ecrt_master_application_time(master, cycle->app_time);
+    }
+
+    if (cycle->steps & EC_CYCLE_SYNC_REF_CLOCK) {
+        ecrt_master_sync_reference_clock(master);
+    }
+
+    if (cycle->steps & EC_CYCLE_SYNC_SLAVE_CLOCKS) {
+        ecrt_master_sync_slave_clocks(master);
+    }
+
+    if (cycle->steps & EC_CYCLE_DOMAIN_QUEUE) {
+        for (i = 0; i < cycle->domain_count; i++) {
+            ecrt_domain_queue(cycle->domains[i]);
+        }
+    }
+
+    if (cycle->steps & EC_CYCLE_QUEUE_DOMAINS) {
+        ecrt_master_queue_domains(master);
+    }
+
+    if (cycle->steps & EC_CYCLE_SEND) {
+        ecrt_master_send(master);
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+
+void ecrt_master_queue_domains(ec_master_t *master)
+{
+    ec_domain_t *domain;
+
+    list_for_each_entry(domain, &master->domains, list) {
+        if (domain->cycle_counter == domain->cycle_phase) {
+            ecrt_domain_queue(domain);
+            domain->due = 1;
+        }
+
+        // counting modulo the divisor keeps the phase on overflow
+        if (++domain->cycle_counter == domain->cycle_divisor) {
+            domain->cycle_counter = 0;
+        }
+    }
+}
+
+/*****************************************************************************/
+
+void ecrt_master_process_domains(ec_master_t *master)
+{
+    ec_domain_t *domain;
+
+    list_for_each_entry(domain, &master->domains, list) {
+        if (domain->due) {
+            ecrt_domain_process(domain);
+            domain->due = 0;
+        }
+    }
+}
+
+/*****************************************************************************/
+
+int ecrt_master_freeze_layout(ec_master_t *master, uint8_t freeze)
+{
+    EC_MASTER_DBG(master, 1, "%s(master = 0x%p, freeze = %u)\n",
+            __func__, master, freeze);
+
+    if (master->active) {
+        EC_MASTER_ERR(master, "Frame layout can only be frozen"
+                " before activation!\n");
+        return -EBUSY;
+    }
+
+    master->freeze_layout = freeze ? 1 : 0;
+    return 0;
+}
+
+/*****************************************************************************/
+
+int ecrt_master_pack_frames(ec_master_t *master, uint8_t pack)
+{
+    EC_MASTER_DBG(master, 1, "%s(master = 0x%p, pack = %u)\n",
+            __func__, master, pack);
+
+    if (master->active) {
+        EC_MASTER_ERR(master, "Frame packing can only be selected"
+                " before activation!\n");
+        return -EBUSY;
+    }
+
+    master->pack_frames = pack ? 1 : 0;
+    return 0;
+}
+
+/*****************************************************************************/
+
 void ecrt_master_state(const ec_master_t *master, ec_master_state_t *state)
 {
     ec_device_index_t dev_idx;
@@ -3022,24 +3928,33 @@ int ecrt_master_sdo_download_complete(ec_master_t *master,
 
 /*****************************************************************************/
 
-int ecrt_master_sdo_upload(ec_master_t *master, uint16_t slave_position,
-        uint16_t index, uint8_t subindex, uint8_t *target,
-        size_t target_size, size_t *result_size, uint32_t *abort_code)
+/** Executes an SDO upload request and waits for the result.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static int ec_master_sdo_upload(
+        ec_master_t *master, /**< EtherCAT master. */
+        uint16_t slave_position, /**< Slave position. */
+        uint16_t index, /**< Index of the SDO. */
+        uint8_t subindex, /**< Subindex of the SDO. */
+        int complete_access, /**< Upload the SDO via complete access. */
+        uint8_t *target, /**< Target buffer for the upload. */
+        size_t target_size, /**< Size of the target buffer. */
+        size_t *result_size, /**< Uploaded data size. */
+        uint32_t *abort_code /**< Abort code of the SDO upload. */
+        )
 {
     ec_sdo_request_t request;
     ec_slave_t *slave;
     int ret = 0;
 
-    EC_MASTER_DBG(master, 1, "%s(master = 0x%p,"
-            " slave_position = %u, index = 0x%04X, subindex = 0x%02X,"
-            " target = 0x%p, target_size = %zu, result_size = 0x%p,"
-            " abort_code = 0x%p)\n",
-            __func__, master, slave_position, index, subindex,
-            target, target_size, result_size, abort_code);
-
     ec_sdo_request_init(&request);
     ecrt_sdo_request_index(&request, index, subindex);
-    ecrt_sdo_request_read(&request);
+    if (complete_access) {
+        ecrt_sdo_request_read_complete(&request);
+    } else {
+        ecrt_sdo_request_read(&request);
+    }
 
     if (down_interruptible(&master->master_sem)) {
         ec_sdo_request_clear(&request);
@@ -3105,6 +4020,40 @@ int ecrt_master_sdo_upload(ec_master_t *master, uint16_t slave_position,
 
 /*****************************************************************************/
 
+int ecrt_master_sdo_upload(ec_master_t *master, uint16_t slave_position,
+        uint16_t index, uint8_t subindex, uint8_t *target,
+        size_t target_size, size_t *result_size, uint32_t *abort_code)
+{
+    EC_MASTER_DBG(master, 1, "%s(master = 0x%p,"
+            " slave_position = %u, index = 0x%04X, subindex = 0x%02X,"
+            " target = 0x%p, target_size = %zu, result_size = 0x%p,"
+            " abort_code = 0x%p)\n",
+            __func__, master, slave_position, index, subindex,
+            target, target_size, result_size, abort_code);
+
+    return ec_master_sdo_upload(master, slave_position, index, subindex, 0,
+            target, target_size, result_size, abort_code);
+}
+
+/*****************************************************************************/
+
+int ecrt_master_sdo_upload_complete(ec_master_t *master,
+        uint16_t slave_position, uint16_t index, uint8_t *target,
+        size_t target_size, size_t *result_size, uint32_t *abort_code)
+{
+    EC_MASTER_DBG(master, 1, "%s(master = 0x%p,"
+            " slave_position = %u, index = 0x%04X,"
+            " target = 0x%p, target_size = %zu, result_size = 0x%p,"
+            " abort_code = 0x%p)\n",
+            __func__, master, slave_position, index,
+            target, target_size, result_size, abort_code);
+
+    return ec_master_sdo_upload(master, slave_position, index, 0, 1,
+            target, target_size, result_size, abort_code);
+}
+
+/*****************************************************************************/
+
 int ecrt_master_write_idn(ec_master_t *master, uint16_t slave_position,
         uint8_t drive_no, uint16_t idn, uint8_t *data, size_t data_size,
         uint16_t *error_code)
@@ -3285,8 +4234,13 @@ EXPORT_SYMBOL(ecrt_master_activate);
 EXPORT_SYMBOL(ecrt_master_deactivate);
 EXPORT_SYMBOL(ecrt_master_send);
 EXPORT_SYMBOL(ecrt_master_send_ext);
+EXPORT_SYMBOL(ecrt_master_cycle);
 EXPORT_SYMBOL(ecrt_master_receive);
 EXPORT_SYMBOL(ecrt_master_callbacks);
+EXPORT_SYMBOL(ecrt_master_freeze_layout);
+EXPORT_SYMBOL(ecrt_master_pack_frames);
+EXPORT_SYMBOL(ecrt_master_queue_domains);
+EXPORT_SYMBOL(ecrt_master_process_domains);
 EXPORT_SYMBOL(ecrt_master);
 EXPORT_SYMBOL(ecrt_master_get_slave);
 EXPORT_SYMBOL(ecrt_master_slave_config);
@@ -3302,6 +4256,7 @@ EXPORT_SYMBOL(ecrt_master_sync_monitor_process);
 EXPORT_SYMBOL(ecrt_master_sdo_download);
 EXPORT_SYMBOL(ecrt_master_sdo_download_complete);
 EXPORT_SYMBOL(ecrt_master_sdo_upload);
+EXPORT_SYMBOL(ecrt_master_sdo_upload_complete);
 EXPORT_SYMBOL(ecrt_master_write_idn);
 EXPORT_SYMBOL(ecrt_master_read_idn);
 EXPORT_SYMBOL(ecrt_master_reset);
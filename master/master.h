@@ -54,6 +54,10 @@
 #include "ethernet.h"
 #include "fsm_master.h"
 #include "cdev.h"
+#include "ioctl.h"
+#include "sii_cache.h"
+#include "dict_cache.h"
+#include "ext_scheduler.h"
 
 #ifdef EC_RTDM
 #include "rtdm.h"
@@ -117,11 +121,11 @@
     } while (0)
 
 
-/** Size of the external datagram ring.
+/** Number of different datagram indices.
  *
- * The external datagram ring is used for slave FSMs.
+ * The datagram index is an 8-bit header field.
  */
-#define EC_EXT_RING_SIZE 32
+#define EC_DATAGRAM_INDEX_COUNT 256
 
 /*****************************************************************************/
 
@@ -145,6 +149,9 @@ typedef struct {
     unsigned int corrupted; /**< corrupted frames */
     unsigned int unmatched; /**< unmatched datagrams (received, but not
                                queued any longer) */
+    unsigned int index_collisions; /**< datagram indices re-used while the
+                                     previous datagram with the same index
+                                     was still in flight */
     unsigned long output_jiffies; /**< time of last output */
 } ec_stats_t;
 
@@ -246,6 +253,22 @@ struct ec_master {
                                        monitoring. */
     ec_slave_config_t *dc_ref_config; /**< Application-selected DC reference
                                         clock slave config. */
+    unsigned int boot_mbox_size; /**< Minimum size of the bootstrap receive
+                                   mailbox (module parameter). */
+    unsigned int mbox_status; /**< Poll the mailbox states via the mailbox
+                                status area (module parameter). */
+    unsigned int mbox_status_count; /**< Number of slaves with a configured
+                                      mailbox status FMMU. */
+    unsigned int mbox_status_wc; /**< Expected working counter of the
+                                   mailbox status datagram in flight. */
+    ec_datagram_t mbox_status_datagram; /**< Datagram used for reading the
+                                          mailbox status area. */
+    struct list_head mbox_check_queue; /**< Mailbox check datagrams waiting
+                                         for the next mailbox status
+                                         datagram. */
+    struct list_head mbox_check_sent; /**< Mailbox check datagrams answered
+                                        by the mailbox status datagram in
+                                        flight. */
     ec_slave_t *dc_ref_clock; /**< DC reference clock slave. */
 
     unsigned int scan_busy; /**< Current scan state. */
@@ -262,19 +285,38 @@ struct ec_master {
                                       slave configuration. */
 
     struct list_head datagram_queue; /**< Datagram queue. */
+    struct list_head sent_queue; /**< Sent datagrams in sending order, so
+                                   that timeouts can be detected without
+                                   walking the whole datagram queue. */
     uint8_t datagram_index; /**< Current datagram index. */
+    ec_datagram_t *datagram_by_index[EC_DATAGRAM_INDEX_COUNT]; /**< Sent
+                                              datagrams, looked up by their
+                                              datagram index. */
 
     struct list_head ext_datagram_queue; /**< Queue for non-application
                                            datagrams. */
     struct semaphore ext_queue_sem; /**< Semaphore protecting the \a
                                       ext_datagram_queue. */
 
-    ec_datagram_t ext_datagram_ring[EC_EXT_RING_SIZE]; /**< External datagram
-                                                         ring. */
-    unsigned int ext_ring_idx_rt; /**< Index in external datagram ring for RT
-                                    side. */
-    unsigned int ext_ring_idx_fsm; /**< Index in external datagram ring for
-                                     FSM side. */
+    struct list_head ext_datagrams; /**< Datagram pool for the slave FSMs
+                                      (unused datagrams first). */
+    unsigned int ext_datagram_count; /**< Number of datagrams in the pool. */
+    struct list_head ext_submitted[EC_EXT_CLASS_COUNT]; /**< Datagrams
+                                                          submitted by the
+                                                          slave FSMs, per
+                                                          class. */
+    unsigned int ext_seq_fsm; /**< Datagram submission sequence number for
+                                the FSM side. */
+    unsigned int ext_seq_rt; /**< Datagram submission sequence number for
+                               the realtime side. */
+    ec_ext_scheduler_t ext_scheduler; /**< Acyclic datagram scheduler. */
+    unsigned int latency_reset_seq; /**< Incremented to request a reset of
+                                      the latency statistics. */
+    unsigned int latency_reset_rx; /**< Reset request applied by
+                                     ecrt_master_receive(). */
+    unsigned int latency_reset_tx; /**< Reset request applied by
+                                     ec_master_inject_external_datagrams().
+                                     */
     unsigned int send_interval; /**< Interval between two calls to
                                   ecrt_master_send(). */
     size_t max_queue_size; /**< Maximum size of datagram queue */
@@ -303,8 +345,25 @@ struct ec_master {
     void (*app_receive_cb)(void *); /**< Application's receive datagrams
                                       callback. */
     void *app_cb_data; /**< Application callback data. */
+    uint8_t freeze_layout; /**< Build frame templates for the domain
+                             datagrams on activation (see
+                             ecrt_master_freeze_layout()). */
+    uint8_t pack_frames; /**< Fill frames first-fit instead of in queue
+                           order (see ecrt_master_pack_frames()). */
+    unsigned int cycle_frames; /**< Frames sent on the main device by the
+                                 last ecrt_master_send(). */
+    unsigned int max_cycle_frames; /**< Maximum of \a cycle_frames. */
+    ec_ioctl_status_t *status; /**< Status area in the memory mapped to user
+                                 space, or NULL (see
+                                 ec_master_set_status()). */
+    unsigned int status_domain_count; /**< Number of domain entries in the
+                                        status area. */
+    unsigned int status_config_count; /**< Number of slave configuration
+                                        entries in the status area. */
 
     struct list_head sii_requests; /**< SII write requests. */
+    ec_sii_cache_t sii_cache; /**< SII images of scanned slaves. */
+    ec_dict_cache_t dict_cache; /**< SDO dictionaries of scanned slaves. */
     struct list_head emerg_reg_requests; /**< Emergency register access
                                            requests. */
 
@@ -319,7 +378,8 @@ void ec_master_init_static(void);
 
 // master creation/deletion
 int ec_master_init(ec_master_t *, unsigned int, const uint8_t *,
-        const uint8_t *, dev_t, struct class *, unsigned int);
+        const uint8_t *, dev_t, struct class *, unsigned int, unsigned int,
+        unsigned int, unsigned int, unsigned int);
 void ec_master_clear(ec_master_t *);
 
 /** Number of Ethernet devices.
@@ -347,6 +407,7 @@ void ec_master_receive_datagrams(ec_master_t *, ec_device_t *,
         const uint8_t *, size_t);
 void ec_master_queue_datagram(ec_master_t *, ec_datagram_t *);
 void ec_master_queue_datagram_ext(ec_master_t *, ec_datagram_t *);
+void ec_master_release_datagram(ec_master_t *, const ec_datagram_t *);
 
 // misc.
 void ec_master_set_send_interval(ec_master_t *, unsigned int);
@@ -356,6 +417,7 @@ ec_slave_t *ec_master_find_slave(ec_master_t *, uint16_t, uint16_t);
 const ec_slave_t *ec_master_find_slave_const(const ec_master_t *, uint16_t,
         uint16_t);
 void ec_master_output_stats(ec_master_t *);
+void ec_master_reset_latency(ec_master_t *);
 #ifdef EC_EOE
 void ec_master_clear_eoe_handlers(ec_master_t *);
 #endif
@@ -384,6 +446,10 @@ ec_slave_config_t *ecrt_master_slave_config_err(ec_master_t *, uint16_t,
 void ec_master_calc_dc(ec_master_t *);
 void ec_master_request_op(ec_master_t *);
 
+void ec_master_set_status(ec_master_t *, ec_ioctl_status_t *,
+        unsigned int, unsigned int);
+void ec_master_publish_domain_state(ec_master_t *, ec_domain_t *);
+
 void ec_master_internal_send_cb(void *);
 void ec_master_internal_receive_cb(void *);
 
@@ -59,6 +59,14 @@ static unsigned int master_count; /**< Number of masters. */
 static char *backup_devices[MAX_MASTERS]; /**< Backup devices parameter. */
 static unsigned int backup_count; /**< Number of backup devices. */
 static unsigned int debug_level;  /**< Debug level parameter. */
+static unsigned int scan_parallel = 1; /**< Number of slaves to scan in
+                                         parallel. */
+static unsigned int config_parallel = 1; /**< Maximum number of slaves to
+                                           configure in parallel. */
+static unsigned int mbox_status; /**< Poll the mailbox states via the
+                                   mailbox status area. */
+static unsigned int boot_mbox_size; /**< Minimum size of the bootstrap
+                                      receive mailbox. */
 
 static ec_master_t *masters; /**< Array of masters. */
 static struct semaphore master_sem; /**< Master semaphore. */
@@ -85,6 +93,17 @@ module_param_array(backup_devices, charp, &backup_count, S_IRUGO);
 MODULE_PARM_DESC(backup_devices, "MAC addresses of backup devices");
 module_param_named(debug_level, debug_level, uint, S_IRUGO);
 MODULE_PARM_DESC(debug_level, "Debug level");
+module_param_named(scan_parallel, scan_parallel, uint, S_IRUGO);
+MODULE_PARM_DESC(scan_parallel, "Number of slaves to scan in parallel");
+module_param_named(config_parallel, config_parallel, uint, S_IRUGO);
+MODULE_PARM_DESC(config_parallel,
+        "Maximum number of slaves to configure in parallel");
+module_param_named(mbox_status, mbox_status, uint, S_IRUGO);
+MODULE_PARM_DESC(mbox_status,
+        "Poll the mailbox states of all slaves with one datagram");
+module_param_named(boot_mbox_size, boot_mbox_size, uint, S_IRUGO);
+MODULE_PARM_DESC(boot_mbox_size,
+        "Minimum size of the bootstrap receive mailbox (0 = SII)");
 
 /** \endcond */
 
@@ -150,7 +169,8 @@ int __init ec_init_module(void)
 
     for (i = 0; i < master_count; i++) {
         ret = ec_master_init(&masters[i], i, macs[i][0], macs[i][1],
-                    device_number, class, debug_level);
+                    device_number, class, debug_level, scan_parallel,
+                    config_parallel, mbox_status, boot_mbox_size);
         if (ret)
             goto out_free_masters;
     }
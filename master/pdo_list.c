@@ -110,6 +110,45 @@ uint16_t ec_pdo_list_total_size(
 
 /*****************************************************************************/
 
+/** Calculates the natural alignment of the mapped PDO entries.
+ *
+ * The alignment is the size of the largest multi-byte entry, that is
+ * naturally aligned within the PDO list, so that it stays aligned, if the
+ * list is placed at a multiple of the returned value.
+ *
+ * \return Alignment in byte (1, 2, 4 or 8).
+ */
+unsigned int ec_pdo_list_alignment(
+        const ec_pdo_list_t *pl /**< PDO list. */
+        )
+{
+    const ec_pdo_t *pdo;
+    const ec_pdo_entry_t *pdo_entry;
+    unsigned int bit_offset = 0, alignment = 1;
+
+    list_for_each_entry(pdo, &pl->list, list) {
+        list_for_each_entry(pdo_entry, &pdo->entries, list) {
+            switch (pdo_entry->bit_length) {
+                case 16:
+                case 32:
+                case 64:
+                    if (!(bit_offset % pdo_entry->bit_length)
+                            && pdo_entry->bit_length / 8 > alignment) {
+                        alignment = pdo_entry->bit_length / 8;
+                    }
+                    break;
+                default:
+                    break;
+            }
+            bit_offset += pdo_entry->bit_length;
+        }
+    }
+
+    return alignment;
+}
+
+/*****************************************************************************/
+
 /** Add a new PDO to the list.
  *
  * \return Pointer to new PDO, otherwise an ERR_PTR() code.
@@ -63,6 +63,7 @@ int ec_pdo_list_add_pdo_copy(ec_pdo_list_t *, const ec_pdo_t *);
 int ec_pdo_list_copy(ec_pdo_list_t *, const ec_pdo_list_t *);
 
 uint16_t ec_pdo_list_total_size(const ec_pdo_list_t *);
+unsigned int ec_pdo_list_alignment(const ec_pdo_list_t *);
 int ec_pdo_list_equal(const ec_pdo_list_t *, const ec_pdo_list_t *);
 
 ec_pdo_t *ec_pdo_list_find_pdo(const ec_pdo_list_t *, uint16_t);
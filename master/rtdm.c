@@ -154,6 +154,7 @@ int ec_rtdm_open(
     ctx->ioctl_ctx.requested = 0;
     ctx->ioctl_ctx.process_data = NULL;
     ctx->ioctl_ctx.process_data_size = 0;
+    ctx->ioctl_ctx.foe_read = NULL;
 
 #if DEBUG
     EC_MASTER_INFO(rtdm_dev->master, "RTDM device %s opened.\n",
@@ -176,6 +177,8 @@ int ec_rtdm_close(
     ec_rtdm_context_t *ctx = (ec_rtdm_context_t *) context->dev_private;
     ec_rtdm_dev_t *rtdm_dev = (ec_rtdm_dev_t *) context->device->device_data;
 
+    ec_ioctl_clear_foe_read(rtdm_dev->master, &ctx->ioctl_ctx);
+
     if (ctx->ioctl_ctx.requested) {
         ecrt_release_master(rtdm_dev->master);
 	}
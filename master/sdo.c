@@ -60,6 +60,57 @@ void ec_sdo_init(
 
 /*****************************************************************************/
 
+/** Copy constructor.
+ *
+ * The SDO is cleared again, if copying fails.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_sdo_init_copy(
+        ec_sdo_t *sdo, /**< SDO. */
+        ec_slave_t *slave, /**< Parent slave. */
+        const ec_sdo_t *other /**< SDO to copy from. */
+        )
+{
+    const ec_sdo_entry_t *other_entry;
+    ec_sdo_entry_t *entry;
+    size_t size;
+    int ret;
+
+    ec_sdo_init(sdo, slave, other->index);
+    sdo->object_code = other->object_code;
+    sdo->max_subindex = other->max_subindex;
+
+    if (other->name) {
+        size = strlen(other->name) + 1;
+        if (!(sdo->name = kmalloc(size, GFP_KERNEL))) {
+            return -ENOMEM;
+        }
+        memcpy(sdo->name, other->name, size);
+    }
+
+    list_for_each_entry(other_entry, &other->entries, list) {
+        if (!(entry = kmalloc(sizeof(ec_sdo_entry_t), GFP_KERNEL))) {
+            ec_sdo_clear(sdo);
+            return -ENOMEM;
+        }
+
+        ret = ec_sdo_entry_init_copy(entry, sdo, other_entry);
+        if (ret) {
+            ec_sdo_entry_clear(entry);
+            kfree(entry);
+            ec_sdo_clear(sdo);
+            return ret;
+        }
+
+        list_add_tail(&entry->list, &sdo->entries);
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+
 /** SDO destructor.
  *
  * Clears and frees an SDO object.
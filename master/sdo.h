@@ -59,6 +59,7 @@ struct ec_sdo {
 /*****************************************************************************/
 
 void ec_sdo_init(ec_sdo_t *, ec_slave_t *, uint16_t);
+int ec_sdo_init_copy(ec_sdo_t *, ec_slave_t *, const ec_sdo_t *);
 void ec_sdo_clear(ec_sdo_t *);
 
 ec_sdo_entry_t *ec_sdo_get_entry(ec_sdo_t *, uint8_t);
@@ -35,6 +35,7 @@
 /*****************************************************************************/
 
 #include <linux/slab.h>
+#include <linux/string.h>
 
 #include "sdo_entry.h"
 
@@ -63,6 +64,40 @@ void ec_sdo_entry_init(
 
 /*****************************************************************************/
 
+/** Copy constructor.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_sdo_entry_init_copy(
+        ec_sdo_entry_t *entry, /**< SDO entry. */
+        ec_sdo_t *sdo, /**< Parent SDO. */
+        const ec_sdo_entry_t *other /**< SDO entry to copy from. */
+        )
+{
+    unsigned int i;
+    size_t size;
+
+    ec_sdo_entry_init(entry, sdo, other->subindex);
+    entry->data_type = other->data_type;
+    entry->bit_length = other->bit_length;
+    for (i = 0; i < EC_SDO_ENTRY_ACCESS_COUNT; i++) {
+        entry->read_access[i] = other->read_access[i];
+        entry->write_access[i] = other->write_access[i];
+    }
+
+    if (other->description) {
+        size = strlen(other->description) + 1;
+        if (!(entry->description = kmalloc(size, GFP_KERNEL))) {
+            return -ENOMEM;
+        }
+        memcpy(entry->description, other->description, size);
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+
 /** Destructor.
  */
 void ec_sdo_entry_clear(
@@ -65,6 +65,8 @@ typedef struct {
 /*****************************************************************************/
 
 void ec_sdo_entry_init(ec_sdo_entry_t *, ec_sdo_t *, uint8_t);
+int ec_sdo_entry_init_copy(ec_sdo_entry_t *, ec_sdo_t *,
+        const ec_sdo_entry_t *);
 void ec_sdo_entry_clear(ec_sdo_entry_t *);
 
 /*****************************************************************************/
@@ -221,13 +221,36 @@ ec_request_state_t ecrt_sdo_request_state(const ec_sdo_request_t *req)
 
 /*****************************************************************************/
 
-void ecrt_sdo_request_read(ec_sdo_request_t *req)
+/** Queues an SDO upload.
+ *
+ * The request is set to queued last, because the master thread may pick it
+ * up as soon as it is.
+ */
+static void ec_sdo_request_queue_read(
+        ec_sdo_request_t *req, /**< SDO request. */
+        uint8_t complete_access /**< Upload with complete access. */
+        )
 {
+    req->complete_access = complete_access;
     req->dir = EC_DIR_INPUT;
-    req->state = EC_INT_REQUEST_QUEUED;
     req->errno = 0;
     req->abort_code = 0x00000000;
     req->jiffies_start = jiffies;
+    req->state = EC_INT_REQUEST_QUEUED;
+}
+
+/*****************************************************************************/
+
+void ecrt_sdo_request_read(ec_sdo_request_t *req)
+{
+    ec_sdo_request_queue_read(req, 0);
+}
+
+/*****************************************************************************/
+
+void ecrt_sdo_request_read_complete(ec_sdo_request_t *req)
+{
+    ec_sdo_request_queue_read(req, 1);
 }
 
 /*****************************************************************************/
@@ -251,6 +274,7 @@ EXPORT_SYMBOL(ecrt_sdo_request_data);
 EXPORT_SYMBOL(ecrt_sdo_request_data_size);
 EXPORT_SYMBOL(ecrt_sdo_request_state);
 EXPORT_SYMBOL(ecrt_sdo_request_read);
+EXPORT_SYMBOL(ecrt_sdo_request_read_complete);
 EXPORT_SYMBOL(ecrt_sdo_request_write);
 
 /** \endcond */
@@ -0,0 +1,226 @@
+/******************************************************************************
+ *
+ *  $Id$
+ *
+ *  Copyright (C) 2006-2012  Florian Pose, Ingenieurgemeinschaft IgH
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  The license mentioned above concerns the source code only. Using the
+ *  EtherCAT technology and brand is only permitted in compliance with the
+ *  industrial property and similar rights of Beckhoff Automation GmbH.
+ *
+ *****************************************************************************/
+
+
+/**
+   \file
+   EtherCAT SII image cache methods.
+*/
+
+/*****************************************************************************/
+
+#include <linux/slab.h>
+#include <linux/string.h>
+
+#include "sii_cache.h"
+
+/*****************************************************************************/
+
+/** SII image cache constructor.
+ */
+void ec_sii_cache_init(
+        ec_sii_cache_t *cache /**< SII image cache. */
+        )
+{
+    INIT_LIST_HEAD(&cache->images);
+    cache->count = 0;
+}
+
+/*****************************************************************************/
+
+/** Removes an image from the cache and frees it.
+ */
+static void ec_sii_cache_remove(
+        ec_sii_cache_t *cache, /**< SII image cache. */
+        ec_sii_image_t *image /**< Cached image. */
+        )
+{
+    list_del(&image->list);
+    kfree(image->words);
+    kfree(image);
+    cache->count--;
+}
+
+/*****************************************************************************/
+
+/** SII image cache destructor.
+ *
+ * Frees all cached images.
+ */
+void ec_sii_cache_clear(
+        ec_sii_cache_t *cache /**< SII image cache. */
+        )
+{
+    ec_sii_image_t *image, *next;
+
+    list_for_each_entry_safe(image, next, &cache->images, list) {
+        ec_sii_cache_remove(cache, image);
+    }
+}
+
+/*****************************************************************************/
+
+/** Searches an image by its identity words.
+ *
+ * The vendor ID, product code, revision number and serial number are
+ * compared first. An image only matches, if all identity words are equal,
+ * so that a changed alias or ESC configuration is detected, too.
+ *
+ * \return Cached image, or NULL.
+ */
+static ec_sii_image_t *ec_sii_cache_lookup(
+        const ec_sii_cache_t *cache, /**< SII image cache. */
+        const uint16_t *identity /**< First #EC_SII_IDENTITY_WORDS words of
+                                   the SII contents. */
+        )
+{
+    ec_sii_image_t *image;
+    uint32_t vendor_id = EC_READ_U32(identity + 0x0008),
+             product_code = EC_READ_U32(identity + 0x000A),
+             revision_number = EC_READ_U32(identity + 0x000C),
+             serial_number = EC_READ_U32(identity + 0x000E);
+
+    list_for_each_entry(image, &cache->images, list) {
+        if (image->vendor_id == vendor_id
+                && image->product_code == product_code
+                && image->revision_number == revision_number
+                && image->serial_number == serial_number
+                && !memcmp(image->words, identity,
+                    EC_SII_IDENTITY_WORDS * sizeof(uint16_t))) {
+            return image;
+        }
+    }
+
+    return NULL;
+}
+
+/*****************************************************************************/
+
+/** Searches an image by its identity words.
+ *
+ * \return Cached image, or NULL.
+ */
+const ec_sii_image_t *ec_sii_cache_find(
+        const ec_sii_cache_t *cache, /**< SII image cache. */
+        const uint16_t *identity /**< First #EC_SII_IDENTITY_WORDS words of
+                                   the SII contents. */
+        )
+{
+    return ec_sii_cache_lookup(cache, identity);
+}
+
+/*****************************************************************************/
+
+/** Gets an image by its position in the cache.
+ *
+ * \return Cached image, or NULL.
+ */
+const ec_sii_image_t *ec_sii_cache_get(
+        const ec_sii_cache_t *cache, /**< SII image cache. */
+        unsigned int index /**< Image index. */
+        )
+{
+    const ec_sii_image_t *image;
+
+    list_for_each_entry(image, &cache->images, list) {
+        if (!index--) {
+            return image;
+        }
+    }
+
+    return NULL;
+}
+
+/*****************************************************************************/
+
+/** Adds a copy of an SII image to the cache.
+ *
+ * An image with the same identity words is replaced. If the cache is full,
+ * the oldest image is dropped.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_sii_cache_add(
+        ec_sii_cache_t *cache, /**< SII image cache. */
+        const uint16_t *words, /**< SII contents. */
+        size_t nwords /**< Size of the SII contents in words. */
+        )
+{
+    ec_sii_image_t *image;
+
+    if (nwords < EC_SII_IDENTITY_WORDS || nwords > EC_MAX_SII_SIZE) {
+        return -EINVAL;
+    }
+
+    if ((image = ec_sii_cache_lookup(cache, words))) {
+        ec_sii_cache_remove(cache, image);
+    } else if (cache->count >= EC_SII_CACHE_MAX_IMAGES) {
+        ec_sii_cache_remove(cache, list_entry(cache->images.next,
+                    ec_sii_image_t, list));
+    }
+
+    if (!(image = kmalloc(sizeof(ec_sii_image_t), GFP_KERNEL))) {
+        return -ENOMEM;
+    }
+
+    if (!(image->words = kmalloc(nwords * sizeof(uint16_t), GFP_KERNEL))) {
+        kfree(image);
+        return -ENOMEM;
+    }
+
+    memcpy(image->words, words, nwords * sizeof(uint16_t));
+    image->nwords = nwords;
+    image->vendor_id = EC_READ_U32(words + 0x0008);
+    image->product_code = EC_READ_U32(words + 0x000A);
+    image->revision_number = EC_READ_U32(words + 0x000C);
+    image->serial_number = EC_READ_U32(words + 0x000E);
+
+    list_add_tail(&image->list, &cache->images);
+    cache->count++;
+    return 0;
+}
+
+/*****************************************************************************/
+
+/** Removes the image with the given identity words from the cache.
+ */
+void ec_sii_cache_invalidate(
+        ec_sii_cache_t *cache, /**< SII image cache. */
+        const uint16_t *identity /**< First #EC_SII_IDENTITY_WORDS words of
+                                   the SII contents. */
+        )
+{
+    ec_sii_image_t *image;
+
+    if ((image = ec_sii_cache_lookup(cache, identity))) {
+        ec_sii_cache_remove(cache, image);
+    }
+}
+
+/*****************************************************************************/
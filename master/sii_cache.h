@@ -0,0 +1,98 @@
+/******************************************************************************
+ *
+ *  $Id$
+ *
+ *  Copyright (C) 2006-2012  Florian Pose, Ingenieurgemeinschaft IgH
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  The license mentioned above concerns the source code only. Using the
+ *  EtherCAT technology and brand is only permitted in compliance with the
+ *  industrial property and similar rights of Beckhoff Automation GmbH.
+ *
+ *****************************************************************************/
+
+
+/**
+   \file
+   EtherCAT SII image cache.
+*/
+
+/*****************************************************************************/
+
+#ifndef __EC_SII_CACHE_H__
+#define __EC_SII_CACHE_H__
+
+#include <linux/list.h>
+
+#include "globals.h"
+
+/*****************************************************************************/
+
+/** Number of SII words identifying an SII image.
+ *
+ * The words contain the ESC configuration, the alias and the vendor ID,
+ * product code, revision number and serial number.
+ */
+#define EC_SII_IDENTITY_WORDS 16
+
+/** Maximum number of cached SII images.
+ */
+#define EC_SII_CACHE_MAX_IMAGES 256
+
+/*****************************************************************************/
+
+/** Cached SII image.
+ */
+typedef struct {
+    struct list_head list; /**< List item. */
+    uint32_t vendor_id; /**< Vendor ID. */
+    uint32_t product_code; /**< Product code. */
+    uint32_t revision_number; /**< Revision number. */
+    uint32_t serial_number; /**< Serial number. */
+    uint16_t *words; /**< SII contents. */
+    size_t nwords; /**< Size of the SII contents in words. */
+} ec_sii_image_t;
+
+/** SII image cache.
+ *
+ * Once the complete SII contents of a slave have been read, they are kept
+ * in the cache. On a later scan, only the identity words have to be read
+ * from a slave with an identical image. The cache is kept over bus scans and
+ * can be saved and loaded from user space.
+ */
+typedef struct {
+    struct list_head images; /**< Cached images, the oldest first. */
+    unsigned int count; /**< Number of cached images. */
+} ec_sii_cache_t;
+
+/*****************************************************************************/
+
+void ec_sii_cache_init(ec_sii_cache_t *);
+void ec_sii_cache_clear(ec_sii_cache_t *);
+
+const ec_sii_image_t *ec_sii_cache_find(const ec_sii_cache_t *,
+        const uint16_t *);
+const ec_sii_image_t *ec_sii_cache_get(const ec_sii_cache_t *,
+        unsigned int);
+int ec_sii_cache_add(ec_sii_cache_t *, const uint16_t *, size_t);
+void ec_sii_cache_invalidate(ec_sii_cache_t *, const uint16_t *);
+
+/*****************************************************************************/
+
+#endif
@@ -84,12 +84,14 @@ void ec_slave_init(
     slave->configured_rx_mailbox_size = 0x0000;
     slave->configured_tx_mailbox_offset = 0x0000;
     slave->configured_tx_mailbox_size = 0x0000;
+    slave->mbox_status_fmmu = 0;
 
     slave->base_type = 0;
     slave->base_revision = 0;
     slave->base_build = 0;
     slave->base_fmmu_count = 0;
     slave->base_sync_count = 0;
+    slave->base_ram_size = 0;
 
     for (i = 0; i < EC_MAX_PORTS; i++) {
         slave->ports[i].desc = EC_PORT_NOT_IMPLEMENTED;
@@ -221,6 +221,8 @@ struct ec_slave
     uint16_t configured_tx_mailbox_offset; /**< Configured send mailbox
                                              offset. */
     uint16_t configured_tx_mailbox_size; /**< Configured send mailbox size. */
+    unsigned int mbox_status_fmmu; /**< The SM1 status is mapped into the
+                                     master's mailbox status area. */
 
     // base data
     uint8_t base_type; /**< Slave type. */
@@ -228,6 +230,7 @@ struct ec_slave
     uint16_t base_build; /**< Build number. */
     uint8_t base_fmmu_count; /**< Number of supported FMMUs. */
     uint8_t base_sync_count; /**< Number of supported sync managers. */
+    uint8_t base_ram_size; /**< Size of the process memory [KiB]. */
     uint8_t base_fmmu_bit_operation; /**< FMMU bit operation is supported. */
     uint8_t base_dc_supported; /**< Distributed clocks are supported. */
     ec_slave_dc_range_t base_dc_range; /**< DC range. */
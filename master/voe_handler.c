@@ -96,6 +96,7 @@ void ec_voe_handler_clear(
         ec_voe_handler_t *voe /**< VoE handler. */
         )
 {
+    ec_master_release_datagram(voe->config->master, &voe->datagram);
     ec_datagram_clear(&voe->datagram);
 }
 
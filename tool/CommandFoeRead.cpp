@@ -31,6 +31,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <fstream>
 using namespace std;
 
 #include "CommandFoeRead.h"
@@ -56,6 +57,8 @@ string CommandFoeRead::helpString(const string &binaryBaseName) const
         << getBriefDescription() << endl
         << endl
         << "This command requires a single slave to be selected." << endl
+        << "The data are written out while they are received, so the" << endl
+        << "file size is not limited." << endl
         << endl
         << "Arguments:" << endl
         << "  SOURCEFILE is the name of the source file on the slave." << endl
@@ -80,8 +83,10 @@ void CommandFoeRead::execute(const StringVector &args)
     SlaveList slaves;
     ec_ioctl_slave_t *slave;
     ec_ioctl_slave_foe_t data;
-    unsigned int i;
     stringstream err;
+    ofstream file;
+    ostream *out = &cout;
+    size_t received = 0;
 
     if (args.size() != 1) {
         err << "'" << getName() << "' takes exactly one argument!";
@@ -98,41 +103,75 @@ void CommandFoeRead::execute(const StringVector &args)
     slave = &slaves.front();
     data.slave_position = slave->position;
 
-    /* FIXME: No good idea to have a fixed buffer size.
-     * Read in chunks and fill a buffer instead.
-     */
+    if (!getOutputFile().empty() && getOutputFile() != "-") {
+        file.open(getOutputFile().c_str(), ios::out | ios::binary);
+        if (!file) {
+            err << "Failed to open '" << getOutputFile() << "'!";
+            throwCommandException(err);
+        }
+        out = &file;
+    }
+
+    /* The file is streamed in chunks, so the buffer size does not limit the
+     * file size. */
     data.offset = 0;
     data.buffer_size = 0x8800;
     data.buffer = new uint8_t[data.buffer_size];
 
     strncpy(data.file_name, args[0].c_str(), sizeof(data.file_name));
 
-    try {
-        m.readFoe(&data);
-    } catch (MasterDeviceException &e) {
-        delete [] data.buffer;
-        if (data.result) {
-            if (data.result == FOE_OPCODE_ERROR) {
-                err << "FoE read aborted with error code 0x"
-                    << setw(8) << setfill('0') << hex << data.error_code
-                    << ": " << errorText(data.error_code);
-            } else {
-                err << "Failed to write via FoE: "
-                    << resultText(data.result);
+    do {
+        // a failing call must not report the result of an earlier chunk
+        data.result = FOE_BUSY;
+        data.error_code = 0;
+
+        try {
+            m.readFoe(&data);
+        } catch (MasterDeviceException &e) {
+            delete [] data.buffer;
+            if (!data.result && !received) {
+                throw e;
             }
-            throwCommandException(err);
-        } else {
-            throw e;
+            throwReadError(data, e.what(), received);
+        }
+
+        out->write((const char *) data.buffer, data.data_size);
+        received += data.data_size;
+
+        if (data.result) {
+            delete [] data.buffer;
+            throwReadError(data, "", received);
         }
+    } while (data.data_size);
+
+    delete [] data.buffer;
+}
+
+/*****************************************************************************/
+
+void CommandFoeRead::throwReadError(
+        const ec_ioctl_slave_foe_t &data,
+        const string &reason,
+        size_t received
+        )
+{
+    stringstream err;
+
+    if (data.result == FOE_OPCODE_ERROR) {
+        err << "FoE read aborted with error code 0x"
+            << setw(8) << setfill('0') << hex << data.error_code
+            << ": " << errorText(data.error_code) << "." << dec;
+    } else if (data.result) {
+        err << "Failed to read via FoE: " << resultText(data.result) << ".";
+    } else {
+        err << reason << ".";
     }
 
-    // TODO --output-file
-    for (i = 0; i < data.data_size; i++) {
-        uint8_t *w = data.buffer + i;
-        cout << *(uint8_t *) w ;
+    if (received) {
+        err << " Output truncated after " << received << " bytes.";
     }
 
-    delete [] data.buffer;
+    throwCommandException(err);
 }
 
 /*****************************************************************************/
@@ -42,6 +42,10 @@ class CommandFoeRead:
 
         string helpString(const string &) const;
         void execute(const StringVector &);
+
+    protected:
+        void throwReadError(const ec_ioctl_slave_foe_t &, const string &,
+                size_t);
 };
 
 /****************************************************************************/
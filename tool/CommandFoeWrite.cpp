@@ -29,6 +29,7 @@
 
 #include <libgen.h> // basename()
 #include <string.h>
+#include <sys/time.h>
 
 #include <iostream>
 #include <iomanip>
@@ -73,6 +74,7 @@ string CommandFoeWrite::helpString(const string &binaryBaseName) const
         << "  --alias       -a <alias>" << endl
         << "  --position    -p <pos>    Slave selection. See the help" << endl
         << "                            of the 'slaves' command." << endl
+        << "  --quiet       -q          Do not report the throughput." << endl
         << endl
         << numericInfo();
 
@@ -88,6 +90,8 @@ void CommandFoeWrite::execute(const StringVector &args)
     ifstream file;
     SlaveList slaves;
     string storeFileName;
+    struct timeval start, end;
+    double seconds;
 
     if (args.size() != 1) {
         err << "'" << getName() << "' takes exactly one argument!";
@@ -142,6 +146,8 @@ void CommandFoeWrite::execute(const StringVector &args)
     data.offset = 0;
     strncpy(data.file_name, storeFileName.c_str(), sizeof(data.file_name));
 
+    gettimeofday(&start, NULL);
+
     try {
         m.writeFoe(&data);
     } catch (MasterDeviceException &e) {
@@ -162,10 +168,24 @@ void CommandFoeWrite::execute(const StringVector &args)
         }
     }
 
+    gettimeofday(&end, NULL);
+    seconds = (end.tv_sec - start.tv_sec)
+        + (end.tv_usec - start.tv_usec) / 1e6;
+
     if (getVerbosity() == Verbose) {
         cerr << "FoE writing finished." << endl;
     }
 
+    if (getVerbosity() != Quiet) {
+        cerr << "Wrote " << data.buffer_size << " bytes in "
+            << fixed << setprecision(3) << seconds << " s";
+        if (seconds > 0.0) {
+            cerr << " (" << setprecision(0)
+                << data.buffer_size / seconds << " bytes/s)";
+        }
+        cerr << "." << endl;
+    }
+
     if (data.buffer_size)
         delete [] data.buffer;
 }
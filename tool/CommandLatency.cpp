@@ -0,0 +1,218 @@
+/*****************************************************************************
+ *
+ *  $Id$
+ *
+ *  Copyright (C) 2006-2009  Florian Pose, Ingenieurgemeinschaft IgH
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  The license mentioned above concerns the source code only. Using the
+ *  EtherCAT technology and brand is only permitted in compliance with the
+ *  industrial property and similar rights of Beckhoff Automation GmbH.
+ *
+ *  vim: expandtab
+ *
+ ****************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+using namespace std;
+
+#include "CommandLatency.h"
+#include "MasterDevice.h"
+
+/*****************************************************************************/
+
+CommandLatency::CommandLatency():
+    Command("latency", "Show datagram round-trip time statistics.")
+{
+}
+
+/*****************************************************************************/
+
+string CommandLatency::helpString(const string &binaryBaseName) const
+{
+    stringstream str;
+
+    str << binaryBaseName << " " << getName() << " [OPTIONS] [reset]" << endl
+        << endl
+        << getBriefDescription() << endl
+        << endl
+        << "The round-trip time of a datagram is measured from sending" << endl
+        << "to the poll of the device, that received it. Statistics are" << endl
+        << "displayed for each Ethernet device and for the datagrams" << endl
+        << "of each domain. Example:" << endl
+        << endl
+        << "Domain0:" << endl
+        << "  Datagrams: 100000" << endl
+        << "  Min/Mean/Max [us]: 21.3 / 24.0 / 61.9" << endl
+        << "  Percentiles [us]: 50%: 23.1, 99%: 31.8, 99.9%: 58.2" << endl
+        << endl
+        << "The percentiles are estimated from a histogram with" << endl
+        << "logarithmically scaled buckets, that is displayed with the" << endl
+        << "--verbose option." << endl
+        << endl
+        << "If the 'reset' argument is given, all statistics are" << endl
+        << "reset, including the wait times of the acyclic datagram" << endl
+        << "queues shown by the 'master' command." << endl
+        << endl
+        << "Command-specific options:" << endl
+        << "  --master  -m <indices>  Master indices. A comma-separated" << endl
+        << "                          list with ranges is supported." << endl
+        << "                          Example: 1,4,5,7-9. Default: - (all)."
+        << endl
+        << "  --domain  -d <index>    Positive numerical domain index." << endl
+        << "                          If ommitted, all domains are" << endl
+        << "                          displayed." << endl
+        << "  --verbose -v            Show the histograms in addition." << endl
+        << endl
+        << numericInfo();
+
+    return str.str();
+}
+
+/****************************************************************************/
+
+void CommandLatency::execute(const StringVector &args)
+{
+    MasterIndexList masterIndices;
+    DomainList domains;
+    DomainList::const_iterator di;
+    unsigned int dev_idx;
+    bool reset = false;
+
+    if (args.size() > 1 || (args.size() == 1 && args[0] != "reset")) {
+        stringstream err;
+        err << "'" << getName() << "' takes only the 'reset' argument!";
+        throwInvalidUsageException(err);
+    }
+
+    reset = args.size() == 1;
+
+    masterIndices = getMasterIndices();
+    MasterIndexList::const_iterator mi;
+    for (mi = masterIndices.begin();
+            mi != masterIndices.end(); mi++) {
+        ec_ioctl_master_t io;
+        MasterDevice m(*mi);
+
+        if (reset) {
+            m.open(MasterDevice::ReadWrite);
+            m.resetLatency();
+            continue;
+        }
+
+        m.open(MasterDevice::Read);
+        m.getMaster(&io);
+
+        cout << "Master" << m.getIndex() << endl;
+
+        for (dev_idx = EC_DEVICE_MAIN; dev_idx < io.num_devices;
+                dev_idx++) {
+            showLatency(dev_idx == EC_DEVICE_MAIN ? "Main" : "Backup",
+                    io.devices[dev_idx].latency);
+        }
+
+        domains = selectedDomains(m, io);
+        for (di = domains.begin(); di != domains.end(); di++) {
+            stringstream name;
+            name << "Domain" << di->index;
+            showLatency(name.str(), di->latency);
+        }
+    }
+}
+
+/****************************************************************************/
+
+void CommandLatency::showLatency(
+        const string &name,
+        const ec_latency_t &latency
+        ) const
+{
+    ios::fmtflags flags = cout.flags();
+    streamsize precision = cout.precision();
+    unsigned int i;
+
+    cout << "  " << name << ":" << endl
+        << "    Datagrams: " << latency.count << endl;
+
+    if (!latency.count) {
+        return;
+    }
+
+    cout << setprecision(1) << fixed
+        << "    Min/Mean/Max [us]: "
+        << latency.min / 1000.0 << " / "
+        << (double) latency.sum / latency.count / 1000.0 << " / "
+        << latency.max / 1000.0 << endl
+        << "    Percentiles [us]: "
+        << "50%: " << percentile(latency, 0.5) / 1000.0
+        << ", 99%: " << percentile(latency, 0.99) / 1000.0
+        << ", 99.9%: " << percentile(latency, 0.999) / 1000.0 << endl;
+
+    if (getVerbosity() == Verbose) {
+        cout << "    Histogram [us]:" << endl;
+        for (i = 0; i < EC_LATENCY_BUCKETS; i++) {
+            if (!latency.buckets[i]) {
+                continue;
+            }
+            cout << "      " << setw(10) << (1U << i) / 1000.0
+                << " - " << setw(10) << (2.0 * (1U << i)) / 1000.0
+                << ": " << latency.buckets[i] << endl;
+        }
+    }
+
+    cout.flags(flags);
+    cout.precision(precision);
+}
+
+/****************************************************************************/
+
+double CommandLatency::percentile(
+        const ec_latency_t &latency,
+        double fraction
+        )
+{
+    double target = fraction * latency.count, lower, upper, value;
+    uint64_t sum = 0;
+    unsigned int i;
+
+    // interpolate linearly within the bucket containing the percentile
+    for (i = 0; i < EC_LATENCY_BUCKETS; i++) {
+        if (sum + latency.buckets[i] >= target && latency.buckets[i]) {
+            lower = i ? (double) (1U << i) : 0.0;
+            upper = 2.0 * (1U << i);
+            value = lower + (upper - lower)
+                * (target - sum) / latency.buckets[i];
+
+            // the bucket boundaries are coarser than the extreme values
+            if (value < latency.min) {
+                value = latency.min;
+            }
+            if (value > latency.max) {
+                value = latency.max;
+            }
+            return value;
+        }
+        sum += latency.buckets[i];
+    }
+
+    return latency.max;
+}
+
+/*****************************************************************************/
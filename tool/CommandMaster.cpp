@@ -36,6 +36,12 @@ using namespace std;
 
 #define MAX_TIME_STR_SIZE 50
 
+/** Names of the acyclic datagram classes.
+ */
+static const char *extClassNames[EC_EXT_CLASS_COUNT] = {
+    "CoE", "FoE", "SoE", "EoE", "Reg"
+};
+
 /*****************************************************************************/
 
 CommandMaster::CommandMaster():
@@ -102,6 +108,8 @@ void CommandMaster::execute(const StringVector &args)
         cout << endl
             << "  Active: " << (data.active ? "yes" : "no") << endl
             << "  Slaves: " << data.slave_count << endl
+            << "  Cached SII images: " << data.sii_cache_count << endl
+            << "  Cached SDO dictionaries: " << data.dict_cache_count << endl
             << "  Ethernet devices:" << endl;
 
         for (dev_idx = EC_DEVICE_MAIN; dev_idx < data.num_devices;
@@ -136,6 +144,10 @@ void CommandMaster::execute(const StringVector &args)
                 << data.devices[dev_idx].rx_bytes << endl
                 << "      Tx errors:   "
                 << data.devices[dev_idx].tx_errors << endl
+                << "      Tx bursts:   "
+                << data.devices[dev_idx].tx_bursts << " (last "
+                << data.devices[dev_idx].last_tx_burst << ", max "
+                << data.devices[dev_idx].max_tx_burst << " frames)" << endl
                 << "      Tx frame rate [1/s]: "
                 << setfill(' ') << setprecision(0) << fixed;
             for (j = 0; j < EC_RATE_COUNT; j++) {
@@ -192,6 +204,9 @@ void CommandMaster::execute(const StringVector &args)
             << "      Rx bytes:    "
             << data.rx_bytes << endl
             << "      Lost frames: " << lost << endl
+            << "      Cycle frames: " << data.cycle_frames << " (max "
+            << data.max_cycle_frames << ", "
+            << (data.pack_frames ? "packed" : "queue order") << ")" << endl
             << "      Tx frame rate [1/s]: "
             << setfill(' ') << setprecision(0) << fixed;
         for (j = 0; j < EC_RATE_COUNT; j++) {
@@ -256,6 +271,23 @@ void CommandMaster::execute(const StringVector &args)
         }
         cout << setprecision(0) << endl;
 
+        cout << "  Acyclic datagrams:" << endl
+            << "    Pool size: " << data.ext_datagram_count << endl;
+        for (j = 0; j < EC_EXT_CLASS_COUNT; j++) {
+            const ec_ext_queue_stats_t &queue = data.ext_queues[j];
+            cout << "    " << extClassNames[j] << ": depth " << queue.depth
+                << " (max " << queue.max_depth << "), "
+                << queue.wait.count << " injected";
+            if (queue.wait.count) {
+                cout << ", wait min/mean/max [us]: "
+                    << setprecision(1) << fixed
+                    << queue.wait.min / 1000.0 << " / "
+                    << (double) queue.wait.sum / queue.wait.count / 1000.0
+                    << " / " << queue.wait.max / 1000.0 << setprecision(0);
+            }
+            cout << endl;
+        }
+
         cout << "  Distributed clocks:" << endl
             << "    Reference clock: ";
         if (data.ref_clock != 0xffff) {
@@ -0,0 +1,265 @@
+/*****************************************************************************
+ *
+ *  $Id$
+ *
+ *  Copyright (C) 2006-2009  Florian Pose, Ingenieurgemeinschaft IgH
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  The license mentioned above concerns the source code only. Using the
+ *  EtherCAT technology and brand is only permitted in compliance with the
+ *  industrial property and similar rights of Beckhoff Automation GmbH.
+ *
+ *  vim: expandtab
+ *
+ ****************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+using namespace std;
+
+#include "CommandSdoCache.h"
+#include "MasterDevice.h"
+
+/*****************************************************************************/
+
+/** Identifies a file containing SDO dictionaries.
+ */
+#define SDO_CACHE_MAGIC "ECSDOC01"
+
+/*****************************************************************************/
+
+CommandSdoCache::CommandSdoCache():
+    Command("sdo_cache", "List, save or load the SDO dictionary cache.")
+{
+}
+
+/*****************************************************************************/
+
+string CommandSdoCache::helpString(const string &binaryBaseName) const
+{
+    stringstream str;
+
+    str << binaryBaseName << " " << getName()
+        << " [OPTIONS] [save|load <FILENAME> | clear]" << endl
+        << endl
+        << getBriefDescription() << endl
+        << endl
+        << "The master keeps the SDO dictionaries uploaded from the" << endl
+        << "slaves. Slaves with the same vendor ID, product code and" << endl
+        << "revision number share a dictionary, so that it has to be" << endl
+        << "uploaded only once, also over bus scans." << endl
+        << endl
+        << "Without arguments, the cached dictionaries are listed." << endl
+        << endl
+        << "Arguments:" << endl
+        << "  save  Save the cached dictionaries to FILENAME." << endl
+        << "  load  Add the dictionaries from FILENAME to the cache, for"
+        << endl
+        << "        example on system startup." << endl
+        << "  clear Remove all dictionaries from the cache. They are" << endl
+        << "        uploaded again after the next bus scan." << endl
+        << endl
+        << "If FILENAME is '-', stdout or stdin is used." << endl
+        << endl
+        << "Command-specific options:" << endl
+        << "  --master  -m <index>  Index of the master to use. Default: 0."
+        << endl
+        << "  --verbose -v          Print the number of processed" << endl
+        << "                        dictionaries." << endl
+        << endl
+        << numericInfo();
+
+    return str.str();
+}
+
+/****************************************************************************/
+
+void CommandSdoCache::execute(const StringVector &args)
+{
+    stringstream err;
+
+    if (args.empty()) {
+        MasterDevice m(getSingleMasterIndex());
+        m.open(MasterDevice::Read);
+        listDicts(m);
+    } else if (args.size() == 1 && args[0] == "clear") {
+        MasterDevice m(getSingleMasterIndex());
+        m.open(MasterDevice::ReadWrite);
+        m.clearDictCache();
+    } else if (args.size() == 2 && args[0] == "save") {
+        MasterDevice m(getSingleMasterIndex());
+        m.open(MasterDevice::Read);
+        if (args[1] == "-") {
+            saveDicts(m, cout);
+        } else {
+            ofstream file(args[1].c_str(), ofstream::out | ofstream::binary);
+            if (file.fail()) {
+                err << "Failed to open '" << args[1] << "'!";
+                throwCommandException(err);
+            }
+            saveDicts(m, file);
+        }
+    } else if (args.size() == 2 && args[0] == "load") {
+        MasterDevice m(getSingleMasterIndex());
+        m.open(MasterDevice::ReadWrite);
+        if (args[1] == "-") {
+            loadDicts(m, cin);
+        } else {
+            ifstream file(args[1].c_str(), ifstream::in | ifstream::binary);
+            if (file.fail()) {
+                err << "Failed to open '" << args[1] << "'!";
+                throwCommandException(err);
+            }
+            loadDicts(m, file);
+        }
+    } else {
+        err << "Invalid arguments for '" << getName() << "'!";
+        throwInvalidUsageException(err);
+    }
+}
+
+/****************************************************************************/
+
+void CommandSdoCache::listDicts(MasterDevice &m)
+{
+    ec_ioctl_master_t master;
+    ec_ioctl_dict_t data;
+    unsigned int i;
+
+    m.getMaster(&master);
+
+    for (i = 0; i < master.dict_cache_count; i++) {
+        data.data = NULL;
+        data.size = 0;
+        m.getDict(&data, i);
+
+        cout << setfill(' ') << dec << setw(3) << i << "  "
+            << hex << setfill('0')
+            << "0x" << setw(8) << data.vendor_id
+            << ":0x" << setw(8) << data.product_code
+            << "  Revision 0x" << setw(8) << data.revision_number
+            << dec << "  " << data.sdo_count << " SDOs" << endl;
+    }
+}
+
+/****************************************************************************/
+
+void CommandSdoCache::saveDicts(MasterDevice &m, ostream &out)
+{
+    ec_ioctl_master_t master;
+    ec_ioctl_dict_t data;
+    vector<uint8_t> buffer;
+    uint32_t header[4];
+    unsigned int i;
+
+    m.getMaster(&master);
+
+    out.write(SDO_CACHE_MAGIC, sizeof(SDO_CACHE_MAGIC) - 1);
+
+    for (i = 0; i < master.dict_cache_count; i++) {
+        // determine the size first
+        data.data = NULL;
+        data.size = 0;
+        m.getDict(&data, i);
+
+        buffer.resize(data.size + 1);
+        data.data = &buffer.front();
+        m.getDict(&data, i);
+
+        if (data.size >= buffer.size()) {
+            stringstream err;
+            err << "SDO dictionary " << i << " changed while saving!";
+            throwCommandException(err);
+        }
+
+        header[0] = cpu_to_le32(data.vendor_id);
+        header[1] = cpu_to_le32(data.product_code);
+        header[2] = cpu_to_le32(data.revision_number);
+        header[3] = cpu_to_le32(data.size);
+        out.write((const char *) header, sizeof(header));
+        out.write((const char *) data.data, data.size);
+    }
+
+    if (out.fail()) {
+        stringstream err;
+        err << "Failed to write SDO dictionaries!";
+        throwCommandException(err);
+    }
+
+    if (getVerbosity() == Verbose) {
+        cerr << "Saved " << master.dict_cache_count
+            << " SDO dictionaries." << endl;
+    }
+}
+
+/****************************************************************************/
+
+void CommandSdoCache::loadDicts(MasterDevice &m, const istream &in)
+{
+    stringstream err;
+    ostringstream tmp;
+    ec_ioctl_dict_t data;
+    vector<uint8_t> buffer;
+    size_t offset, magicSize = sizeof(SDO_CACHE_MAGIC) - 1;
+    unsigned int count = 0;
+    uint32_t header[4];
+
+    tmp << in.rdbuf();
+    string const &contents = tmp.str();
+
+    if (contents.compare(0, magicSize, SDO_CACHE_MAGIC)) {
+        err << "File does not contain SDO dictionaries!";
+        throwCommandException(err);
+    }
+
+    for (offset = magicSize; offset < contents.size();
+            offset += sizeof(header) + data.size) {
+        if (offset + sizeof(header) > contents.size()) {
+            err << "SDO dictionary header missing at offset "
+                << offset << "!";
+            throwCommandException(err);
+        }
+        contents.copy((char *) header, sizeof(header), offset);
+
+        data.vendor_id = le32_to_cpu(header[0]);
+        data.product_code = le32_to_cpu(header[1]);
+        data.revision_number = le32_to_cpu(header[2]);
+        data.size = le32_to_cpu(header[3]);
+
+        if (data.size > contents.size() - offset - sizeof(header)) {
+            err << "Invalid SDO dictionary at offset " << offset << "!";
+            throwCommandException(err);
+        }
+
+        buffer.resize(data.size + 1);
+        contents.copy((char *) &buffer.front(), data.size,
+                offset + sizeof(header));
+        data.data = &buffer.front();
+        m.addDict(&data);
+        count++;
+    }
+
+    if (getVerbosity() == Verbose) {
+        cerr << "Loaded " << count << " SDO dictionaries." << endl;
+    }
+}
+
+/*****************************************************************************/
@@ -0,0 +1,249 @@
+/*****************************************************************************
+ *
+ *  $Id$
+ *
+ *  Copyright (C) 2006-2009  Florian Pose, Ingenieurgemeinschaft IgH
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  ---
+ *
+ *  The license mentioned above concerns the source code only. Using the
+ *  EtherCAT technology and brand is only permitted in compliance with the
+ *  industrial property and similar rights of Beckhoff Automation GmbH.
+ *
+ *  vim: expandtab
+ *
+ ****************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+using namespace std;
+
+#include "CommandSiiCache.h"
+#include "MasterDevice.h"
+
+/*****************************************************************************/
+
+/** Identifies a file containing SII images.
+ */
+#define SII_CACHE_MAGIC "ECSIIC01"
+
+/*****************************************************************************/
+
+CommandSiiCache::CommandSiiCache():
+    Command("sii_cache", "List, save or load the SII image cache.")
+{
+}
+
+/*****************************************************************************/
+
+string CommandSiiCache::helpString(const string &binaryBaseName) const
+{
+    stringstream str;
+
+    str << binaryBaseName << " " << getName()
+        << " [OPTIONS] [save|load <FILENAME> | clear]" << endl
+        << endl
+        << getBriefDescription() << endl
+        << endl
+        << "The master keeps the SII contents of all scanned slaves." << endl
+        << "On a later bus scan, only the identity words are read from" << endl
+        << "a slave, if they match a cached image. Writing the SII of" << endl
+        << "a slave removes its image from the cache." << endl
+        << endl
+        << "Without arguments, the cached images are listed." << endl
+        << endl
+        << "Arguments:" << endl
+        << "  save  Save the cached images to FILENAME." << endl
+        << "  load  Add the images from FILENAME to the cache, for" << endl
+        << "        example on system startup. This avoids reading the" << endl
+        << "        complete SII contents on the first bus scan." << endl
+        << "  clear Remove all images from the cache." << endl
+        << endl
+        << "If FILENAME is '-', stdout or stdin is used." << endl
+        << endl
+        << "Command-specific options:" << endl
+        << "  --master  -m <index>  Index of the master to use. Default: 0."
+        << endl
+        << "  --verbose -v          Print the number of processed images."
+        << endl
+        << endl
+        << numericInfo();
+
+    return str.str();
+}
+
+/****************************************************************************/
+
+void CommandSiiCache::execute(const StringVector &args)
+{
+    stringstream err;
+
+    if (args.empty()) {
+        MasterDevice m(getSingleMasterIndex());
+        m.open(MasterDevice::Read);
+        listImages(m);
+    } else if (args.size() == 1 && args[0] == "clear") {
+        MasterDevice m(getSingleMasterIndex());
+        m.open(MasterDevice::ReadWrite);
+        m.clearSiiCache();
+    } else if (args.size() == 2 && args[0] == "save") {
+        MasterDevice m(getSingleMasterIndex());
+        m.open(MasterDevice::Read);
+        if (args[1] == "-") {
+            saveImages(m, cout);
+        } else {
+            ofstream file(args[1].c_str(), ofstream::out | ofstream::binary);
+            if (file.fail()) {
+                err << "Failed to open '" << args[1] << "'!";
+                throwCommandException(err);
+            }
+            saveImages(m, file);
+        }
+    } else if (args.size() == 2 && args[0] == "load") {
+        MasterDevice m(getSingleMasterIndex());
+        m.open(MasterDevice::ReadWrite);
+        if (args[1] == "-") {
+            loadImages(m, cin);
+        } else {
+            ifstream file(args[1].c_str(), ifstream::in | ifstream::binary);
+            if (file.fail()) {
+                err << "Failed to open '" << args[1] << "'!";
+                throwCommandException(err);
+            }
+            loadImages(m, file);
+        }
+    } else {
+        err << "Invalid arguments for '" << getName() << "'!";
+        throwInvalidUsageException(err);
+    }
+}
+
+/****************************************************************************/
+
+void CommandSiiCache::listImages(MasterDevice &m)
+{
+    ec_ioctl_master_t master;
+    ec_ioctl_sii_image_t data;
+    unsigned int i;
+
+    m.getMaster(&master);
+
+    for (i = 0; i < master.sii_cache_count; i++) {
+        data.words = NULL;
+        data.nwords = 0;
+        m.getSiiImage(&data, i);
+
+        cout << setfill(' ') << dec << setw(3) << i << "  "
+            << hex << setfill('0')
+            << "0x" << setw(8) << data.vendor_id
+            << ":0x" << setw(8) << data.product_code
+            << "  Revision 0x" << setw(8) << data.revision_number
+            << "  Serial 0x" << setw(8) << data.serial_number
+            << dec << "  " << data.nwords << " words" << endl;
+    }
+}
+
+/****************************************************************************/
+
+void CommandSiiCache::saveImages(MasterDevice &m, ostream &out)
+{
+    ec_ioctl_master_t master;
+    ec_ioctl_sii_image_t data;
+    vector<uint16_t> words(EC_MAX_SII_SIZE);
+    uint32_t size;
+    unsigned int i;
+
+    m.getMaster(&master);
+
+    out.write(SII_CACHE_MAGIC, sizeof(SII_CACHE_MAGIC) - 1);
+
+    for (i = 0; i < master.sii_cache_count; i++) {
+        data.words = &words.front();
+        data.nwords = words.size();
+        m.getSiiImage(&data, i);
+
+        size = cpu_to_le32(data.nwords);
+        out.write((const char *) &size, sizeof(size));
+        out.write((const char *) data.words, data.nwords * 2);
+    }
+
+    if (out.fail()) {
+        stringstream err;
+        err << "Failed to write SII images!";
+        throwCommandException(err);
+    }
+
+    if (getVerbosity() == Verbose) {
+        cerr << "Saved " << master.sii_cache_count << " SII images."
+            << endl;
+    }
+}
+
+/****************************************************************************/
+
+void CommandSiiCache::loadImages(MasterDevice &m, const istream &in)
+{
+    stringstream err;
+    ostringstream tmp;
+    ec_ioctl_sii_image_t data;
+    vector<uint16_t> words;
+    size_t offset, magicSize = sizeof(SII_CACHE_MAGIC) - 1;
+    unsigned int count = 0;
+    uint32_t nwords;
+
+    tmp << in.rdbuf();
+    string const &contents = tmp.str();
+
+    if (contents.compare(0, magicSize, SII_CACHE_MAGIC)) {
+        err << "File does not contain SII images!";
+        throwCommandException(err);
+    }
+
+    for (offset = magicSize; offset < contents.size();
+            offset += sizeof(nwords) + nwords * 2) {
+        if (offset + sizeof(nwords) > contents.size()) {
+            err << "SII image size missing at offset " << offset << "!";
+            throwCommandException(err);
+        }
+        contents.copy((char *) &nwords, sizeof(nwords), offset);
+        nwords = le32_to_cpu(nwords);
+
+        if (!nwords || nwords > EC_MAX_SII_SIZE
+                || offset + sizeof(nwords) + nwords * 2 > contents.size()) {
+            err << "Invalid SII image at offset " << offset << "!";
+            throwCommandException(err);
+        }
+
+        words.resize(nwords);
+        contents.copy((char *) &words.front(), nwords * 2,
+                offset + sizeof(nwords));
+
+        data.words = &words.front();
+        data.nwords = nwords;
+        m.addSiiImage(&data);
+        count++;
+    }
+
+    if (getVerbosity() == Verbose) {
+        cerr << "Loaded " << count << " SII images." << endl;
+    }
+}
+
+/*****************************************************************************/
@@ -49,6 +49,7 @@ string CommandUpload::helpString(const string &binaryBaseName) const
 
     str << binaryBaseName << " " << getName()
         << " [OPTIONS] <INDEX> <SUBINDEX>" << endl
+        << " [OPTIONS] <INDEX>" << endl
         << endl
         << getBriefDescription() << endl
         << endl
@@ -60,6 +61,11 @@ string CommandUpload::helpString(const string &binaryBaseName) const
         << "information service or the SDO is not in the dictionary," << endl
         << "the --type option is mandatory."  << endl
         << endl
+        << "The second call (without <SUBINDEX>) uses the complete" << endl
+        << "access method and reads the whole SDO in one transfer," << endl
+        << "starting with subindex 0. The data are output as raw" << endl
+        << "data, unless the --type option is given." << endl
+        << endl
         << typeInfo()
         << endl
         << "Arguments:" << endl
@@ -84,15 +90,15 @@ string CommandUpload::helpString(const string &binaryBaseName) const
 void CommandUpload::execute(const StringVector &args)
 {
     SlaveList slaves;
-    stringstream err, strIndex, strSubIndex;
+    stringstream err, strIndex;
     ec_ioctl_slave_sdo_upload_t data;
     const DataType *dataType = NULL;
-    unsigned int uval;
 
-    if (args.size() != 2) {
-        err << "'" << getName() << "' takes two arguments!";
+    if (args.size() != 1 && args.size() != 2) {
+        err << "'" << getName() << "' takes 1 or 2 arguments!";
         throwInvalidUsageException(err);
     }
+    data.complete_access = args.size() == 1;
 
     strIndex << args[0];
     strIndex
@@ -103,15 +109,22 @@ void CommandUpload::execute(const StringVector &args)
         throwInvalidUsageException(err);
     }
 
-    strSubIndex << args[1];
-    strSubIndex
-        >> resetiosflags(ios::basefield) // guess base from prefix
-        >> uval;
-    if (strSubIndex.fail() || uval > 0xff) {
-        err << "Invalid SDO subindex '" << args[1] << "'!";
-        throwInvalidUsageException(err);
+    if (data.complete_access) {
+        data.sdo_entry_subindex = 0;
+    } else {
+        stringstream strSubIndex;
+        unsigned int uval;
+
+        strSubIndex << args[1];
+        strSubIndex
+            >> resetiosflags(ios::basefield) // guess base from prefix
+            >> uval;
+        if (strSubIndex.fail() || uval > 0xff) {
+            err << "Invalid SDO subindex '" << args[1] << "'!";
+            throwInvalidUsageException(err);
+        }
+        data.sdo_entry_subindex = uval;
     }
-    data.sdo_entry_subindex = uval;
 
     MasterDevice m(getSingleMasterIndex());
     m.open(MasterDevice::Read);
@@ -126,6 +139,8 @@ void CommandUpload::execute(const StringVector &args)
             err << "Invalid data type '" << getDataType() << "'!";
             throwInvalidUsageException(err);
         }
+    } else if (data.complete_access) { // whole SDO: output raw data
+        dataType = findDataType("raw");
     } else { // no data type specified: fetch from dictionary
         ec_ioctl_slave_sdo_entry_t entry;
 
@@ -145,7 +160,7 @@ void CommandUpload::execute(const StringVector &args)
         }
     }
 
-    if (dataType->byteSize) {
+    if (dataType->byteSize && !data.complete_access) {
         data.target_size = dataType->byteSize;
     } else {
         data.target_size = DefaultBufferSize;
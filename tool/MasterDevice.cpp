@@ -410,6 +410,86 @@ void MasterDevice::writeSii(
 
 /****************************************************************************/
 
+void MasterDevice::getSiiImage(
+        ec_ioctl_sii_image_t *data,
+        unsigned int index
+        )
+{
+    data->index = index;
+
+    if (ioctl(fd, EC_IOCTL_SII_CACHE, data) < 0) {
+        stringstream err;
+        err << "Failed to get cached SII image: " << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
+void MasterDevice::addSiiImage(
+        ec_ioctl_sii_image_t *data
+        )
+{
+    if (ioctl(fd, EC_IOCTL_SII_CACHE_ADD, data) < 0) {
+        stringstream err;
+        err << "Failed to add SII image to cache: " << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
+void MasterDevice::clearSiiCache()
+{
+    if (ioctl(fd, EC_IOCTL_SII_CACHE_CLEAR, 0) < 0) {
+        stringstream err;
+        err << "Failed to clear SII cache: " << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
+void MasterDevice::getDict(
+        ec_ioctl_dict_t *data,
+        unsigned int index
+        )
+{
+    data->index = index;
+
+    if (ioctl(fd, EC_IOCTL_DICT_CACHE, data) < 0) {
+        stringstream err;
+        err << "Failed to get cached SDO dictionary: " << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
+void MasterDevice::addDict(
+        ec_ioctl_dict_t *data
+        )
+{
+    if (ioctl(fd, EC_IOCTL_DICT_CACHE_ADD, data) < 0) {
+        stringstream err;
+        err << "Failed to add SDO dictionary to cache: " << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
+void MasterDevice::clearDictCache()
+{
+    if (ioctl(fd, EC_IOCTL_DICT_CACHE_CLEAR, 0) < 0) {
+        stringstream err;
+        err << "Failed to clear SDO dictionary cache: " << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
 void MasterDevice::readReg(
         ec_ioctl_slave_reg_t *data
         )
@@ -484,6 +564,17 @@ void MasterDevice::rescan()
 
 /****************************************************************************/
 
+void MasterDevice::resetLatency()
+{
+    if (ioctl(fd, EC_IOCTL_RESET_LATENCY, 0) < 0) {
+        stringstream err;
+        err << "Failed to reset latency statistics: " << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
 void MasterDevice::sdoDownload(ec_ioctl_slave_sdo_download_t *data)
 {
     if (ioctl(fd, EC_IOCTL_SLAVE_SDO_DOWNLOAD, data) < 0) {
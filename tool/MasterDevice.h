@@ -147,10 +147,17 @@ class MasterDevice
         void getSdoEntry(ec_ioctl_slave_sdo_entry_t *, uint16_t, int, uint8_t);
         void readSii(ec_ioctl_slave_sii_t *);
         void writeSii(ec_ioctl_slave_sii_t *);
+        void getSiiImage(ec_ioctl_sii_image_t *, unsigned int);
+        void addSiiImage(ec_ioctl_sii_image_t *);
+        void clearSiiCache();
+        void getDict(ec_ioctl_dict_t *, unsigned int);
+        void addDict(ec_ioctl_dict_t *);
+        void clearDictCache();
         void readReg(ec_ioctl_slave_reg_t *);
         void writeReg(ec_ioctl_slave_reg_t *);
         void setDebug(unsigned int);
         void rescan();
+        void resetLatency();
         void sdoDownload(ec_ioctl_slave_sdo_download_t *);
         void sdoUpload(ec_ioctl_slave_sdo_upload_t *);
         void requestState(uint16_t, uint8_t);
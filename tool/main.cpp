@@ -49,12 +49,15 @@ using namespace std;
 #include "CommandFoeWrite.h"
 #include "CommandGraph.h"
 #include "CommandIp.h"
+#include "CommandLatency.h"
 #include "CommandMaster.h"
 #include "CommandPdos.h"
 #include "CommandRegRead.h"
 #include "CommandRegWrite.h"
 #include "CommandRescan.h"
+#include "CommandSdoCache.h"
 #include "CommandSdos.h"
+#include "CommandSiiCache.h"
 #include "CommandSiiRead.h"
 #include "CommandSiiWrite.h"
 #include "CommandSlaves.h"
@@ -290,12 +293,15 @@ int main(int argc, char **argv)
     commandList.push_back(new CommandFoeWrite());
     commandList.push_back(new CommandGraph());
     commandList.push_back(new CommandIp());
+    commandList.push_back(new CommandLatency());
     commandList.push_back(new CommandMaster());
     commandList.push_back(new CommandPdos());
     commandList.push_back(new CommandRegRead());
     commandList.push_back(new CommandRegWrite());
     commandList.push_back(new CommandRescan());
+    commandList.push_back(new CommandSdoCache());
     commandList.push_back(new CommandSdos());
+    commandList.push_back(new CommandSiiCache());
     commandList.push_back(new CommandSiiRead());
     commandList.push_back(new CommandSiiWrite());
     commandList.push_back(new CommandSlaves());